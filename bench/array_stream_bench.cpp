@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "bench.h"
+#include "fbjson/array_stream.h"
+#include "flatbuffers/util.h"
+#include "synthetic.h"
+
+// Bulk export: a root array of `fbt.tStrInt` records, 256 MiB by default
+// (`FBJSON_BENCH_ARRAY_MB` overrides the size). Each variant converts the
+// file once and reports the time to the first record and the growth of the
+// resident set, sampled every 4096 records:
+// - push: `ArrayStreamParser` fed with 64 KiB chunks;
+// - generator: `ParseArrayElements` coroutine over the same reader;
+// - whole_file: the file is loaded into memory, then split the same way.
+
+namespace {
+
+const size_t kChunkSize = 64 * 1024;
+
+struct ExportFile {
+  std::string path;
+  size_t bytes = 0;
+  size_t records = 0;
+};
+
+const ExportFile &BulkExport() {
+  static const ExportFile file = [] {
+    const char *env = std::getenv("FBJSON_BENCH_ARRAY_MB");
+    const size_t target = (env ? std::max(1, std::atoi(env)) : 256) *
+                          size_t(1024 * 1024);
+    ExportFile f;
+    f.path = flatbuffers::ConCatPathFileName(bench::ScratchDir(),
+                                             "bulk_export.json");
+    auto out = std::fopen(f.path.c_str(), "wb");
+    if (!out) return f;
+    std::string block = "[\n";
+    while (f.bytes + block.size() < target) {
+      for (size_t i = 0; i < 4096; i++, f.records++) {
+        block += (f.records ? ",\n" : "") + bench::RecordJson(f.records);
+      }
+      f.bytes += std::fwrite(block.data(), 1, block.size(), out);
+      block.clear();
+    }
+    block += "\n]\n";
+    f.bytes += std::fwrite(block.data(), 1, block.size(), out);
+    std::fclose(out);
+    return f;
+  }();
+  return file;
+}
+
+// Time and resident memory of one conversion of the export.
+class Measurement {
+ public:
+  explicit Measurement(bench::State &state)
+      : state_(state), base_rss_(bench::ResidentBytes()) {}
+
+  void OnRecord(size_t size) {
+    if (!records_++) first_record_ = bench::SecondsSince(start_);
+    if (records_ % 4096 == 0) Sample();
+    output_bytes_ += size;
+  }
+
+  void Report(const std::string &label, const ExportFile &file) {
+    Sample();
+    bench::Sample sample;
+    sample.name = label;
+    sample.iterations = 1;
+    sample.seconds = bench::SecondsSince(start_);
+    sample.bytes = static_cast<double>(file.bytes);
+    sample.items = static_cast<double>(records_);
+    sample.counters.emplace_back("first_record_ms", first_record_ * 1e3);
+    sample.counters.emplace_back("output_mb",
+                                 output_bytes_ / (1024.0 * 1024.0));
+    sample.counters.emplace_back("rss_growth_mb", max_growth_ / (1024 * 1024));
+    sample.counters.emplace_back("peak_rss_mb", bench::PeakResidentBytes() /
+                                                    (1024.0 * 1024.0));
+    state_.Report(std::move(sample));
+  }
+
+  size_t records() const { return records_; }
+
+ private:
+  void Sample() {
+    const auto growth = static_cast<double>(bench::ResidentBytes()) -
+                        static_cast<double>(base_rss_);
+    max_growth_ = std::max(max_growth_, growth);
+  }
+
+  bench::State &state_;
+  const size_t base_rss_;
+  const bench::Clock::time_point start_ = bench::Clock::now();
+  size_t records_ = 0;
+  size_t output_bytes_ = 0;
+  double first_record_ = 0;
+  double max_growth_ = 0;
+};
+
+bool Push(flatbuffers::Parser *parser, const fbjson::ChunkReader &read,
+          Measurement *m) {
+  fbjson::ArrayStreamParser stream(parser);
+  std::vector<char> chunk(kChunkSize);
+  for (;;) {
+    const auto size = read(chunk.data(), chunk.size());
+    if (!size) {
+      return stream.Finish() == fbjson::ArrayStreamParser::Status::kDone;
+    }
+    for (size_t pos = 0; pos < size;) {
+      size_t consumed = 0;
+      const auto status = stream.Feed(chunk.data() + pos, size - pos,
+                                      &consumed);
+      pos += consumed;
+      if (status == fbjson::ArrayStreamParser::Status::kElement) {
+        m->OnRecord(parser->builder_.GetSize());
+      } else if (status == fbjson::ArrayStreamParser::Status::kDone) {
+        return true;
+      } else if (status == fbjson::ArrayStreamParser::Status::kError) {
+        return false;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+static void ArrayStreamBulkExport(bench::State &state) {
+  auto parser = bench::TestSchemaParser("fbt.tStrInt");
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  const auto &file = BulkExport();
+  if (!file.records) return state.SkipWithError("can't write " + file.path);
+
+  {
+    auto in = std::fopen(file.path.c_str(), "rb");
+    Measurement m(state);
+    const auto ok = in && Push(parser.get(), fbjson::FileChunkReader(in), &m);
+    if (in) std::fclose(in);
+    if (!ok || m.records() != file.records) {
+      return state.SkipWithError("push: " + file.path);
+    }
+    m.Report("push", file);
+  }
+#ifdef FBJSON_HAS_COROUTINES
+  {
+    auto in = std::fopen(file.path.c_str(), "rb");
+    if (!in) return state.SkipWithError("can't open " + file.path);
+    Measurement m(state);
+    std::string error;
+    for (const auto &buf : fbjson::ParseArrayElements(
+             parser.get(), fbjson::FileChunkReader(in), &error, kChunkSize)) {
+      m.OnRecord(buf.size());
+    }
+    std::fclose(in);
+    if (!error.empty() || m.records() != file.records) {
+      return state.SkipWithError("generator: " + error);
+    }
+    m.Report("generator", file);
+  }
+#endif
+  {
+    Measurement m(state);
+    std::string json;
+    size_t pos = 0;
+    const auto ok =
+        flatbuffers::LoadFile(file.path.c_str(), false, &json) &&
+        Push(parser.get(),
+             [&](char *buf, size_t size) {
+               const auto n = std::min(size, json.size() - pos);
+               std::copy(json.data() + pos, json.data() + pos + n, buf);
+               pos += n;
+               return n;
+             },
+             &m);
+    if (!ok || m.records() != file.records) {
+      return state.SkipWithError("whole_file: " + file.path);
+    }
+    m.Report("whole_file", file);
+  }
+}
+BENCHMARK(ArrayStreamBulkExport);
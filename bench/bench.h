@@ -0,0 +1,110 @@
+#ifndef FLATBUFFERS_TESTS_BENCH_H_
+#define FLATBUFFERS_TESTS_BENCH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "flatbuffers/idl.h"
+
+// Minimal benchmark harness for `flatbuffers_bench`.
+// Every benchmark is a function registered with `BENCHMARK(fn)`. The function
+// receives a `bench::State` and reports one or more samples through it.
+// Use global defines `FLATBUFFERS_FBS_DIR` and `JSON_SAMPLES_DIR` to reference
+// schema and dataset files.
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+static inline double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Prevent the compiler from optimizing away a computed value.
+template<typename T> static inline void DoNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+// Result of one measurement.
+struct Sample {
+  std::string name;
+  size_t iterations = 0;
+  double seconds = 0;
+  // Totals over all iterations, zero if not applicable.
+  double bytes = 0;
+  double items = 0;
+  double allocations = 0;
+  // Relative standard deviation of the time per iteration across batches.
+  double rel_stddev = 0;
+  // Additional named values (memory, counts, ratios).
+  std::vector<std::pair<std::string, double>> counters;
+};
+
+class State {
+ public:
+  State(std::string name, double min_time)
+      : name_(std::move(name)), min_time_(min_time) {}
+
+  // Call `fn` repeatedly until `min_time` seconds have passed and report a
+  // sample named `<benchmark>/<label>`. Each call processes `bytes` bytes
+  // and `items` items. The time is split into batches to estimate noise.
+  Sample &Run(const std::string &label, const std::function<void()> &fn,
+              size_t bytes = 0, size_t items = 1);
+
+  // Report a sample measured by the caller, the name is prefixed by the
+  // name of benchmark.
+  Sample &Report(Sample sample);
+
+  // Stop the benchmark with an error message.
+  void SkipWithError(const std::string &message);
+
+  const std::string &name() const { return name_; }
+  double min_time() const { return min_time_; }
+  const std::vector<Sample> &samples() const { return samples_; }
+  bool error_occurred() const { return !error_.empty(); }
+  const std::string &error() const { return error_; }
+
+ private:
+  std::string name_;
+  double min_time_;
+  std::vector<Sample> samples_;
+  std::string error_;
+};
+
+using Function = void (*)(State &);
+
+bool Register(const char *name, Function fn);
+int RunAll(int argc, char **argv);
+
+// Heap allocations made by the process so far.
+size_t AllocationCount();
+
+// Resident set size of the process and its peak, 0 where unknown.
+size_t ResidentBytes();
+size_t PeakResidentBytes();
+
+// Load a file from `JSON_SAMPLES_DIR` (the name starts from '/').
+std::string LoadSample(const char *fname);
+// Load a file from `FLATBUFFERS_FBS_DIR`.
+std::string LoadSchema(const char *fname);
+// Parser with `test.fbs` loaded and the root type set, using the strict JSON
+// options of the tests. Returns nullptr on failure.
+std::unique_ptr<flatbuffers::Parser> TestSchemaParser(const char *root_type);
+// Directory for generated benchmark input, created on demand.
+std::string ScratchDir();
+
+}  // namespace bench
+
+#define BENCHMARK(fn) \
+  static const bool fn##_registered_ = ::bench::Register(#fn, fn)
+
+#endif  // FLATBUFFERS_TESTS_BENCH_H_
@@ -0,0 +1,324 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include "bench.h"
+#if defined(__linux__)
+#  include <sys/resource.h>
+#  include <unistd.h>
+#endif
+#include "fbjson/options.h"
+#include "flatbuffers/util.h"
+
+static std::atomic<size_t> allocation_count(0);
+
+// Count heap allocations, the array forms forward to these.
+void *operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (auto p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+namespace bench {
+
+namespace {
+
+const size_t kBatches = 5;
+
+struct Benchmark {
+  const char *name;
+  Function fn;
+};
+
+std::vector<Benchmark> &Benchmarks() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+void PrintSample(const Sample &s) {
+  const auto ns_per_op =
+      s.iterations ? s.seconds * 1e9 / static_cast<double>(s.iterations) : 0;
+  std::printf("%-56s %10zu %14.1f ns", s.name.c_str(), s.iterations,
+              ns_per_op);
+  if (s.bytes > 0 && s.seconds > 0) {
+    std::printf(" %10.2f MB/s", s.bytes / s.seconds / (1024 * 1024));
+  }
+  if (s.items > 0 && s.seconds > 0) {
+    std::printf(" %12.0f items/s", s.items / s.seconds);
+  }
+  if (s.allocations > 0 && s.iterations) {
+    std::printf(" allocs=%.1f", s.allocations / s.iterations);
+  }
+  if (s.rel_stddev > 0) std::printf(" +-%.1f%%", s.rel_stddev * 100);
+  for (const auto &c : s.counters) {
+    std::printf(" %s=%g", c.first.c_str(), c.second);
+  }
+  std::printf("\n");
+}
+
+std::string JsonString(const std::string &s) {
+  std::string out = "\"";
+  for (const auto c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+std::string JsonNumber(double v) {
+  if (!std::isfinite(v)) return "0";
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.17g", v);
+  return buf;
+}
+
+std::string CpuModel() {
+  std::string cpuinfo;
+  if (flatbuffers::LoadFile("/proc/cpuinfo", false, &cpuinfo)) {
+    const auto pos = cpuinfo.find("model name");
+    const auto colon = cpuinfo.find(':', pos);
+    if (pos != std::string::npos && colon != std::string::npos) {
+      const auto end = cpuinfo.find('\n', colon);
+      return cpuinfo.substr(colon + 2, end - colon - 2);
+    }
+  }
+  return "unknown";
+}
+
+// Results in the format of `bench/bench_results.fbs`.
+bool WriteJson(const char *path, double min_time,
+               const std::vector<Sample> &samples) {
+  char date[32];
+  const auto now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+#if defined(__clang__)
+  const std::string compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+  const std::string compiler = "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+  const std::string compiler = "msvc " + std::to_string(_MSC_VER);
+#else
+  const std::string compiler = "unknown";
+#endif
+#ifdef NDEBUG
+  const std::string build_type = "release";
+#else
+  const std::string build_type = "debug";
+#endif
+  std::string json = "{\n  \"host\": {";
+  json += "\"cpu\": " + JsonString(CpuModel());
+  json += ", \"cores\": " +
+          std::to_string(std::thread::hardware_concurrency());
+  json += ", \"compiler\": " + JsonString(compiler);
+  json += ", \"build_type\": " + JsonString(build_type);
+  json += ", \"flatbuffers_version\": " +
+          JsonString(std::to_string(FLATBUFFERS_VERSION_MAJOR) + "." +
+                     std::to_string(FLATBUFFERS_VERSION_MINOR) + "." +
+                     std::to_string(FLATBUFFERS_VERSION_REVISION));
+  json += "},\n  \"date\": " + JsonString(date);
+  json += ",\n  \"min_time\": " + JsonNumber(min_time);
+  json += ",\n  \"samples\": [";
+  for (size_t i = 0; i < samples.size(); i++) {
+    const auto &s = samples[i];
+    const auto n = s.iterations ? static_cast<double>(s.iterations) : 1;
+    json += i ? ",\n    {" : "\n    {";
+    json += "\"name\": " + JsonString(s.name);
+    json += ", \"iterations\": " + std::to_string(s.iterations);
+    json += ", \"seconds\": " + JsonNumber(s.seconds);
+    json += ", \"ns_per_iteration\": " + JsonNumber(s.seconds * 1e9 / n);
+    json += ", \"rel_stddev\": " + JsonNumber(s.rel_stddev);
+    if (s.seconds > 0) {
+      json += ", \"bytes_per_second\": " + JsonNumber(s.bytes / s.seconds);
+      json += ", \"items_per_second\": " + JsonNumber(s.items / s.seconds);
+    }
+    json += ", \"allocations_per_iteration\": " +
+            JsonNumber(s.allocations / n);
+    json += ", \"counters\": [";
+    for (size_t c = 0; c < s.counters.size(); c++) {
+      json += c ? ", {" : "{";
+      json += "\"name\": " + JsonString(s.counters[c].first);
+      json += ", \"value\": " + JsonNumber(s.counters[c].second) + "}";
+    }
+    json += "]}";
+  }
+  json += "\n  ]\n}\n";
+  return flatbuffers::SaveFile(path, json, false);
+}
+
+}  // namespace
+
+Sample &State::Run(const std::string &label, const std::function<void()> &fn,
+                   size_t bytes, size_t items) {
+  Sample sample;
+  sample.name = label;
+  // warm up caches and lazy initialization
+  fn();
+  const auto allocations = AllocationCount();
+  double sum = 0, sum_squares = 0;
+  for (size_t batch = 0; batch < kBatches; batch++) {
+    const auto start = Clock::now();
+    size_t iterations = 0;
+    double seconds = 0;
+    do {
+      fn();
+      iterations++;
+      seconds = SecondsSince(start);
+    } while (seconds < min_time_ / kBatches);
+    sample.iterations += iterations;
+    sample.seconds += seconds;
+    const auto per_iteration = seconds / static_cast<double>(iterations);
+    sum += per_iteration;
+    sum_squares += per_iteration * per_iteration;
+  }
+  sample.allocations = static_cast<double>(AllocationCount() - allocations);
+  const auto mean = sum / kBatches;
+  const auto variance = sum_squares / kBatches - mean * mean;
+  sample.rel_stddev = mean > 0 ? std::sqrt(std::max(variance, 0.0)) / mean
+                               : 0;
+  sample.bytes = static_cast<double>(bytes) * sample.iterations;
+  sample.items = static_cast<double>(items) * sample.iterations;
+  return Report(std::move(sample));
+}
+
+Sample &State::Report(Sample sample) {
+  sample.name = name_ + (sample.name.empty() ? "" : "/") + sample.name;
+  samples_.push_back(std::move(sample));
+  PrintSample(samples_.back());
+  return samples_.back();
+}
+
+void State::SkipWithError(const std::string &message) {
+  error_ = message;
+  std::printf("%-56s ERROR: %s\n", name_.c_str(), message.c_str());
+}
+
+bool Register(const char *name, Function fn) {
+  Benchmarks().push_back({ name, fn });
+  return true;
+}
+
+size_t AllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+int RunAll(int argc, char **argv) {
+  double min_time = 0.5;
+  const char *filter = nullptr;
+  const char *json = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!std::strncmp(argv[i], "--min_time=", 11)) {
+      min_time = std::atof(argv[i] + 11);
+    } else if (!std::strncmp(argv[i], "--filter=", 9)) {
+      filter = argv[i] + 9;
+    } else if (!std::strncmp(argv[i], "--json=", 7)) {
+      json = argv[i] + 7;
+    } else {
+      std::fprintf(stderr,
+                   "usage: %s [--filter=substring] [--min_time=seconds] "
+                   "[--json=file]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+  auto failed = 0;
+  std::vector<Sample> samples;
+  for (const auto &b : Benchmarks()) {
+    if (filter && !std::strstr(b.name, filter)) continue;
+    State state(b.name, min_time);
+    b.fn(state);
+    if (state.error_occurred()) failed++;
+    samples.insert(samples.end(), state.samples().begin(),
+                   state.samples().end());
+  }
+  if (json && !WriteJson(json, min_time, samples)) {
+    std::fprintf(stderr, "can't write %s\n", json);
+    return 1;
+  }
+  return failed ? 1 : 0;
+}
+
+size_t ResidentBytes() {
+#if defined(__linux__)
+  std::string statm;
+  if (flatbuffers::LoadFile("/proc/self/statm", false, &statm)) {
+    // size resident shared ... (in pages)
+    const auto resident = std::strtoull(
+        statm.c_str() + statm.find(' '), nullptr, 10);
+    return static_cast<size_t>(resident * sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+size_t PeakResidentBytes() {
+#if defined(__linux__)
+  rusage usage;
+  if (!getrusage(RUSAGE_SELF, &usage)) {
+    // kilobytes on Linux
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+  }
+#endif
+  return 0;
+}
+
+std::string LoadSample(const char *fname) {
+  std::string content;
+  const auto full_fname =
+      flatbuffers::ConCatPathFileName(JSON_SAMPLES_DIR, fname);
+  if (!flatbuffers::LoadFile(full_fname.c_str(), false, &content)) {
+    throw std::runtime_error("can't load " + full_fname);
+  }
+  return content;
+}
+
+std::string LoadSchema(const char *fname) {
+  std::string content;
+  const auto full_fname =
+      flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, fname);
+  if (!flatbuffers::LoadFile(full_fname.c_str(), false, &content)) {
+    throw std::runtime_error("can't load " + full_fname);
+  }
+  return content;
+}
+
+std::unique_ptr<flatbuffers::Parser> TestSchemaParser(const char *root_type) {
+  std::unique_ptr<flatbuffers::Parser> parser(
+      new flatbuffers::Parser(fbjson::StrictJsonOptions()));
+  static const char *include_dirs[] = { FLATBUFFERS_FBS_DIR, nullptr };
+  const auto schema = LoadSchema("test.fbs");
+  if (!parser->Parse(schema.c_str(), include_dirs) ||
+      !parser->SetRootType(root_type)) {
+    return nullptr;
+  }
+  return parser;
+}
+
+std::string ScratchDir() {
+  namespace fs = std::filesystem;
+  static const std::string dir = [] {
+    const auto path = fs::temp_directory_path() / "flatbuffers_bench";
+    fs::create_directories(path);
+    return path.string();
+  }();
+  return dir;
+}
+
+}  // namespace bench
+
+int main(int argc, char **argv) { return bench::RunAll(argc, argv); }
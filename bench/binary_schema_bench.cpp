@@ -0,0 +1,84 @@
+#include <cstdlib>
+#include "bench.h"
+#include "fbjson/binary_schema.h"
+#include "fbjson/options.h"
+#include "synthetic.h"
+
+// Startup and steady-state parse speed of parsers with type definitions
+// loaded from the text schema or from the binary schema.
+
+namespace {
+
+struct SchemaCase {
+  std::string name;
+  std::string text;
+  std::string bfbs;
+  std::string json;
+};
+
+std::vector<SchemaCase> SchemaCases() {
+  std::vector<SchemaCase> cases;
+  cases.push_back({ "test.fbs",
+                    bench::LoadSchema("test.fbs") + "root_type fbt.tStrIntInt;",
+                    "", R"({"f1": "test", "f2": 1, "f3": 2})" });
+  for (size_t tables : { 100, 1000 }) {
+    cases.push_back({ "synthetic_" + std::to_string(tables),
+                      bench::SyntheticSchema("syn", tables, 16), "",
+                      bench::SyntheticJson(16) });
+  }
+  for (auto &c : cases) {
+    flatbuffers::Parser parser;
+    if (!parser.Parse(c.text.c_str())) std::abort();
+    parser.Serialize();
+    c.bfbs.assign(
+        reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+        parser.builder_.GetSize());
+  }
+  return cases;
+}
+
+}  // namespace
+
+static void BinarySchemaStartup(bench::State &state) {
+  for (const auto &c : SchemaCases()) {
+    state.Run("text/" + c.name, [&] {
+      flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+      if (!parser.Parse(c.text.c_str())) std::abort();
+    });
+    state.Run("binary/" + c.name, [&] {
+      flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+      std::string error;
+      if (!fbjson::LoadBinarySchema(
+              reinterpret_cast<const uint8_t *>(c.bfbs.data()), c.bfbs.size(),
+              &parser, &error)) {
+        std::abort();
+      }
+    });
+  }
+}
+BENCHMARK(BinarySchemaStartup);
+
+static void BinarySchemaParse(bench::State &state) {
+  for (const auto &c : SchemaCases()) {
+    flatbuffers::Parser text_parser(fbjson::StrictJsonOptions());
+    flatbuffers::Parser binary_parser(fbjson::StrictJsonOptions());
+    std::string error;
+    if (!text_parser.Parse(c.text.c_str()) ||
+        !fbjson::LoadBinarySchema(
+            reinterpret_cast<const uint8_t *>(c.bfbs.data()), c.bfbs.size(),
+            &binary_parser, &error)) {
+      return state.SkipWithError("can't load schema " + c.name);
+    }
+    state.Run("text/" + c.name,
+              [&] {
+                if (!text_parser.Parse(c.json.c_str())) std::abort();
+              },
+              c.json.size());
+    state.Run("binary/" + c.name,
+              [&] {
+                if (!binary_parser.Parse(c.json.c_str())) std::abort();
+              },
+              c.json.size());
+  }
+}
+BENCHMARK(BinarySchemaParse);
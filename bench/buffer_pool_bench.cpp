@@ -0,0 +1,105 @@
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "bench.h"
+#include "fbjson/buffer_pool.h"
+#include "test_generated.h"
+
+// Sustained conversion: a producer parses `fbt.tIntVInt` documents and
+// hands released buffers to a consumer which reads and drops them. Buffers
+// come from the heap, from `BufferPool` or from its huge-page slabs.
+
+namespace {
+
+class BufferQueue {
+ public:
+  explicit BufferQueue(size_t capacity) : capacity_(capacity) {}
+
+  void Push(flatbuffers::DetachedBuffer buf) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [&] { return queue_.size() < capacity_; });
+    queue_.push_back(std::move(buf));
+    not_empty_.notify_one();
+  }
+
+  // An empty buffer marks the end.
+  flatbuffers::DetachedBuffer Pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [&] { return !queue_.empty(); });
+    auto buf = std::move(queue_.front());
+    queue_.pop_front();
+    not_full_.notify_one();
+    return buf;
+  }
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_full_, not_empty_;
+  std::deque<flatbuffers::DetachedBuffer> queue_;
+};
+
+std::string IntVectorJson(size_t count, size_t seed) {
+  std::string json = R"({"f1": )" + std::to_string(seed) + R"(, "f2": [)";
+  for (size_t i = 0; i < count; i++) {
+    if (i) json += ", ";
+    json += std::to_string((i + seed) * 7919 % 100003);
+  }
+  return json + "]}";
+}
+
+}  // namespace
+
+static void BufferPoolProducerConsumer(bench::State &state) {
+  auto parser = bench::TestSchemaParser("fbt.tIntVInt");
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  // documents from 1 KiB to 1 MiB of output
+  std::vector<std::string> docs;
+  size_t bytes = 0;
+  for (size_t i = 0; i < 32; i++) {
+    docs.push_back(IntVectorJson(size_t(256) << (i % 9), i));
+    bytes += docs.back().size();
+  }
+  for (const char *mode : { "heap", "pool", "pool_huge_pages" }) {
+    const std::string name = mode;
+    fbjson::BufferPoolOptions opts;
+    opts.huge_pages = name == "pool_huge_pages";
+    fbjson::BufferPool pool(opts);
+    const auto allocator = name == "heap" ? nullptr : &pool;
+    BufferQueue queue(16);
+    int64_t checksum = 0;
+    const auto rss_before = static_cast<double>(bench::ResidentBytes());
+    auto &sample = state.Run(
+        name,
+        [&] {
+          std::thread consumer([&] {
+            for (;;) {
+              const auto buf = queue.Pop();
+              if (!buf.size()) break;
+              const auto root = flatbuffers::GetRoot<fbt::tIntVInt>(buf.data());
+              checksum += root->f1() + (root->f2() ? root->f2()->size() : 0);
+            }
+          });
+          for (const auto &doc : docs) {
+            parser->builder_ = flatbuffers::FlatBufferBuilder(1024, allocator);
+            if (!parser->Parse(doc.c_str())) std::abort();
+            queue.Push(parser->builder_.Release());
+          }
+          queue.Push(flatbuffers::DetachedBuffer());
+          consumer.join();
+        },
+        bytes, docs.size());
+    bench::DoNotOptimize(checksum);
+    const auto stats = pool.stats();
+    sample.counters.emplace_back("rss_growth_bytes",
+                                 bench::ResidentBytes() - rss_before);
+    sample.counters.emplace_back("peak_rss_bytes", bench::PeakResidentBytes());
+    sample.counters.emplace_back("pool_hits", stats.hits);
+    sample.counters.emplace_back("pool_misses", stats.misses);
+    sample.counters.emplace_back("mapped_bytes", stats.mapped_bytes);
+    parser->builder_ = flatbuffers::FlatBufferBuilder();
+  }
+}
+BENCHMARK(BufferPoolProducerConsumer);
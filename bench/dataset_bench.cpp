@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include "bench.h"
+#include "flatbuffers/util.h"
+#include "test_generated.h"
+
+// Parse, text generation and verification of every dataset file the parser
+// accepts with a document, one sample per file. The root type `fbt.tEmpty`
+// accepts any object.
+
+namespace {
+
+struct DatasetCase {
+  std::string name;
+  std::string json;
+};
+
+std::vector<DatasetCase> DatasetCases(flatbuffers::Parser *parser) {
+  namespace fs = std::filesystem;
+  std::vector<DatasetCase> cases;
+  for (const char *dir : { "json.org", "nst.JSONTestSuite" }) {
+    std::vector<fs::path> files;
+    for (const auto &entry :
+         fs::directory_iterator(fs::path(JSON_SAMPLES_DIR) / dir)) {
+      if (entry.path().extension() == ".json") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto &path : files) {
+      std::string json;
+      // empty or whitespace-only files are accepted without a buffer
+      if (!flatbuffers::LoadFile(path.string().c_str(), false, &json) ||
+          !parser->Parse(json.c_str()) || !parser->builder_.GetSize()) {
+        continue;
+      }
+      cases.push_back({ std::string(dir) + "/" + path.filename().string(),
+                        std::move(json) });
+    }
+  }
+  return cases;
+}
+
+}  // namespace
+
+static void DatasetParse(bench::State &state) {
+  auto parser = bench::TestSchemaParser("fbt.tEmpty");
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  for (const auto &c : DatasetCases(parser.get())) {
+    state.Run(c.name,
+              [&] {
+                if (!parser->Parse(c.json.c_str())) std::abort();
+              },
+              c.json.size());
+  }
+}
+BENCHMARK(DatasetParse);
+
+static void DatasetGenerateText(bench::State &state) {
+  auto parser = bench::TestSchemaParser("fbt.tEmpty");
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  for (const auto &c : DatasetCases(parser.get())) {
+    if (!parser->Parse(c.json.c_str())) std::abort();
+    std::string text;
+    state.Run(c.name, [&] {
+      text.clear();
+      if (!flatbuffers::GenerateText(
+              *parser, parser->builder_.GetBufferPointer(), &text)) {
+        std::abort();
+      }
+    });
+  }
+}
+BENCHMARK(DatasetGenerateText);
+
+static void DatasetVerify(bench::State &state) {
+  auto parser = bench::TestSchemaParser("fbt.tEmpty");
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  for (const auto &c : DatasetCases(parser.get())) {
+    if (!parser->Parse(c.json.c_str())) std::abort();
+    const auto buf = parser->builder_.GetBufferPointer();
+    const auto size = parser->builder_.GetSize();
+    state.Run(
+        c.name,
+        [&] {
+          flatbuffers::Verifier verifier(buf, size);
+          if (!verifier.VerifyBuffer<fbt::tEmpty>(nullptr)) std::abort();
+        },
+        size);
+  }
+}
+BENCHMARK(DatasetVerify);
@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <cstdlib>
+#include "bench.h"
+#include "fbjson/document_framer.h"
+
+// Chunked input: the document framer against buffering the whole input
+// before a single `Parse` call. Both buffer the complete document and parse
+// it in one call, so memory use and latency are the same; the difference is
+// the cost of scanning each chunk to find the end of the root value.
+
+namespace {
+
+// `fbt.tIntVInt` document with a vector of `count` integers.
+std::string IntVectorJson(size_t count) {
+  std::string json = R"({"f1": 1, "f2": [)";
+  for (size_t i = 0; i < count; i++) {
+    if (i) json += ", ";
+    json += std::to_string(i * 7919 % 100003);
+  }
+  return json + "]}";
+}
+
+}  // namespace
+
+static void DocumentFramerChunks(bench::State &state) {
+  auto parser = bench::TestSchemaParser("fbt.tIntVInt");
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  const auto json = IntVectorJson(100000);
+  for (size_t chunk : { 64, 4096, 65536 }) {
+    const auto suffix = "/chunk:" + std::to_string(chunk);
+    state.Run(
+        "buffered" + suffix,
+        [&] {
+          std::string buffer;
+          for (size_t pos = 0; pos < json.size(); pos += chunk) {
+            buffer.append(json, pos, chunk);
+          }
+          if (!parser->Parse(buffer.c_str())) std::abort();
+        },
+        json.size());
+    fbjson::DocumentFramer framer(parser.get());
+    state.Run(
+        "framer" + suffix,
+        [&] {
+          framer.Reset();
+          auto status = fbjson::DocumentFramer::Status::kNeedMoreData;
+          for (size_t pos = 0; pos < json.size(); pos += chunk) {
+            status = framer.Feed(json.data() + pos,
+                                 std::min(chunk, json.size() - pos));
+          }
+          if (status != fbjson::DocumentFramer::Status::kDone) {
+            std::abort();
+          }
+        },
+        json.size());
+  }
+}
+BENCHMARK(DocumentFramerChunks);
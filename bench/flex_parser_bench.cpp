@@ -0,0 +1,106 @@
+#include <cstdlib>
+#include <string>
+#include "bench.h"
+#include "fbjson/flex_parser.h"
+#include "fbjson/meta_parser.h"
+#include "fbjson/options.h"
+#include "records_meta_generated.h"
+
+// Throughput of the three ways to convert a document whose objects carry
+// attributes outside the schema (`records.TaggedList`, 8 MiB): the schema
+// path drops them, the schemaless path converts the whole document to a
+// FlexBuffer, and the hybrid path keeps them as a FlexBuffer map in
+// `Tagged.extra`. `flatbuffers::Parser` is the reference for both modes.
+
+namespace {
+
+// `Tagged` tables of records.fbs for `flatbuffers::Parser`.
+const char *const kTaggedSchema = R"(
+namespace records;
+table Tagged {
+  id : long; name : string; amount : double; extra : [ubyte] (flexbuffer);
+}
+table TaggedList { items : [Tagged]; }
+root_type TaggedList;
+)";
+
+const std::string &TaggedJson() {
+  static const std::string json = [] {
+    std::string s = "{\"items\": [";
+    for (size_t i = 0; s.size() < (size_t(8) << 20); i++) {
+      const auto v = std::to_string(i);
+      s += (i ? ",\n" : "\n");
+      s += "{\"id\": " + v + ", \"name\": \"item " + v + "\", \"amount\": " +
+           v + ".25, \"color\": \"c" + std::to_string(i % 7) +
+           "\", \"tags\": [\"a\", \"b" + v + "\"], \"score\": " +
+           std::to_string(i % 1000) + "e-3, \"geo\": {\"lat\": " + v +
+           ".5, \"lon\": -" + v + ".5}, \"active\": " +
+           (i % 2 ? "true" : "false") + "}";
+    }
+    return s + "\n]}\n";
+  }();
+  return json;
+}
+
+}  // namespace
+
+static void FlexParserModes(bench::State &state) {
+  const auto &json = TaggedJson();
+  const auto root = static_cast<int>(records::meta::TableIndex::TaggedList);
+  auto opts = fbjson::StrictJsonOptions();
+  opts.skip_unexpected_fields_in_json = true;
+  flatbuffers::Parser parser(opts);
+  if (!parser.Parse(kTaggedSchema)) return state.SkipWithError(parser.error_);
+
+  auto &reference = state.Run(
+      "schema/parser",
+      [&] {
+        if (!parser.Parse(json.c_str())) std::abort();
+      },
+      json.size());
+  reference.counters.emplace_back("output_bytes", parser.builder_.GetSize());
+
+  fbjson::MetaParser meta_parser(records::meta::kSchema);
+  auto &schema_path = state.Run(
+      "schema/meta",
+      [&] {
+        if (!meta_parser.Parse(json.c_str(), root)) std::abort();
+      },
+      json.size());
+  schema_path.counters.emplace_back("output_bytes",
+                                    meta_parser.builder_.GetSize());
+
+  fbjson::MetaParserOptions hybrid_opts;
+  hybrid_opts.keep_unknown_fields = true;
+  fbjson::MetaParser hybrid(records::meta::kSchema, hybrid_opts);
+  auto &hybrid_path = state.Run(
+      "hybrid/meta",
+      [&] {
+        if (!hybrid.Parse(json.c_str(), root)) std::abort();
+      },
+      json.size());
+  hybrid_path.counters.emplace_back("output_bytes", hybrid.builder_.GetSize());
+
+  flexbuffers::Builder flex_builder;
+  auto &flatc = state.Run(
+      "schemaless/parser",
+      [&] {
+        flex_builder.Clear();
+        if (!parser.ParseFlexBuffer(json.c_str(), nullptr, &flex_builder)) {
+          std::abort();
+        }
+      },
+      json.size());
+  flatc.counters.emplace_back("output_bytes", flex_builder.GetSize());
+
+  fbjson::FlexParser flex_parser;
+  auto &schemaless = state.Run(
+      "schemaless/flex",
+      [&] {
+        if (!flex_parser.Parse(json.c_str())) std::abort();
+      },
+      json.size());
+  schemaless.counters.emplace_back("output_bytes",
+                                   flex_parser.builder_.GetSize());
+}
+BENCHMARK(FlexParserModes);
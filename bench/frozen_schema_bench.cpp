@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.h"
+#include "fbjson/frozen_schema.h"
+#include "fbjson/meta_parser.h"
+#include "fbjson/options.h"
+#include "synthetic.h"
+
+// Schema metadata memory of `test.fbs` and of generated schemas with 1k and
+// 10k tables of 8 fields, with a doc comment on every table and field:
+// - parse: `flatbuffers::Parser` parsing the schema text, counters are the
+//   `MeasureSchema` breakdown of the parser;
+// - freeze: building a `FrozenSchema` of the parsed schema, `frozen_bytes`
+//   is its `MemoryUsage`;
+// - json/parser, json/frozen: a document of the root table with
+//   `flatbuffers::Parser` and with `MetaParser` on the frozen schema.
+
+namespace {
+
+// Doc comments before every table and field of a `SyntheticSchema`.
+std::string Documented(const std::string &schema) {
+  std::string documented;
+  for (size_t pos = 0; pos < schema.size();) {
+    auto end = schema.find('\n', pos);
+    end = end == std::string::npos ? schema.size() : end + 1;
+    if (!schema.compare(pos, 6, "table ")) {
+      documented += "/// Generated table, documented like real schemas are.\n";
+    } else if (!schema.compare(pos, 3, "  f")) {
+      documented += "  /// Generated field, with a line of documentation.\n";
+    }
+    documented.append(schema, pos, end - pos);
+    pos = end;
+  }
+  return documented;
+}
+
+}  // namespace
+
+static void FrozenSchemaMemory(bench::State &state) {
+  std::vector<std::pair<std::string, std::string>> schemas;
+  schemas.emplace_back("test", bench::LoadSchema("test.fbs"));
+  for (const size_t tables : { 1000, 10000 }) {
+    schemas.emplace_back(
+        std::to_string(tables / 1000) + "k",
+        Documented(bench::SyntheticSchema("bench.frozen", tables, 8)));
+  }
+  for (const auto &schema : schemas) {
+    const auto &label = schema.first;
+    std::unique_ptr<flatbuffers::Parser> parser;
+    auto &parse = state.Run(
+        label + "/parse",
+        [&] {
+          parser.reset(new flatbuffers::Parser(fbjson::StrictJsonOptions()));
+          if (!parser->Parse(schema.second.c_str())) std::abort();
+        },
+        schema.second.size());
+    const auto memory = fbjson::MeasureSchema(*parser);
+    parse.counters.emplace_back("parser_bytes", memory.total());
+    parse.counters.emplace_back("structs", memory.structs);
+    parse.counters.emplace_back("fields", memory.fields);
+    parse.counters.emplace_back("docs", memory.docs);
+    parse.counters.emplace_back("attributes", memory.attributes);
+    parse.counters.emplace_back("strings", memory.strings);
+    parse.counters.emplace_back("symbols", memory.symbols);
+
+    std::unique_ptr<fbjson::FrozenSchema> frozen;
+    auto &freeze = state.Run(label + "/freeze", [&] {
+      frozen.reset(new fbjson::FrozenSchema(*parser));
+    });
+    freeze.counters.emplace_back("frozen_bytes", frozen->MemoryUsage());
+    freeze.counters.emplace_back(
+        "ratio", static_cast<double>(memory.total()) / frozen->MemoryUsage());
+
+    // `test.fbs` has no root type
+    if (!parser->root_struct_def_) continue;
+    const auto json = bench::SyntheticJson(8);
+    state.Run(
+        label + "/json/parser",
+        [&] {
+          if (!parser->Parse(json.c_str())) std::abort();
+        },
+        json.size());
+    fbjson::MetaParser meta_parser(frozen->schema());
+    state.Run(
+        label + "/json/frozen",
+        [&] {
+          if (!meta_parser.Parse(json.c_str())) std::abort();
+        },
+        json.size());
+  }
+}
+BENCHMARK(FrozenSchemaMemory);
@@ -0,0 +1,132 @@
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "fbjson/include_cache.h"
+#include "fbjson/options.h"
+#include "flatbuffers/util.h"
+#include "synthetic.h"
+
+// Schema compilation of 64 worker schemas which share a tree of included
+// files. A tree has `depth` levels of `width` files of 16 tables with 8
+// fields; every file includes all files of the next level and its tables
+// reference a table there. The worker schemas include the first level and
+// declare their own root table:
+// - parse: `Parser::Parse`, which reads and parses the included files for
+//   every worker;
+// - cache/cold: `IncludeCache::Parse` on an empty cache, the first worker
+//   parses the includes;
+// - cache/mtime, cache/hash: `IncludeCache::Parse` on a warm cache, the
+//   included files are checked by modification time or by content hash.
+// Items are worker schemas.
+
+namespace {
+
+const size_t kWorkers = 64;
+const size_t kTables = 16;
+const size_t kFields = 8;
+
+std::string FileName(const std::string &tree, size_t level, size_t i) {
+  return "include_" + tree + "_" + flatbuffers::NumToString(level) + "_" +
+         flatbuffers::NumToString(i) + ".fbs";
+}
+
+std::string Namespace(size_t level, size_t i) {
+  return "bench.inc.l" + flatbuffers::NumToString(level) + ".f" +
+         flatbuffers::NumToString(i);
+}
+
+// Write the files of the tree and return the bytes written.
+size_t WriteTree(const std::string &tree, size_t depth, size_t width) {
+  size_t bytes = 0;
+  for (size_t level = 0; level < depth; level++) {
+    for (size_t i = 0; i < width; i++) {
+      std::string schema;
+      const bool leaf = level + 1 == depth;
+      for (size_t j = 0; !leaf && j < width; j++) {
+        schema += "include \"" + FileName(tree, level + 1, j) + "\";\n";
+      }
+      schema += bench::SyntheticSchema(Namespace(level, i), kTables, kFields);
+      if (!leaf) {
+        // the last table of the file references the next level
+        schema.insert(schema.rfind("}\n"),
+                      "  next : " + Namespace(level + 1, i) + ".T0;\n");
+      }
+      bytes += schema.size();
+      bench::WriteScratchFile(FileName(tree, level, i), schema);
+    }
+  }
+  return bytes;
+}
+
+std::vector<std::string> WorkerSchemas(const std::string &tree,
+                                       size_t width) {
+  std::string includes;
+  for (size_t i = 0; i < width; i++) {
+    includes += "include \"" + FileName(tree, 0, i) + "\";\n";
+  }
+  std::vector<std::string> schemas;
+  for (size_t w = 0; w < kWorkers; w++) {
+    schemas.push_back(includes + "namespace bench.worker" +
+                      flatbuffers::NumToString(w) +
+                      ";\ntable Root { shared : " + Namespace(0, 0) +
+                      ".T0; id : int; }\nroot_type Root;\n");
+  }
+  return schemas;
+}
+
+}  // namespace
+
+static void IncludeCacheCompile(bench::State &state) {
+  struct Tree {
+    const char *name;
+    size_t depth;
+    size_t width;
+  };
+  const auto scratch = bench::ScratchDir();
+  const char *include_paths[] = { scratch.c_str(), nullptr };
+  for (const auto &tree : { Tree{ "chain", 24, 1 }, Tree{ "diamond", 6, 4 } }) {
+    const std::string prefix = std::string(tree.name) + "/";
+    const auto bytes = WriteTree(tree.name, tree.depth, tree.width);
+    const auto workers = WorkerSchemas(tree.name, tree.width);
+
+    auto compile = [&](fbjson::IncludeCache *cache) {
+      for (const auto &schema : workers) {
+        flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+        const auto ok = cache ? cache->Parse(&parser, schema.c_str(),
+                                             include_paths)
+                              : parser.Parse(schema.c_str(), include_paths);
+        if (!ok || !parser.root_struct_def_) std::abort();
+      }
+    };
+    auto &parse = state.Run(
+        prefix + "parse", [&] { compile(nullptr); }, 0, kWorkers);
+    parse.counters.emplace_back("files", tree.depth * tree.width);
+    parse.counters.emplace_back("include_bytes", bytes);
+
+    fbjson::IncludeCache cold;
+    state.Run(
+        prefix + "cache/cold",
+        [&] {
+          cold.Clear();
+          compile(&cold);
+        },
+        0, kWorkers);
+
+    for (const auto validation :
+         { fbjson::IncludeCache::Validation::kModificationTime,
+           fbjson::IncludeCache::Validation::kContentHash }) {
+      fbjson::IncludeCache cache(validation);
+      compile(&cache);
+      auto &warm = state.Run(
+          prefix +
+              (validation == fbjson::IncludeCache::Validation::kContentHash
+                   ? "cache/hash"
+                   : "cache/mtime"),
+          [&] { compile(&cache); }, 0, kWorkers);
+      warm.counters.emplace_back("misses", cache.stats().misses);
+    }
+  }
+}
+BENCHMARK(IncludeCacheCompile);
@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include "bench.h"
+#include "fbjson/meta_parser.h"
+#include "fbjson/options.h"
+#include "test_meta_generated.h"
+
+// Startup cost and parse speed of `flatbuffers::Parser` against
+// `fbjson::MetaParser` driven by compile-time metadata of `test.fbs`.
+
+namespace {
+
+const char *const kDocument = R"({"f1": "test", "f2": 1, "f3": 2})";
+
+std::string IntVector(size_t count) {
+  std::string json = R"({"f1": 1, "f2": [)";
+  for (size_t i = 0; i < count; i++) {
+    if (i) json += ", ";
+    json += std::to_string(i * 7919 % 100000);
+  }
+  return json + "]}";
+}
+
+}  // namespace
+
+static void MetaParserStartup(bench::State &state) {
+  const auto schema = bench::LoadSchema("test.fbs");
+  state.Run("parser/test.fbs", [&] {
+    flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+    if (!parser.Parse(schema.c_str())) std::abort();
+  });
+  state.Run("meta/test.fbs", [&] {
+    fbjson::MetaParser parser(fbt::meta::kSchema);
+    bench::DoNotOptimize(parser);
+  });
+}
+BENCHMARK(MetaParserStartup);
+
+static void MetaParserParse(bench::State &state) {
+  const struct {
+    const char *name;
+    const char *root;
+    fbt::meta::TableIndex index;
+    std::string json;
+  } cases[] = {
+    { "tStrIntInt", "fbt.tStrIntInt", fbt::meta::TableIndex::tStrIntInt,
+      kDocument },
+    { "tIntVInt_100k", "fbt.tIntVInt", fbt::meta::TableIndex::tIntVInt,
+      IntVector(100000) },
+  };
+  for (const auto &c : cases) {
+    auto parser = bench::TestSchemaParser(c.root);
+    fbjson::MetaParser meta_parser(fbt::meta::kSchema);
+    if (!parser) return state.SkipWithError("can't load test.fbs");
+    state.Run("parser/" + std::string(c.name),
+              [&] {
+                if (!parser->Parse(c.json.c_str())) std::abort();
+              },
+              c.json.size());
+    state.Run("meta/" + std::string(c.name),
+              [&] {
+                if (!meta_parser.Parse(c.json.c_str(),
+                                       static_cast<int>(c.index))) {
+                  std::abort();
+                }
+              },
+              c.json.size());
+  }
+}
+BENCHMARK(MetaParserParse);
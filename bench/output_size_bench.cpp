@@ -0,0 +1,71 @@
+#include <cstdlib>
+#include "bench.h"
+#include "fbjson/output_size.h"
+
+// Parse latency and bytes copied by builder growth, with a default builder
+// for every document against a builder reserved by `OutputSizeEstimator`.
+
+namespace {
+
+std::string IntVectorJson(size_t count) {
+  std::string json = R"({"f1": 1, "f2": [)";
+  for (size_t i = 0; i < count; i++) {
+    if (i) json += ", ";
+    json += std::to_string(i * 7919 % 100003);
+  }
+  return json + "]}";
+}
+
+std::string StringsJson(size_t length) {
+  return R"({"f1": ")" + std::string(length, 'a') + R"(", "f2": ")" +
+         std::string(length / 2, 'b') + R"(", "f3": "c"})";
+}
+
+}  // namespace
+
+static void OutputSizeReserve(bench::State &state) {
+  const struct {
+    std::string name;
+    const char *root;
+    std::string json;
+  } cases[] = {
+    { "pass1.json", "fbt.tEmpty", bench::LoadSample("/json.org/pass1.json") },
+    { "tStrStrStr_4MB", "fbt.tStrStrStr", StringsJson(size_t(1) << 22) },
+    { "tIntVInt_1M", "fbt.tIntVInt", IntVectorJson(1000000) },
+  };
+  for (const auto &c : cases) {
+    auto parser = bench::TestSchemaParser(c.root);
+    if (!parser) return state.SkipWithError("can't load test.fbs");
+    fbjson::CountingAllocator allocator;
+    auto &fresh = state.Run(
+        "default/" + c.name,
+        [&] {
+          parser->builder_ = flatbuffers::FlatBufferBuilder(1024, &allocator);
+          if (!parser->Parse(c.json.c_str())) std::abort();
+        },
+        c.json.size());
+    // one more call warmed up
+    const auto runs = fresh.iterations + 1.0;
+    fresh.counters.emplace_back("grows", allocator.grows() / runs);
+    fresh.counters.emplace_back("bytes_copied",
+                                allocator.bytes_copied() / runs);
+    allocator.ResetCounters();
+    fbjson::OutputSizeEstimator estimator;
+    auto &reserved = state.Run(
+        "reserved/" + c.name,
+        [&] {
+          if (!estimator.Parse(parser.get(), c.json.c_str(), c.json.size(),
+                               &allocator)) {
+            std::abort();
+          }
+        },
+        c.json.size());
+    const auto reserved_runs = reserved.iterations + 1.0;
+    reserved.counters.emplace_back("grows", allocator.grows() / reserved_runs);
+    reserved.counters.emplace_back("bytes_copied",
+                                   allocator.bytes_copied() / reserved_runs);
+    // release the builder before the allocator goes away
+    parser->builder_ = flatbuffers::FlatBufferBuilder();
+  }
+}
+BENCHMARK(OutputSizeReserve);
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include "bench.h"
+#include "fbjson/array_stream.h"
+#include "fbjson/options.h"
+#include "fbjson/parallel_array.h"
+#include "flatbuffers/util.h"
+#include "synthetic.h"
+
+// Single-document latency of a 64 MiB root array of `fbt.tStrInt` records:
+// the structural prescan alone, the sequential `ArrayStreamParser`, and
+// `ParallelArrayParser` with 1..N threads (independent buffers and joined
+// into one vector). `speedup` is relative to the sequential parse.
+
+namespace {
+
+const std::string &BulkArray() {
+  static const std::string json = [] {
+    std::string s = "[";
+    for (size_t i = 0; s.size() < (size_t(64) << 20); i++) {
+      s += (i ? ",\n" : "\n") + bench::RecordJson(i);
+    }
+    return s + "\n]\n";
+  }();
+  return json;
+}
+
+}  // namespace
+
+static void ParallelArrayParse(bench::State &state) {
+  const auto &json = BulkArray();
+  std::vector<fbjson::ArrayElement> elements;
+  std::string error;
+  state.Run(
+      "split",
+      [&] {
+        if (!fbjson::SplitArray(json.data(), json.size(), &elements, &error)) {
+          std::abort();
+        }
+      },
+      json.size(), 1);
+  const auto records = elements.size();
+
+  auto parser = bench::TestSchemaParser("fbt.tStrInt");
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  const auto &sequential = state.Run(
+      "sequential",
+      [&] {
+        fbjson::ArrayStreamParser stream(parser.get());
+        for (size_t pos = 0; pos < json.size();) {
+          size_t consumed = 0;
+          const auto status =
+              stream.Feed(json.data() + pos, json.size() - pos, &consumed);
+          pos += consumed;
+          if (status == fbjson::ArrayStreamParser::Status::kElement) {
+            auto buf = parser->builder_.Release();
+            bench::DoNotOptimize(buf);
+          } else if (status != fbjson::ArrayStreamParser::Status::kDone) {
+            std::abort();
+          }
+        }
+      },
+      json.size(), records);
+  const auto sequential_seconds =
+      sequential.seconds / static_cast<double>(sequential.iterations);
+
+  fbjson::Schema schema;
+  schema.path = bench::WriteScratchFile(
+      "parallel_array.fbs", "include \"test.fbs\";\n"
+                            "namespace fbt;\n"
+                            "table tStrIntVector { f1 : [tStrInt]; }\n");
+  flatbuffers::LoadFile(schema.path.c_str(), false, &schema.text);
+  schema.root_type = "fbt.tStrInt";
+  schema.include_dirs.push_back(FLATBUFFERS_FBS_DIR);
+  schema.opts = fbjson::StrictJsonOptions();
+
+  const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<size_t> counts;
+  for (size_t n = 1; n < cores; n *= 2) counts.push_back(n);
+  counts.push_back(cores);
+  for (const auto threads : counts) {
+    fbjson::ParallelArrayParser parallel(schema, threads);
+    std::vector<flatbuffers::DetachedBuffer> buffers;
+    auto &sample = state.Run(
+        "threads:" + std::to_string(threads),
+        [&] {
+          if (!parallel.Parse(json.data(), json.size(), &buffers)) {
+            std::abort();
+          }
+        },
+        json.size(), records);
+    sample.counters.emplace_back(
+        "speedup", sequential_seconds * static_cast<double>(sample.iterations) /
+                       sample.seconds);
+    sample.counters.emplace_back("split_ms", parallel.timings().split * 1e3);
+  }
+  fbjson::ParallelArrayParser parallel(schema, cores);
+  flatbuffers::DetachedBuffer joined;
+  auto &sample = state.Run(
+      "joined/threads:" + std::to_string(cores),
+      [&] {
+        if (!parallel.ParseJoined(json.data(), json.size(),
+                                  "fbt.tStrIntVector", "f1", &joined)) {
+          std::abort();
+        }
+      },
+      json.size(), records);
+  sample.counters.emplace_back(
+      "speedup", sequential_seconds * static_cast<double>(sample.iterations) /
+                     sample.seconds);
+  sample.counters.emplace_back("join_ms", parallel.timings().join * 1e3);
+}
+BENCHMARK(ParallelArrayParse);
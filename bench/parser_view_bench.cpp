@@ -0,0 +1,71 @@
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.h"
+#include "fbjson/options.h"
+#include "fbjson/parser_view.h"
+#include "synthetic.h"
+
+// Parsers for tenants with other JSON options on the schema of `test.fbs`
+// and on generated schemas with 1k and 10k tables of 8 fields:
+// - parse: a `flatbuffers::Parser` with the tenant's options parsing the
+//   schema text, as for each `ParserTraits` variant of the tests;
+// - view: a `ParserView` of an already parsed base parser with the
+//   tenant's options and its root type set;
+// - json/parser, json/view: a document of the root table through each.
+
+static void ParserViewCreate(bench::State &state) {
+  std::vector<std::pair<std::string, std::string>> schemas;
+  schemas.emplace_back("test", bench::LoadSchema("test.fbs") +
+                                   "root_type fbt.tStrIntInt;\n");
+  for (const size_t tables : { 1000, 10000 }) {
+    schemas.emplace_back(std::to_string(tables / 1000) + "k",
+                         bench::SyntheticSchema("bench.view", tables, 8));
+  }
+  auto tenant = fbjson::StrictJsonOptions();
+  tenant.strict_json = false;
+  tenant.skip_unexpected_fields_in_json = false;
+  for (const auto &schema : schemas) {
+    const auto &label = schema.first;
+    flatbuffers::Parser base(fbjson::StrictJsonOptions());
+    if (!base.Parse(schema.second.c_str())) {
+      state.SkipWithError(base.error_);
+      return;
+    }
+    const auto root = base.root_struct_def_->defined_namespace
+                          ->GetFullyQualifiedName(base.root_struct_def_->name);
+
+    std::unique_ptr<flatbuffers::Parser> parser;
+    state.Run(
+        label + "/parse",
+        [&] {
+          parser.reset(new flatbuffers::Parser(tenant));
+          if (!parser->Parse(schema.second.c_str())) std::abort();
+        },
+        schema.second.size());
+    std::unique_ptr<fbjson::ParserView> view;
+    state.Run(label + "/view", [&] {
+      view.reset(new fbjson::ParserView(base, tenant));
+      if (!view->SetRootType(root.c_str())) std::abort();
+    });
+
+    const auto json = label == "test"
+                          ? std::string(R"({"f1": "a", "f2": 1, "f3": 2})")
+                          : bench::SyntheticJson(8);
+    state.Run(
+        label + "/json/parser",
+        [&] {
+          if (!parser->Parse(json.c_str())) std::abort();
+        },
+        json.size());
+    state.Run(
+        label + "/json/view",
+        [&] {
+          if (!view->Parse(json.c_str())) std::abort();
+        },
+        json.size());
+  }
+}
+BENCHMARK(ParserViewCreate);
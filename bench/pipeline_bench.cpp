@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include "bench.h"
+#include "fbjson/options.h"
+#include "fbjson/pipeline.h"
+#include "flatbuffers/util.h"
+#include "synthetic.h"
+
+// End-to-end conversion of a synthetic directory tree (64 directories of 64
+// documents) by `ConversionPipeline` with different thread counts per stage.
+// Counters report per-stage utilization and back-pressure (pushes which found
+// the next queue full).
+
+namespace {
+
+const size_t kDirectories = 64;
+const size_t kFilesPerDirectory = 64;
+const size_t kFields = 48;
+
+struct Tree {
+  fbjson::Schema schema;
+  std::vector<std::string> files;
+  size_t bytes = 0;
+};
+
+const Tree &SyntheticTree() {
+  static const Tree tree = [] {
+    namespace fs = std::filesystem;
+    Tree t;
+    t.schema.path = bench::WriteScratchFile(
+        "pipeline.fbs", bench::SyntheticSchema("pipeline", 4, kFields));
+    t.schema.opts = fbjson::StrictJsonOptions();
+    flatbuffers::LoadFile(t.schema.path.c_str(), false, &t.schema.text);
+    const auto root = fs::path(bench::ScratchDir()) / "pipeline_tree";
+    for (size_t d = 0; d < kDirectories; d++) {
+      const auto dir = root / ("d" + std::to_string(d));
+      fs::create_directories(dir);
+      for (size_t f = 0; f < kFilesPerDirectory; f++) {
+        const auto json = bench::SyntheticJson(kFields, d * 1000 + f);
+        // unique stems, outputs go to one directory
+        const auto path = (dir / ("d" + std::to_string(d) + "_" +
+                                  std::to_string(f) + ".json"))
+                              .string();
+        flatbuffers::SaveFile(path.c_str(), json, false);
+        t.files.push_back(path);
+        t.bytes += json.size();
+      }
+    }
+    return t;
+  }();
+  return tree;
+}
+
+void Convert(bench::State &state, const std::string &label,
+             const fbjson::PipelineOptions &options) {
+  const auto &tree = SyntheticTree();
+  fbjson::ConversionPipeline pipeline(tree.schema, options);
+  fbjson::PipelineStats stats;
+  auto &sample = state.Run(
+      label,
+      [&] {
+        if (!pipeline.Run(tree.files, &stats)) std::abort();
+      },
+      tree.bytes, tree.files.size());
+  // counters of the last run
+  for (int s = 0; s < fbjson::PipelineStats::kNumStages; s++) {
+    const auto &stage = stats.stages[s];
+    if (!stage.threads) continue;
+    const std::string name = fbjson::PipelineStats::StageName(
+        static_cast<fbjson::PipelineStats::Stage>(s));
+    sample.counters.emplace_back(name + "_util",
+                                 stage.Utilization(stats.seconds));
+    sample.counters.emplace_back(name + "_full",
+                                 static_cast<double>(stage.full_waits));
+  }
+}
+
+}  // namespace
+
+static void PipelineDirectoryTree(bench::State &state) {
+  const auto &tree = SyntheticTree();
+  if (tree.schema.text.empty()) {
+    return state.SkipWithError("can't write the synthetic tree");
+  }
+  const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  fbjson::PipelineOptions options;
+  options.read_threads = options.parse_threads = options.verify_threads =
+      options.write_threads = 1;
+  Convert(state, "1-1-1-1", options);
+  options.parse_threads = std::max<size_t>(1, cores / 2);
+  Convert(state, "1-" + std::to_string(options.parse_threads) + "-1-1",
+          options);
+  options.read_threads = 2;
+  options.parse_threads = cores;
+  options.verify_threads = 2;
+  Convert(state, "2-" + std::to_string(cores) + "-2-1", options);
+  options.verify = false;
+  Convert(state, "2-" + std::to_string(cores) + "-0-1", options);
+  options.verify = true;
+  options.queue_capacity = 1;
+  Convert(state, "2-" + std::to_string(cores) + "-2-1/queue1", options);
+  options.queue_capacity = 64;
+  options.write_threads = 2;
+  options.output_dir = bench::ScratchDir() + "/pipeline_out";
+  Convert(state, "2-" + std::to_string(cores) + "-2-2/write", options);
+}
+BENCHMARK(PipelineDirectoryTree);
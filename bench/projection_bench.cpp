@@ -0,0 +1,61 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "fbjson/meta_parser.h"
+#include "records_meta_generated.h"
+
+// Wide documents (200 fields) parsed in full and with a projection of
+// 3 fields.
+
+namespace {
+
+std::string WideJson(size_t seed) {
+  std::string json = "{";
+  for (size_t f = 0; f < 200; f++) {
+    const auto v = std::to_string(seed * 131 + f);
+    json += (f ? ", \"f" : "\"f") + std::to_string(f) + "\": ";
+    switch (f % 4) {
+      case 0: json += v; break;
+      case 2: json += v + ".5e-3"; break;
+      default: json += "\"text \\\"" + v + "\\\" \\u00e9 more text\""; break;
+    }
+  }
+  return json + "}";
+}
+
+}  // namespace
+
+static void ProjectionWide(bench::State &state) {
+  const auto root = static_cast<int>(records::meta::TableIndex::Wide);
+  std::vector<std::string> docs;
+  size_t bytes = 0;
+  for (size_t i = 0; i < 16; i++) {
+    docs.push_back(WideJson(i));
+    bytes += docs.back().size();
+  }
+  const struct {
+    const char *name;
+    std::vector<std::string> fields;
+  } cases[] = {
+    { "full", {} },
+    { "3_of_200", { "records.Wide.f0", "records.Wide.f101",
+                    "records.Wide.f198" } },
+  };
+  for (const auto &c : cases) {
+    fbjson::MetaParser parser(records::meta::kSchema);
+    if (!parser.SetProjection(c.fields)) {
+      return state.SkipWithError(parser.error_);
+    }
+    auto &sample = state.Run(
+        c.name,
+        [&] {
+          for (const auto &doc : docs) {
+            if (!parser.Parse(doc.c_str(), root)) std::abort();
+          }
+        },
+        bytes, docs.size());
+    sample.counters.emplace_back("output_bytes", parser.builder_.GetSize());
+  }
+}
+BENCHMARK(ProjectionWide);
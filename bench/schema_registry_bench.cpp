@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include "bench.h"
+#include "fbjson/options.h"
+#include "fbjson/schema_registry.h"
+#include "flatbuffers/registry.h"
+#include "flatbuffers/util.h"
+#include "synthetic.h"
+
+// Mixed-schema conversion throughput: `test.fbs` plus generated schemas, each
+// registered under its own file identifier. Documents are converted in
+// round-robin order by 1..N threads.
+
+namespace {
+
+struct Document {
+  std::string file_identifier;
+  std::string json;
+};
+
+struct Corpus {
+  std::vector<std::pair<std::string, std::string>> schemas;  // ident, path
+  std::vector<Document> documents;
+};
+
+const Corpus &MixedCorpus() {
+  static const Corpus corpus = [] {
+    Corpus c;
+    // `test.fbs` doesn't declare root type and identifier, wrap it.
+    c.schemas.emplace_back(
+        "TEST", bench::WriteScratchFile("registry_test.fbs",
+                                        "include \"test.fbs\";\n"
+                                        "root_type fbt.tStrIntInt;\n"
+                                        "file_identifier \"TEST\";\n"));
+    c.documents.push_back({ "TEST", R"({"f1": "test", "f2": 1, "f3": 2})" });
+    for (size_t i = 0; i < 15; i++) {
+      char ident[8];
+      std::snprintf(ident, sizeof(ident), "S%03zu", i);
+      const auto fields = 4 + i * 2;
+      c.schemas.emplace_back(
+          ident, bench::WriteScratchFile(
+                     std::string(ident) + ".fbs",
+                     bench::SyntheticSchema("gen" + std::string(ident),
+                                            2 + i, fields, ident)));
+      c.documents.push_back({ ident, bench::SyntheticJson(fields, i) });
+    }
+    return c;
+  }();
+  return corpus;
+}
+
+template<typename Worker>
+void RunThreads(bench::State &state, const std::string &label,
+                size_t num_threads, Worker worker_factory) {
+  std::atomic<bool> stop(false);
+  std::atomic<size_t> total(0);
+  std::atomic<size_t> total_bytes(0);
+  std::vector<std::thread> threads;
+  const auto start = bench::Clock::now();
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      auto convert = worker_factory();
+      const auto &docs = MixedCorpus().documents;
+      size_t n = 0, bytes = 0;
+      for (size_t i = t; !stop.load(std::memory_order_relaxed); i++, n++) {
+        const auto &doc = docs[i % docs.size()];
+        if (!convert(doc)) std::abort();
+        bytes += doc.json.size();
+      }
+      total += n;
+      total_bytes += bytes;
+    });
+  }
+  std::this_thread::sleep_for(
+      std::chrono::duration<double>(state.min_time()));
+  stop = true;
+  for (auto &t : threads) t.join();
+  bench::Sample sample;
+  sample.name = label + "/threads:" + std::to_string(num_threads);
+  sample.seconds = bench::SecondsSince(start);
+  sample.iterations = total;
+  sample.items = static_cast<double>(total);
+  sample.bytes = static_cast<double>(total_bytes);
+  state.Report(std::move(sample));
+}
+
+std::vector<size_t> ThreadCounts() {
+  std::vector<size_t> counts;
+  const size_t max_threads =
+      std::max(1u, std::thread::hardware_concurrency());
+  for (size_t n = 1; n < max_threads; n *= 2) counts.push_back(n);
+  counts.push_back(max_threads);
+  return counts;
+}
+
+}  // namespace
+
+// Baseline: `flatbuffers::Registry` builds a parser and reloads the schema
+// for each conversion. It isn't thread-safe, so every thread owns one.
+static void RegistryMixedSchemas(bench::State &state) {
+  for (auto n : ThreadCounts()) {
+    RunThreads(state, "flatbuffers_registry", n, [] {
+      std::shared_ptr<flatbuffers::Registry> registry(
+          new flatbuffers::Registry());
+      registry->SetOptions(fbjson::StrictJsonOptions());
+      registry->AddIncludeDirectory(FLATBUFFERS_FBS_DIR);
+      for (const auto &s : MixedCorpus().schemas) {
+        registry->Register(s.first.c_str(), s.second.c_str());
+      }
+      return [registry](const Document &doc) {
+        auto buf = registry->TextToFlatBuffer(doc.json.c_str(),
+                                              doc.file_identifier.c_str());
+        return buf.size() != 0;
+      };
+    });
+  }
+}
+BENCHMARK(RegistryMixedSchemas);
+
+static void SchemaRegistryMixedSchemas(bench::State &state) {
+  fbjson::SchemaRegistry registry;
+  registry.SetOptions(fbjson::StrictJsonOptions());
+  registry.AddIncludeDirectory(FLATBUFFERS_FBS_DIR);
+  for (const auto &s : MixedCorpus().schemas) {
+    if (!registry.Register(s.first.c_str(), s.second.c_str())) {
+      return state.SkipWithError(registry.GetLastError());
+    }
+  }
+  for (auto n : ThreadCounts()) {
+    RunThreads(state, "shared_schemas", n, [&registry] {
+      std::shared_ptr<fbjson::SchemaRegistry::ParseContext> ctx(
+          new fbjson::SchemaRegistry::ParseContext(registry));
+      return [ctx](const Document &doc) {
+        return nullptr != ctx->Parse(doc.json.c_str(),
+                                     doc.file_identifier.c_str());
+      };
+    });
+  }
+}
+BENCHMARK(SchemaRegistryMixedSchemas);
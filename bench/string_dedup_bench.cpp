@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <string>
+#include "bench.h"
+#include "fbjson/meta_parser.h"
+#include "records_meta_generated.h"
+
+// Output size, parse time and shared string table memory of `MetaParser`
+// with string deduplication on and off. The corpus repeats enum-like status
+// and region strings and a limited set of owners, with unique comments.
+
+namespace {
+
+std::string RecordCorpus(size_t count) {
+  static const char *const kStatus[] = { "active", "pending", "suspended",
+                                         "closed", "archived" };
+  static const char *const kRegion[] = { "eu-west", "eu-central", "us-east",
+                                         "us-west", "ap-south", "ap-east" };
+  std::string json = R"({"records": [)";
+  for (size_t i = 0; i < count; i++) {
+    const auto n = i * 2654435761u;
+    if (i) json += ",\n";
+    json += R"({"id": )" + std::to_string(i) + R"(, "status": ")" +
+            kStatus[n % 5] + R"(", "region": ")" + kRegion[(n >> 8) % 6] +
+            R"(", "owner": "user)" + std::to_string((n >> 16) % 200) +
+            R"(", "comment": "note )" + std::to_string(n) +
+            R"(", "amount": )" + std::to_string(i % 1000) + ".25}";
+  }
+  return json + "]}";
+}
+
+}  // namespace
+
+static void StringDedup(bench::State &state) {
+  for (size_t count : { 1000, 100000 }) {
+    const auto json = RecordCorpus(count);
+    for (const auto share : { false, true }) {
+      fbjson::MetaParserOptions opts;
+      opts.share_strings = share;
+      fbjson::MetaParser parser(records::meta::kSchema, opts);
+      if (!parser.Parse(json.c_str())) {
+        return state.SkipWithError(parser.error_);
+      }
+      const auto label =
+          std::string(share ? "shared/" : "plain/") + std::to_string(count);
+      auto &sample = state.Run(
+          label,
+          [&] {
+            if (!parser.Parse(json.c_str())) std::abort();
+          },
+          json.size(), count);
+      sample.counters.emplace_back("output_bytes", parser.builder_.GetSize());
+      sample.counters.emplace_back("table_bytes",
+                                   parser.SharedStringsMemory());
+    }
+  }
+}
+BENCHMARK(StringDedup);
@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "fbjson/flex_parser.h"
+#include "fbjson/options.h"
+#include "fbjson/string_scan.h"
+#include "flatbuffers/util.h"
+
+// Escape handling on 8 MiB of long strings (4 KiB each), plain ASCII and
+// mixed UTF-8 (ASCII with 2-4 byte characters every few words):
+// - scan: plain-run scan of the JSON text, byte loop and `SkipPlain`;
+// - escape: output with `flatbuffers::EscapeString` and `AppendEscaped`;
+// - parse: a JSON array of the strings with `Parser::ParseFlexBuffer` and
+//   `FlexParser` (whose string reader uses `SkipPlain`).
+
+namespace {
+
+const size_t kStringSize = 4096;
+const size_t kTotalSize = size_t(8) << 20;
+
+std::vector<std::string> LongStrings(bool mixed) {
+  static const char *const kWords[] = { "lorem", "ipsum", "dolor", "sit",
+                                        "amet", "consectetur", "adipiscing" };
+  static const char *const kUtf8[] = { "\xc3\xa9", "\xe2\x82\xac",
+                                       "\xf0\x9d\x84\x9e", "\xd0\xb6" };
+  std::vector<std::string> strings(kTotalSize / kStringSize);
+  size_t n = 0;
+  for (auto &s : strings) {
+    while (s.size() < kStringSize) {
+      s += kWords[n % 7];
+      s += mixed && n % 3 == 0 ? kUtf8[n % 4] : " ";
+      n++;
+    }
+  }
+  return strings;
+}
+
+// `["...", "...", ...]`
+std::string JsonArray(const std::vector<std::string> &strings) {
+  std::string json = "[";
+  for (const auto &s : strings) {
+    json += json.size() > 1 ? ",\n\"" : "\n\"";
+    json += s;
+    json += "\"";
+  }
+  return json + "\n]\n";
+}
+
+// The scan loop of the parsers before `SkipPlain`.
+const char *SkipPlainBytes(const char *p) {
+  while (*p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20 &&
+         static_cast<unsigned char>(*p) < 0x7f) {
+    p++;
+  }
+  return p;
+}
+
+}  // namespace
+
+static void StringScan(bench::State &state) {
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  flexbuffers::Builder flex_builder;
+  fbjson::FlexParser flex_parser;
+  for (const auto mixed : { false, true }) {
+    const std::string prefix = mixed ? "mixed/" : "ascii/";
+    const auto strings = LongStrings(mixed);
+    const auto json = JsonArray(strings);
+
+    // the whole text, one run at a time
+    auto scan = [&](const char *(*skip)(const char *)) {
+      size_t runs = 0;
+      for (auto p = skip(json.c_str()); *p; p = skip(p + 1)) runs++;
+      bench::DoNotOptimize(runs);
+    };
+    state.Run(
+        prefix + "scan/bytes", [&] { scan(SkipPlainBytes); }, json.size());
+    state.Run(
+        prefix + "scan/simd", [&] { scan(fbjson::SkipPlain); }, json.size());
+
+    std::string text;
+    text.reserve(json.size() * 2);
+    auto &escape_string = state.Run(
+        prefix + "escape/escape_string",
+        [&] {
+          text.clear();
+          for (const auto &s : strings) {
+            flatbuffers::EscapeString(s.data(), s.size(), &text, false, true);
+          }
+        },
+        json.size());
+    escape_string.counters.emplace_back("output_bytes", text.size());
+    auto &append_escaped = state.Run(
+        prefix + "escape/append_escaped",
+        [&] {
+          text.clear();
+          for (const auto &s : strings) {
+            fbjson::AppendEscaped(s.data(), s.size(), &text, false, true);
+          }
+        },
+        json.size());
+    append_escaped.counters.emplace_back("output_bytes", text.size());
+
+    state.Run(
+        prefix + "parse/parser",
+        [&] {
+          flex_builder.Clear();
+          if (!parser.ParseFlexBuffer(json.c_str(), nullptr, &flex_builder)) {
+            std::abort();
+          }
+        },
+        json.size());
+    state.Run(
+        prefix + "parse/flex",
+        [&] {
+          if (!flex_parser.Parse(json.c_str())) std::abort();
+        },
+        json.size());
+  }
+}
+BENCHMARK(StringScan);
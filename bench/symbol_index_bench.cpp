@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bench.h"
+#include "fbjson/frozen_schema.h"
+#include "fbjson/options.h"
+#include "fbjson/parser_view.h"
+#include "fbjson/symbol_index.h"
+#include "synthetic.h"
+
+// Symbol tables of `test.fbs` and of generated schemas with 1k, 10k and
+// 50k tables of 8 fields:
+// - parse: `flatbuffers::Parser` parsing the schema text;
+// - index: building a `SymbolIndex` of the parsed schema;
+// - lookup/map, lookup/flat: a table by qualified name, then one of its
+//   fields, in random order, through the parser's `std::map`s and through
+//   the index;
+// - frozen/scan, frozen/index: the same through a `FrozenSchema`, by a
+//   linear scan of the table names (as `FindTable` did) and by
+//   `FindTable` and `FindField` on its index, for 1000 of the keys; not
+//   run on schemas too large to freeze;
+// - root/map, root/index: `ParserView::SetRootType` of each table, without
+//   and with a shared index of the base.
+// `map_bytes` estimates the nodes and key strings of the parser's tables
+// (libstdc++ node layout), `index_bytes` is `SymbolIndex::MemoryUsage`.
+
+namespace {
+
+// Red-black tree node: color, parent, left, right, then the value.
+const size_t kMapNodeHeader = 32;
+
+template<typename T> size_t MapBytes(const std::map<std::string, T *> &map) {
+  size_t bytes = 0;
+  for (const auto &entry : map) {
+    bytes += kMapNodeHeader + sizeof(entry);
+    // outside of the small string buffer
+    if (entry.first.capacity() > 15) bytes += entry.first.capacity() + 1;
+  }
+  return bytes;
+}
+
+size_t SymbolTableBytes(const flatbuffers::Parser &parser) {
+  auto bytes = MapBytes(parser.structs_.dict) + MapBytes(parser.enums_.dict);
+  for (const auto sd : parser.structs_.vec) bytes += MapBytes(sd->fields.dict);
+  return bytes;
+}
+
+}  // namespace
+
+static void SymbolIndexLookup(bench::State &state) {
+  std::vector<std::pair<std::string, std::string>> schemas;
+  schemas.emplace_back("test", bench::LoadSchema("test.fbs"));
+  for (const size_t tables : { 1000, 10000, 50000 }) {
+    schemas.emplace_back(std::to_string(tables / 1000) + "k",
+                         bench::SyntheticSchema("bench.symbols", tables, 8));
+  }
+  for (const auto &schema : schemas) {
+    const auto &label = schema.first;
+    std::unique_ptr<flatbuffers::Parser> parser;
+    state.Run(
+        label + "/parse",
+        [&] {
+          parser.reset(new flatbuffers::Parser(fbjson::StrictJsonOptions()));
+          if (!parser->Parse(schema.second.c_str())) std::abort();
+        },
+        schema.second.size());
+
+    std::unique_ptr<fbjson::SymbolIndex> index;
+    state.Run(label + "/index",
+              [&] { index.reset(new fbjson::SymbolIndex(*parser)); });
+
+    // (qualified table name, field name)
+    std::vector<std::pair<std::string, std::string>> keys;
+    for (const auto &entry : parser->structs_.dict) {
+      for (const auto fd : entry.second->fields.vec) {
+        keys.emplace_back(entry.first, fd->name);
+      }
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+    keys.resize(std::min<size_t>(keys.size(), 100000));
+
+    auto &map = state.Run(
+        label + "/lookup/map",
+        [&] {
+          for (const auto &key : keys) {
+            const auto sd = parser->structs_.Lookup(key.first);
+            bench::DoNotOptimize(sd->fields.Lookup(key.second));
+          }
+        },
+        0, keys.size());
+    map.counters.emplace_back("map_bytes", SymbolTableBytes(*parser));
+
+    auto &flat = state.Run(
+        label + "/lookup/flat",
+        [&] {
+          for (const auto &key : keys) {
+            const auto i = index->FindStruct(key.first.data(),
+                                             key.first.size());
+            bench::DoNotOptimize(
+                index->LookupField(i, key.second.data(), key.second.size()));
+          }
+        },
+        0, keys.size());
+    flat.counters.emplace_back("index_bytes", index->MemoryUsage());
+
+    const fbjson::FrozenSchema frozen(*parser);
+    if (frozen.ok()) {
+      const std::vector<std::pair<std::string, std::string>> frozen_keys(
+          keys.begin(), keys.begin() + std::min<size_t>(keys.size(), 1000));
+      const auto &schema = frozen.schema();
+      state.Run(
+          label + "/frozen/scan",
+          [&] {
+            for (const auto &key : frozen_keys) {
+              for (size_t t = 0; t < schema.num_tables; t++) {
+                const auto &table = schema.tables[t];
+                if (std::strcmp(table.name, key.first.c_str())) continue;
+                bench::DoNotOptimize(
+                    table.Lookup(key.second.data(), key.second.size()));
+                break;
+              }
+            }
+          },
+          0, frozen_keys.size());
+      state.Run(
+          label + "/frozen/index",
+          [&] {
+            for (const auto &key : frozen_keys) {
+              const auto t = frozen.FindTable(key.first.c_str());
+              bench::DoNotOptimize(frozen.FindField(t, key.second.c_str()));
+            }
+          },
+          0, frozen_keys.size());
+    }
+
+    fbjson::ParserView map_view(*parser, parser->opts);
+    fbjson::ParserView index_view(*parser, parser->opts, index.get());
+    for (const auto view : { &map_view, &index_view }) {
+      state.Run(
+          label + (view == &map_view ? "/root/map" : "/root/index"),
+          [&] {
+            for (const auto &key : keys) {
+              bench::DoNotOptimize(view->SetRootType(key.first.c_str()));
+            }
+          },
+          0, keys.size());
+    }
+  }
+}
+BENCHMARK(SymbolIndexLookup);
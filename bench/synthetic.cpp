@@ -0,0 +1,60 @@
+#include "synthetic.h"
+
+#include <stdexcept>
+#include "bench.h"
+#include "flatbuffers/util.h"
+
+namespace bench {
+
+static const char *const kFieldTypes[] = { "int", "string", "float", "bool" };
+
+std::string SyntheticSchema(const std::string &ns, size_t tables,
+                            size_t fields, const char *file_identifier) {
+  std::string schema = "namespace " + ns + ";\n";
+  for (size_t t = 0; t < tables; t++) {
+    schema += "table T" + flatbuffers::NumToString(t) + " {\n";
+    for (size_t f = 0; f < fields; f++) {
+      schema += "  f" + flatbuffers::NumToString(f) + " : " +
+                kFieldTypes[f % 4] + ";\n";
+    }
+    schema += "}\n";
+  }
+  schema += "root_type T0;\n";
+  if (file_identifier) {
+    schema += "file_identifier \"" + std::string(file_identifier) + "\";\n";
+  }
+  return schema;
+}
+
+std::string SyntheticJson(size_t fields, size_t seed) {
+  std::string json = "{";
+  for (size_t f = 0; f < fields; f++) {
+    if (f) json += ", ";
+    json += "\"f" + flatbuffers::NumToString(f) + "\": ";
+    const auto v = flatbuffers::NumToString(seed * 31 + f);
+    switch (f % 4) {
+      case 0: json += v; break;
+      case 1: json += "\"value " + v + "\""; break;
+      case 2: json += v + ".25"; break;
+      default: json += ((seed + f) % 2) ? "true" : "false"; break;
+    }
+  }
+  return json + "}";
+}
+
+std::string RecordJson(size_t i) {
+  const auto v = flatbuffers::NumToString(i);
+  return "{\"f1\": \"record " + v + " [\\\"" + v + "\\\"]}\", \"f2\": " + v +
+         "}";
+}
+
+std::string WriteScratchFile(const std::string &name,
+                             const std::string &content) {
+  const auto path = flatbuffers::ConCatPathFileName(ScratchDir(), name);
+  if (!flatbuffers::SaveFile(path.c_str(), content, false)) {
+    throw std::runtime_error("can't write " + path);
+  }
+  return path;
+}
+
+}  // namespace bench
@@ -0,0 +1,31 @@
+#ifndef FLATBUFFERS_TESTS_SYNTHETIC_H_
+#define FLATBUFFERS_TESTS_SYNTHETIC_H_
+
+#include <cstddef>
+#include <string>
+
+// Generators of synthetic schemas and documents for benchmarks.
+
+namespace bench {
+
+// Schema with `tables` tables `T0..Tn` in namespace `ns`, each table has
+// `fields` fields `f0..fn` of cycling types (int, string, float, bool).
+// The root type is `T0`.
+std::string SyntheticSchema(const std::string &ns, size_t tables,
+                            size_t fields,
+                            const char *file_identifier = nullptr);
+
+// JSON document for a table of `SyntheticSchema`.
+std::string SyntheticJson(size_t fields, size_t seed = 0);
+
+// Element `i` of a bulk export: a root array of `fbt.tStrInt` records with
+// escapes and brackets in strings.
+std::string RecordJson(size_t i);
+
+// Write `content` to `ScratchDir()/name` and return the full path.
+std::string WriteScratchFile(const std::string &name,
+                             const std::string &content);
+
+}  // namespace bench
+
+#endif  // FLATBUFFERS_TESTS_SYNTHETIC_H_
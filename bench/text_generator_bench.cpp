@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "bench.h"
+#include "fbjson/options.h"
+#include "fbjson/text_generator.h"
+
+// TextGeneratorFloats: throughput of printing a float-heavy FlatBuffer
+// (~8 MiB of text) with `flatbuffers::GenerateText` (fixed 6/12 digits) and
+// `fbjson::GenerateText` with shortest round-trip floats and with flatc's
+// fixed precision.
+// TextGeneratorSink: a FlatBuffer of ~1 GiB of text (`FBJSON_BENCH_TEXT_MB`
+// overrides the size) printed once by each variant, with the growth of the
+// resident set:
+// - fd/pretty, fd/compact: chunks written to the null device;
+// - string/pretty, string/compact: the whole text in a `std::string`;
+// - flatc: `flatbuffers::GenerateText` into a `std::string`.
+
+namespace {
+
+const char *const kCloudSchema = R"(
+namespace cloud;
+struct Point { x : double; y : double; z : float; }
+table Cloud { points : [Point]; values : [double]; weights : [float]; }
+root_type Cloud;
+)";
+
+std::string CloudJson() {
+  std::string points, values, weights;
+  for (size_t i = 0; points.size() < (size_t(4) << 20); i++) {
+    const auto sep = i ? "," : "";
+    const auto v = std::to_string(i);
+    points += sep;
+    points += "{\"x\": " + v + ".1, \"y\": -" + v + ".0625, \"z\": 0." + v +
+              "}";
+    values += sep + std::to_string(i * 0.001) + "e-" + std::to_string(i % 30);
+    weights += sep + std::to_string(i % 1000) + ".3";
+  }
+  return "{\"points\": [" + points + "], \"values\": [" + values +
+         "], \"weights\": [" + weights + "]}";
+}
+
+// `cloud.Cloud` with only `points`, whose text with the default indentation
+// is about `text_bytes`.
+flatbuffers::DetachedBuffer LargeCloud(size_t text_bytes) {
+  // `{"x": 1.1, "y": -1.0625, "z": 0.142857}` takes ~80 bytes indented
+  const size_t points = text_bytes / 80;
+  const size_t point_size = 24;
+  flatbuffers::FlatBufferBuilder fbb(points * point_size + 1024);
+  // `CreateVectorOfStructs` without a C++ type of the struct
+  fbb.StartVector(points * point_size / sizeof(double), sizeof(double));
+  uint8_t block[1024 * point_size] = {};
+  for (size_t i = 0; i < points;) {
+    const auto n = std::min<size_t>(1024, points - i);
+    for (size_t j = 0; j < n; j++, i++) {
+      const double x = i + 0.1, y = -(i + 0.0625);
+      const float z = (i % 1000) / 7.0f;
+      std::memcpy(block + j * point_size, &x, sizeof(x));
+      std::memcpy(block + j * point_size + 8, &y, sizeof(y));
+      std::memcpy(block + j * point_size + 16, &z, sizeof(z));
+    }
+    fbb.PushBytes(block, n * point_size);
+  }
+  const auto vec = fbb.EndVector(points);
+  const auto start = fbb.StartTable();
+  fbb.AddOffset(4, flatbuffers::Offset<flatbuffers::Vector<uint8_t>>(vec));
+  fbb.Finish(flatbuffers::Offset<flatbuffers::Table>(fbb.EndTable(start)));
+  return fbb.Release();
+}
+
+// Time and resident memory growth of printing the text once.
+class Measurement {
+ public:
+  Measurement() : base_rss_(bench::ResidentBytes()) {}
+
+  // Counts a chunk, samples the resident set every 256 chunks.
+  void OnChunk(size_t size) {
+    if (chunks_++ % 256 == 0) Sample();
+    bytes_ += size;
+  }
+
+  void Report(bench::State &state, const std::string &label,
+              size_t bytes = 0) {
+    const auto seconds = bench::SecondsSince(start_);
+    Sample();
+    bench::Sample sample;
+    sample.name = label;
+    sample.iterations = 1;
+    sample.seconds = seconds;
+    sample.bytes = static_cast<double>(bytes ? bytes : bytes_);
+    sample.counters.emplace_back("output_mb", sample.bytes / (1024 * 1024));
+    sample.counters.emplace_back("rss_growth_mb", max_growth_ / (1024 * 1024));
+    sample.counters.emplace_back("peak_rss_mb", bench::PeakResidentBytes() /
+                                                    (1024.0 * 1024.0));
+    state.Report(std::move(sample));
+  }
+
+ private:
+  void Sample() {
+    const auto growth = static_cast<double>(bench::ResidentBytes()) -
+                        static_cast<double>(base_rss_);
+    max_growth_ = std::max(max_growth_, growth);
+  }
+
+  const size_t base_rss_;
+  const bench::Clock::time_point start_ = bench::Clock::now();
+  size_t chunks_ = 0;
+  size_t bytes_ = 0;
+  double max_growth_ = 0;
+};
+
+}  // namespace
+
+static void TextGeneratorFloats(bench::State &state) {
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  if (!parser.Parse(kCloudSchema) || !parser.Parse(CloudJson().c_str())) {
+    return state.SkipWithError(parser.error_);
+  }
+  const auto buffer = parser.builder_.GetBufferPointer();
+  std::string text;
+  flatbuffers::GenerateText(parser, buffer, &text);
+  auto &flatc = state.Run(
+      "flatc",
+      [&] {
+        text.clear();
+        if (!flatbuffers::GenerateText(parser, buffer, &text)) std::abort();
+      },
+      text.size());
+  flatc.counters.emplace_back("output_bytes", text.size());
+
+  fbjson::TextOptions shortest;
+  text.clear();
+  fbjson::GenerateText(parser, buffer, shortest, &text);
+  auto &shortest_path = state.Run(
+      "fbjson/shortest",
+      [&] {
+        text.clear();
+        if (!fbjson::GenerateText(parser, buffer, shortest, &text)) {
+          std::abort();
+        }
+      },
+      text.size());
+  shortest_path.counters.emplace_back("output_bytes", text.size());
+
+  fbjson::TextOptions fixed;
+  fixed.float_precision = 12;
+  text.clear();
+  fbjson::GenerateText(parser, buffer, fixed, &text);
+  auto &fixed_path = state.Run(
+      "fbjson/fixed12",
+      [&] {
+        text.clear();
+        if (!fbjson::GenerateText(parser, buffer, fixed, &text)) std::abort();
+      },
+      text.size());
+  fixed_path.counters.emplace_back("output_bytes", text.size());
+}
+BENCHMARK(TextGeneratorFloats);
+
+static void TextGeneratorSink(bench::State &state) {
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  if (!parser.Parse(kCloudSchema)) return state.SkipWithError(parser.error_);
+  const char *env = std::getenv("FBJSON_BENCH_TEXT_MB");
+  const auto text_mb = env ? std::max(1, std::atoi(env)) : 1024;
+  const auto cloud = LargeCloud(text_mb * size_t(1024 * 1024));
+  const auto buffer = cloud.data();
+
+  // constant memory variants first, the peak only grows
+  for (const auto compact : { false, true }) {
+    auto null = std::fopen("/dev/null", "wb");
+    if (!null) return state.SkipWithError("can't open /dev/null");
+    fbjson::TextOptions options;
+    options.compact = compact;
+    const auto write = fbjson::FdChunkWriter(fileno(null));
+    Measurement m;
+    const auto ok = fbjson::GenerateText(
+        parser, buffer, options, [&](const char *data, size_t size) {
+          m.OnChunk(size);
+          return write(data, size);
+        });
+    std::fclose(null);
+    if (!ok) return state.SkipWithError("can't write /dev/null");
+    m.Report(state, compact ? "fd/compact" : "fd/pretty");
+  }
+  for (const auto compact : { false, true }) {
+    fbjson::TextOptions options;
+    options.compact = compact;
+    Measurement m;
+    std::string text;
+    if (!fbjson::GenerateText(parser, buffer, options, &text)) std::abort();
+    m.Report(state, compact ? "string/compact" : "string/pretty",
+             text.size());
+  }
+  Measurement m;
+  std::string text;
+  if (!flatbuffers::GenerateText(parser, buffer, &text)) std::abort();
+  m.Report(state, "flatc", text.size());
+}
+BENCHMARK(TextGeneratorSink);
@@ -0,0 +1,109 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "fbjson/verified_buffer.h"
+#include "flatbuffers/reflection.h"
+#include "synthetic.h"
+#include "test_generated.h"
+
+// End-to-end conversion of 10000 small `fbt.tStrInt` records and of 1000
+// `fbt.tIntVInt` documents with 64 integers, reading one field of each:
+// - verify/generated: `Parser::Parse`, `Release`, then a
+//   `flatbuffers::Verifier` pass with the generated `VerifyBuffer<T>`, as
+//   the research tests do;
+// - verify/reflection: the same with `flatbuffers::Verify` and the binary
+//   schema, as the verify stage of `ConversionPipeline` does;
+// - verified: `ParseVerified`, the buffer is read without verification.
+
+namespace {
+
+template<typename T> struct Documents {
+  const char *root_type;
+  std::vector<std::string> json;
+  size_t bytes = 0;
+};
+
+std::string IntVectorJson(size_t seed) {
+  std::string json = R"({"f1": )" + std::to_string(seed) + R"(, "f2": [)";
+  for (size_t i = 0; i < 64; i++) {
+    if (i) json += ", ";
+    json += std::to_string((i + seed) * 7919 % 100003);
+  }
+  return json + "]}";
+}
+
+template<typename T>
+void Convert(bench::State &state, const std::string &prefix,
+             const Documents<T> &docs, const reflection::Schema &schema) {
+  auto parser = bench::TestSchemaParser(docs.root_type);
+  if (!parser) return state.SkipWithError("can't load test.fbs");
+  const auto object = schema.objects()->LookupByKey(docs.root_type);
+  if (!object) return state.SkipWithError("no root type in the schema");
+
+  state.Run(
+      prefix + "verify/generated",
+      [&] {
+        for (const auto &json : docs.json) {
+          if (!parser->Parse(json.c_str())) std::abort();
+          const auto buf = parser->builder_.Release();
+          flatbuffers::Verifier verifier(buf.data(), buf.size());
+          if (!verifier.VerifyBuffer<T>()) std::abort();
+          bench::DoNotOptimize(flatbuffers::GetRoot<T>(buf.data())->f1());
+        }
+      },
+      docs.bytes, docs.json.size());
+  state.Run(
+      prefix + "verify/reflection",
+      [&] {
+        for (const auto &json : docs.json) {
+          if (!parser->Parse(json.c_str())) std::abort();
+          const auto buf = parser->builder_.Release();
+          if (!flatbuffers::Verify(schema, *object, buf.data(), buf.size())) {
+            std::abort();
+          }
+          bench::DoNotOptimize(flatbuffers::GetRoot<T>(buf.data())->f1());
+        }
+      },
+      docs.bytes, docs.json.size());
+  fbjson::VerifiedBuffer buffer;
+  state.Run(
+      prefix + "verified",
+      [&] {
+        for (const auto &json : docs.json) {
+          if (!fbjson::ParseVerified(parser.get(), json.c_str(), &buffer)) {
+            std::abort();
+          }
+          bench::DoNotOptimize(buffer.GetRoot<T>()->f1());
+        }
+      },
+      docs.bytes, docs.json.size());
+}
+
+}  // namespace
+
+static void VerifiedBufferConvert(bench::State &state) {
+  // binary schema for `flatbuffers::Verify`, as `ConversionPipeline` does
+  auto schema_parser = bench::TestSchemaParser("fbt.tStrInt");
+  if (!schema_parser) return state.SkipWithError("can't load test.fbs");
+  schema_parser->Serialize();
+  const auto &schema =
+      *reflection::GetSchema(schema_parser->builder_.GetBufferPointer());
+
+  Documents<fbt::tStrInt> records;
+  records.root_type = "fbt.tStrInt";
+  for (size_t i = 0; i < 10000; i++) {
+    records.json.push_back(bench::RecordJson(i));
+    records.bytes += records.json.back().size();
+  }
+  Convert(state, "records/", records, schema);
+
+  Documents<fbt::tIntVInt> vectors;
+  vectors.root_type = "fbt.tIntVInt";
+  for (size_t i = 0; i < 1000; i++) {
+    vectors.json.push_back(IntVectorJson(i));
+    vectors.bytes += vectors.json.back().size();
+  }
+  Convert(state, "vectors/", vectors, schema);
+}
+BENCHMARK(VerifiedBufferConvert);
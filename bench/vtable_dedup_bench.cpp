@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <string>
+#include "bench.h"
+#include "fbjson/meta_parser.h"
+#include "records_meta_generated.h"
+
+// Time per table for vectors of 10^3..10^7 tables parsed by `MetaParser`
+// with linear and hash-indexed vtable deduplication. `Small` tables share
+// one vtable, `Sparse` tables have up to 4096 different vtables.
+
+namespace {
+
+std::string TablesJson(bool sparse, size_t count) {
+  std::string json = sparse ? R"({"sparse": [)" : R"({"small": [)";
+  for (size_t i = 0; i < count; i++) {
+    if (i) json += ",";
+    if (!sparse) {
+      json += R"({"value": )" + std::to_string(i % 1000 + 1) + "}";
+      continue;
+    }
+    // fields present are the bits of a pseudo-random 12-bit shape
+    const auto shape = (i * 2654435761u >> 8) & 0xfff;
+    json += "{";
+    for (size_t f = 0, n = 0; f < 12; f++) {
+      if (!((shape >> f) & 1)) continue;
+      json += (n++ ? R"(,"f)" : R"("f)") + std::to_string(f) + R"(":1)";
+    }
+    json += "}";
+  }
+  return json + "]}";
+}
+
+}  // namespace
+
+static void VtableDedupTables(bench::State &state) {
+  using fbjson::VtableDedup;
+  const auto root = static_cast<int>(records::meta::TableIndex::Tables);
+  for (const auto sparse : { false, true }) {
+    for (size_t count = 1000; count <= 10000000; count *= 10) {
+      const auto json = TablesJson(sparse, count);
+      for (const auto mode : { VtableDedup::kLinear, VtableDedup::kHash }) {
+        // the linear search is quadratic for many shapes
+        if (sparse && mode == VtableDedup::kLinear && count > 100000) {
+          continue;
+        }
+        fbjson::MetaParserOptions opts;
+        opts.vtable_dedup = mode;
+        fbjson::MetaParser parser(records::meta::kSchema, opts);
+        const auto label = std::string(sparse ? "sparse/" : "small/") +
+                           (mode == VtableDedup::kHash ? "hash/" : "linear/") +
+                           std::to_string(count);
+        auto &sample = state.Run(
+            label,
+            [&] {
+              if (!parser.Parse(json.c_str(), root)) std::abort();
+            },
+            json.size(), count);
+        sample.counters.emplace_back(
+            "ns_per_table", sample.seconds * 1e9 / sample.items);
+        sample.counters.emplace_back("index_bytes",
+                                     parser.builder_.VtableIndexMemory());
+      }
+    }
+  }
+}
+BENCHMARK(VtableDedupTables);
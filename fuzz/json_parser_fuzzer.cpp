@@ -0,0 +1,178 @@
+// Persistent-mode fuzz target for the JSON parser.
+// One `flatbuffers::Parser` with `tests/test.fbs` is warmed up once and
+// reused for every input, the schema is never parsed again. Input which
+// isn't a JSON document is skipped, as it could change the parser state.
+// The root type is chosen from the input size.
+// Each accepted input goes through the check of `ParserPrintDecodePrintTest`:
+// parse, `GenerateText`, parse the text again and compare both texts.
+//
+// Built with `-fsanitize=fuzzer` this is a libFuzzer target, AFL++ runs the
+// same entry points in persistent mode (`afl-clang-fast++ -fsanitize=fuzzer`).
+// With `FBJSON_FUZZ_STANDALONE` defined it gets a `main` which replays
+// files and directories and reports execs/s.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fbjson/options.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+
+namespace {
+
+// Input which `Parser::Parse` reads as a JSON document only: it starts with
+// the root value, and the parser requires the end of input after it.
+// Anything else may add declarations or change the namespace, attributes,
+// root type, file identifier or extension, even if parsing then fails.
+bool IsJsonDocument(const std::string &input) {
+  const auto start = input.find_first_not_of(" \t\r\n");
+  return start != std::string::npos &&
+         (input[start] == '{' || input[start] == '[');
+}
+
+class Target {
+ public:
+  Target() {
+    if (!flatbuffers::LoadFile(FLATBUFFERS_FBS_DIR "test.fbs", false,
+                               &schema_)) {
+      std::fprintf(stderr, "can't load test.fbs\n");
+      std::abort();
+    }
+    Warm();
+  }
+
+  void Run(const uint8_t *data, size_t size) {
+    // `Parse` needs a zero-terminated string
+    input_.assign(reinterpret_cast<const char *>(data), size);
+    if (!IsJsonDocument(input_)) return;
+    const auto root = roots_[size % roots_.size()].c_str();
+    if (!parser_->SetRootType(root)) std::abort();
+    if (parser_->Parse(input_.c_str()) && parser_->builder_.GetSize()) {
+      Check();
+    }
+  }
+
+ private:
+  void Warm() {
+    parser_.reset(new flatbuffers::Parser(fbjson::StrictJsonOptions()));
+    if (!parser_->Parse(schema_.c_str())) std::abort();
+    roots_.clear();
+    for (const auto sd : parser_->structs_.vec) {
+      if (!sd->fixed) {
+        roots_.push_back(sd->defined_namespace->GetFullyQualifiedName(
+            sd->name));
+      }
+    }
+  }
+
+  void Check() {
+    std::string text_1;
+    if (!flatbuffers::GenerateText(
+            *parser_, parser_->builder_.GetBufferPointer(), &text_1)) {
+      std::abort();
+    }
+    if (!parser_->Parse(text_1.c_str())) {
+      std::fprintf(stderr, "can't parse generated text: %s\n%s\n",
+                   parser_->error_.c_str(), text_1.c_str());
+      std::abort();
+    }
+    std::string text_2;
+    if (!flatbuffers::GenerateText(
+            *parser_, parser_->builder_.GetBufferPointer(), &text_2)) {
+      std::abort();
+    }
+    // case-insensitive, like ASSERT_STRCASEEQ in the test
+    if (text_1.size() != text_2.size() ||
+        !std::equal(text_1.begin(), text_1.end(), text_2.begin(),
+                    [](char a, char b) {
+                      return std::tolower(static_cast<unsigned char>(a)) ==
+                             std::tolower(static_cast<unsigned char>(b));
+                    })) {
+      std::fprintf(stderr, "texts differ:\n%s\n%s\n", text_1.c_str(),
+                   text_2.c_str());
+      std::abort();
+    }
+  }
+
+  std::string schema_;
+  std::unique_ptr<flatbuffers::Parser> parser_;
+  std::vector<std::string> roots_;
+  std::string input_;
+};
+
+Target *target = nullptr;
+
+}  // namespace
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***) {
+  target = new Target();
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (!target) LLVMFuzzerInitialize(nullptr, nullptr);
+  target->Run(data, size);
+  return 0;
+}
+
+#ifdef FBJSON_FUZZ_STANDALONE
+#include <chrono>
+#include <filesystem>
+
+// Usage: json_parser_fuzz_replay [-runs=N] (file | directory)...
+// Replays every input N times (1 by default) and prints execs/s.
+int main(int argc, char **argv) {
+  namespace fs = std::filesystem;
+  size_t runs = 1;
+  std::vector<std::string> inputs;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg.compare(0, 6, "-runs=") == 0) {
+      runs = std::strtoul(arg.c_str() + 6, nullptr, 10);
+      continue;
+    }
+    std::error_code ec;
+    if (fs::is_directory(arg, ec)) {
+      for (const auto &entry : fs::recursive_directory_iterator(arg, ec)) {
+        if (entry.is_regular_file()) inputs.push_back(entry.path().string());
+      }
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  std::vector<std::string> corpus;
+  for (const auto &path : inputs) {
+    std::string data;
+    if (!flatbuffers::LoadFile(path.c_str(), true, &data)) {
+      std::fprintf(stderr, "can't read %s\n", path.c_str());
+      return 1;
+    }
+    corpus.push_back(std::move(data));
+  }
+  const auto init_start = std::chrono::steady_clock::now();
+  LLVMFuzzerInitialize(&argc, &argv);
+  const std::chrono::duration<double> init =
+      std::chrono::steady_clock::now() - init_start;
+  size_t execs = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < runs; r++) {
+    for (const auto &data : corpus) {
+      LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(data.data()),
+                             data.size());
+      execs++;
+    }
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::printf("%zu inputs, %zu execs in %.3f s: %.0f execs/s",
+              corpus.size(), execs, elapsed.count(),
+              execs / std::max(elapsed.count(), 1e-9));
+  std::printf(" (startup %.3f ms)\n", init.count() * 1e3);
+  return 0;
+}
+#endif  // FBJSON_FUZZ_STANDALONE
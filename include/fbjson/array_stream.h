@@ -0,0 +1,115 @@
+#ifndef FBJSON_ARRAY_STREAM_H_
+#define FBJSON_ARRAY_STREAM_H_
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "fbjson/json_scanner.h"
+#include "flatbuffers/idl.h"
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#  include "fbjson/generator.h"
+#endif
+
+namespace fbjson {
+
+// Push-style parser for a document whose root value is an array of tables,
+// e.g. a bulk export `[{...}, {...}, ...]`. Every element is parsed into
+// `parser->builder_` as its own FlatBuffer of the parser's root type as soon
+// as the element closes, so only the element being received is buffered.
+// The parser must have a schema with a root type loaded.
+class ArrayStreamParser {
+ public:
+  enum class Status {
+    // Push more data or call `Finish()`.
+    kNeedMoreData,
+    // An element is finished in `parser->builder_`. Take it before the next
+    // call, then push the rest of the chunk.
+    kElement,
+    // The array is closed, the rest of the input is ignored.
+    kDone,
+    // Syntax or schema error, see `error()`.
+    kError
+  };
+
+  explicit ArrayStreamParser(flatbuffers::Parser *parser) : parser_(parser) {}
+
+  // Push the next chunk of input. `*consumed` is the number of bytes used,
+  // it is less than `size` only if an element is finished.
+  Status Feed(const char *data, size_t size, size_t *consumed);
+
+  // Signal the end of input. An unclosed array is an error.
+  Status Finish();
+
+  // Prepare for the next document.
+  void Reset();
+
+  const std::string &error() const { return error_; }
+  // Elements finished so far.
+  size_t elements() const { return elements_; }
+  // Bytes of the current element buffered so far.
+  size_t buffered() const { return element_.size(); }
+
+ private:
+  enum class State { kBeforeArray, kBeforeElement, kElement, kAfterElement,
+                     kDone, kError };
+
+  Status Fail(const std::string &message);
+
+  flatbuffers::Parser *parser_;
+  JsonScanner scanner_;
+  State state_ = State::kBeforeArray;
+  // an element may be omitted only before the first one
+  bool after_comma_ = false;
+  std::string element_;
+  size_t elements_ = 0;
+  std::string error_;
+};
+
+// Reads up to `size` bytes into `buf`, returns 0 at the end of input.
+using ChunkReader = std::function<size_t(char *buf, size_t size)>;
+
+// `ChunkReader` for a file opened for reading.
+ChunkReader FileChunkReader(std::FILE *file);
+
+#ifdef FBJSON_HAS_COROUTINES
+// Lazily parse a root array read through `read`: yields one FlatBuffer per
+// element as soon as the element closes. At most one chunk and one element
+// are held in memory. On a syntax or schema error the sequence ends early
+// and `*error` is set; it is empty after a successful run.
+// `parser`, `read` and `error` must outlive the generator.
+inline Generator<flatbuffers::DetachedBuffer> ParseArrayElements(
+    flatbuffers::Parser *parser, ChunkReader read, std::string *error,
+    size_t chunk_size = 64 * 1024) {
+  error->clear();
+  ArrayStreamParser stream(parser);
+  std::vector<char> chunk(chunk_size);
+  for (;;) {
+    const auto size = read(chunk.data(), chunk.size());
+    if (!size) {
+      if (stream.Finish() == ArrayStreamParser::Status::kError) {
+        *error = stream.error();
+      }
+      co_return;
+    }
+    for (size_t pos = 0; pos < size;) {
+      size_t consumed = 0;
+      const auto status = stream.Feed(chunk.data() + pos, size - pos,
+                                      &consumed);
+      pos += consumed;
+      if (status == ArrayStreamParser::Status::kElement) {
+        co_yield parser->builder_.Release();
+      } else if (status == ArrayStreamParser::Status::kDone) {
+        co_return;
+      } else if (status == ArrayStreamParser::Status::kError) {
+        *error = stream.error();
+        co_return;
+      }
+    }
+  }
+}
+#endif  // FBJSON_HAS_COROUTINES
+
+}  // namespace fbjson
+
+#endif  // FBJSON_ARRAY_STREAM_H_
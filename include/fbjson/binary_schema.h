@@ -0,0 +1,19 @@
+#ifndef FBJSON_BINARY_SCHEMA_H_
+#define FBJSON_BINARY_SCHEMA_H_
+
+#include <string>
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Load type definitions from a binary schema (`.bfbs`, `reflection::Schema`)
+// into an empty parser, so JSON can be parsed without the text `.fbs` files.
+// Root type, file identifier and extension are taken from the binary schema.
+// The parser can still be extended by text declarations (e.g. `root_type`).
+// Returns false and fills `error` if the buffer isn't a valid schema.
+bool LoadBinarySchema(const uint8_t *bfbs, size_t size,
+                      flatbuffers::Parser *parser, std::string *error);
+
+}  // namespace fbjson
+
+#endif  // FBJSON_BINARY_SCHEMA_H_
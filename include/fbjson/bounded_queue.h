@@ -0,0 +1,97 @@
+#ifndef FBJSON_BOUNDED_QUEUE_H_
+#define FBJSON_BOUNDED_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace fbjson {
+
+// Bounded multi-producer multi-consumer lock-free queue (D. Vyukov's ring of
+// sequenced cells). Each cell carries a sequence number which tells producers
+// and consumers whether it is free for the current lap, so a push or pop is
+// one CAS on the shared index plus one store to the cell.
+// `TryPush` and `TryPop` never block; callers decide how to wait.
+template<typename T> class BoundedQueue {
+ public:
+  // The capacity is rounded up to a power of two.
+  explicit BoundedQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    mask_ = size - 1;
+    cells_.reset(new Cell[size]);
+    for (size_t i = 0; i < size; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  // Returns false if the queue is full, `value` is left untouched then.
+  bool TryPush(T &&value) {
+    auto pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto &cell = cells_[pos & mask_];
+      const auto seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns false if the queue is empty.
+  bool TryPop(T *value) {
+    auto pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto &cell = cells_[pos & mask_];
+      const auto seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          *value = std::move(cell.value);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  // Producers and consumers touch different cache lines.
+  alignas(64) std::atomic<size_t> head_;
+  alignas(64) std::atomic<size_t> tail_;
+  alignas(64) size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_BOUNDED_QUEUE_H_
@@ -0,0 +1,70 @@
+#ifndef FBJSON_BUFFER_POOL_H_
+#define FBJSON_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include "flatbuffers/flatbuffers.h"
+
+namespace fbjson {
+
+struct BufferPoolOptions {
+  // Smallest size class, sizes are rounded up to a power of two.
+  size_t min_size = 1024;
+  // Larger buffers bypass the pool.
+  size_t max_size = size_t(64) << 20;
+  // Free buffers kept for reuse, the rest goes back to the heap.
+  size_t max_cached_bytes = size_t(64) << 20;
+  // Back buffers with 2 MiB huge pages. Larger classes map each buffer on
+  // its own and unmap it when the cache is full. Smaller classes are carved
+  // from huge-page slabs, which stay mapped until the pool is destroyed:
+  // their buffers are always cached, so they can take the cache above
+  // `max_cached_bytes` up to the peak memory in use.
+  bool huge_pages = false;
+};
+
+// Thread-safe allocator for `FlatBufferBuilder` which recycles buffers.
+// A `DetachedBuffer` released by a builder using the pool returns its memory
+// to the pool when the consumer destroys it, so a producer converting
+// documents at a high rate reuses the same buffers instead of allocating.
+// The pool must outlive all builders and buffers allocated from it.
+class BufferPool : public flatbuffers::Allocator {
+ public:
+  struct Stats {
+    // Allocations served from free buffers.
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t cached_bytes = 0;
+    size_t mapped_bytes = 0;
+  };
+
+  explicit BufferPool(BufferPoolOptions options = BufferPoolOptions());
+  ~BufferPool() override;
+
+  uint8_t *allocate(size_t size) override;
+  void deallocate(uint8_t *p, size_t size) override;
+
+  Stats stats() const;
+  const BufferPoolOptions &options() const { return options_; }
+
+ private:
+  struct SizeClass {
+    size_t size;
+    std::vector<uint8_t *> free;
+  };
+
+  // Index of the class for `size`, or -1 if it isn't pooled.
+  int ClassIndex(size_t size) const;
+  uint8_t *Map(size_t size);
+  void Unmap(uint8_t *p);
+
+  const BufferPoolOptions options_;
+  mutable std::mutex mutex_;
+  std::vector<SizeClass> classes_;
+  std::vector<std::pair<void *, size_t>> mappings_;
+  Stats stats_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_BUFFER_POOL_H_
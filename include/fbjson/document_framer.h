@@ -0,0 +1,63 @@
+#ifndef FBJSON_DOCUMENT_FRAMER_H_
+#define FBJSON_DOCUMENT_FRAMER_H_
+
+#include <string>
+#include "fbjson/json_scanner.h"
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Push-style framing of JSON documents which arrive in chunks.
+// Chunks are scanned as they arrive to find where the root value closes, so
+// readers don't need to frame messages themselves, and an incomplete
+// document is told apart from a syntax error.
+// This is not an incremental parser: `flatbuffers::Parser` can't be suspended
+// inside a value, so every document is buffered in full (see `buffered()`)
+// and handed to `Parser::Parse` in one call once it closes. Memory use and
+// latency are those of buffering complete messages; the saving is only the
+// framing. After an error `parser->builder_` is cleared.
+// The parser must have a schema with a root type loaded.
+class DocumentFramer {
+ public:
+  enum class Status {
+    // The document is incomplete, push more data or call `Finish()`.
+    kNeedMoreData,
+    // The FlatBuffer is finished.
+    kDone,
+    // Syntax or schema error, see `error()`.
+    kError
+  };
+
+  explicit DocumentFramer(flatbuffers::Parser *parser) : parser_(parser) {}
+
+  // Push the next chunk of input.
+  // `*consumed` is the number of bytes of this chunk which belong to the
+  // document. Once `kDone` or `kError` is returned, the parser ignores input
+  // until `Reset()`; the rest of the chunk is the start of the next message.
+  Status Feed(const char *data, size_t size, size_t *consumed = nullptr);
+
+  // Signal the end of input. An unfinished document is an error.
+  Status Finish();
+
+  // Prepare for the next document.
+  void Reset();
+
+  Status status() const { return status_; }
+  const std::string &error() const { return error_; }
+  // Bytes of the current document buffered so far.
+  size_t buffered() const { return buffer_.size(); }
+
+ private:
+  Status Complete();
+  Status Fail(const char *fallback_error);
+
+  flatbuffers::Parser *parser_;
+  JsonScanner scanner_;
+  std::string buffer_;
+  Status status_ = Status::kNeedMoreData;
+  std::string error_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_DOCUMENT_FRAMER_H_
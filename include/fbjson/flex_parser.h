@@ -0,0 +1,63 @@
+#ifndef FBJSON_FLEX_PARSER_H_
+#define FBJSON_FLEX_PARSER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "flatbuffers/flexbuffers.h"
+
+namespace fbjson {
+
+// Schemaless JSON parser which builds FlexBuffers, for documents without a
+// schema. Accepts strict JSON (RFC 8259) only: no comments, trailing commas,
+// single quotes or unquoted keys. Integers are stored as `Int`, or `UInt`
+// above the int64 range; other numbers as `Double`. For duplicate keys the
+// first value is kept (FlexBuffers maps can't hold duplicates), and keys end
+// at an escaped NUL since FlexBuffers keys are C strings.
+// Faster than `flatbuffers::Parser::ParseFlexBuffer`, which tokenizes with
+// the schema grammar.
+class FlexParser {
+ public:
+  explicit FlexParser(
+      flexbuffers::BuilderFlag flags = flexbuffers::BUILDER_FLAG_SHARE_KEYS)
+      : builder_(1024, flags) {}
+
+  // Parse a whole document into `builder_` and finish it.
+  // Returns false and sets `error_` on failure.
+  bool Parse(const char *json);
+
+  // Add the value at `json` to `builder_` without finishing it: as an entry
+  // of an open map if `key` is set, otherwise as a vector element or the
+  // root. `json` must be zero-terminated somewhere after the value.
+  // Returns the position after the value, or nullptr on failure.
+  const char *ParseValue(const char *json, const char *key = nullptr);
+
+  flexbuffers::Builder builder_;
+  std::string error_;
+
+ private:
+  // With a null `b` values are only validated (values of duplicate keys).
+  bool Value(flexbuffers::Builder *b, const char *key);
+  bool Object(flexbuffers::Builder *b, const char *key);
+  bool Array(flexbuffers::Builder *b, const char *key);
+  bool Number(flexbuffers::Builder *b, const char *key);
+  bool String(std::string *out);
+  void SkipWhitespace();
+  bool Error(const std::string &message);
+
+  const char *cursor_ = nullptr;
+  int depth_ = 0;
+  // keys of the open objects, `key_hashes_` runs parallel
+  std::vector<std::string> keys_;
+  std::vector<uint32_t> key_hashes_;
+  std::string string_;
+};
+
+// Print a FlexBuffer as strict JSON. Doubles are printed with 17 digits, so
+// `FlexParser` reads back the same value; blobs are printed as arrays of
+// bytes. Returns false for values without a JSON form (non-finite numbers).
+bool FlexToJson(flexbuffers::Reference value, std::string *json);
+
+}  // namespace fbjson
+
+#endif  // FBJSON_FLEX_PARSER_H_
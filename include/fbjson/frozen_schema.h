@@ -0,0 +1,87 @@
+#ifndef FBJSON_FROZEN_SCHEMA_H_
+#define FBJSON_FROZEN_SCHEMA_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "fbjson/meta.h"
+#include "fbjson/symbol_index.h"
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Heap bytes of the schema metadata held by a parser, by kind. Sizes of
+// strings and map nodes follow the libstdc++ layout; allocator overhead
+// isn't counted.
+struct SchemaMemory {
+  // `StructDef`s and `EnumDef`s with their `EnumVal`s
+  size_t structs = 0;
+  size_t enums = 0;
+  size_t fields = 0;
+  // doc comments of all definitions
+  size_t docs = 0;
+  // attributes of all definitions with their values
+  size_t attributes = 0;
+  // names, file names, default values and namespaces
+  size_t strings = 0;
+  // symbol tables of the parser and of the definitions (nodes and keys)
+  size_t symbols = 0;
+
+  size_t total() const {
+    return structs + enums + fields + docs + attributes + strings + symbols;
+  }
+};
+
+SchemaMemory MeasureSchema(const flatbuffers::Parser &parser);
+
+// Metadata kind of a value of type `type` with base type `base_type`
+// (`type.base_type`, or `type.element` for vector elements).
+meta::Kind ToMetaKind(const flatbuffers::Type &type,
+                      flatbuffers::BaseType base_type);
+
+// Read-only table metadata of a parser (`fbjson/meta.h`), built at runtime
+// in one allocation: the same tables `fbs_meta` generates at compile time.
+// Only what `MetaParser` needs to parse JSON is kept; doc comments,
+// attributes, enums, structs, namespaces and symbol maps are dropped, and
+// the parser can be destroyed once frozen. Up to 32767 tables, the range
+// of `meta::Field::table`, and 65535 fields per table; a larger schema
+// isn't frozen and sets `error()`, `schema()` has no tables then.
+// Tables and fields are found by name through a `SymbolIndex` of their
+// names, kept after the parser is destroyed.
+// `MetaParser` refers to `schema()`, which must outlive it.
+class FrozenSchema {
+ public:
+  explicit FrozenSchema(const flatbuffers::Parser &parser);
+
+  FrozenSchema(const FrozenSchema &) = delete;
+  FrozenSchema &operator=(const FrozenSchema &) = delete;
+
+  bool ok() const { return error_.empty(); }
+  const std::string &error() const { return error_; }
+
+  const meta::Schema &schema() const { return schema_; }
+
+  // Index of a table by fully qualified name, -1 if there is none.
+  int FindTable(const char *name) const;
+  // Index of a field in `schema().tables[table].fields`, -1 if there is
+  // none.
+  int FindField(int table, const char *name) const;
+
+  // Bytes held by the frozen schema and its name index.
+  size_t MemoryUsage() const {
+    return sizeof(*this) + size_ + (index_ ? index_->MemoryUsage() : 0);
+  }
+
+ private:
+  // tables, fields, field indices by hash, then names
+  std::unique_ptr<char[]> arena_;
+  size_t size_ = 0;
+  meta::Schema schema_;
+  // table and field names, nullptr if the schema isn't frozen
+  std::unique_ptr<const SymbolIndex> index_;
+  std::string error_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_FROZEN_SCHEMA_H_
@@ -0,0 +1,108 @@
+#ifndef FBJSON_GENERATOR_H_
+#define FBJSON_GENERATOR_H_
+
+// Minimal C++20 coroutine generator, available if the compiler supports
+// coroutines (`FBJSON_HAS_COROUTINES` is defined then).
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#  include <coroutine>
+#  include <exception>
+#  include <iterator>
+#  include <utility>
+
+#  define FBJSON_HAS_COROUTINES 1
+
+namespace fbjson {
+
+// Lazy sequence of `T` produced by `co_yield`, single pass.
+// The coroutine runs until the next `co_yield` each time the iterator is
+// advanced; the yielded value is moved into the generator, so `T` may be
+// move-only.
+template<typename T> class Generator {
+ public:
+  struct promise_type {
+    T value;
+    std::exception_ptr exception;
+
+    Generator get_return_object() {
+      return Generator(Handle::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    std::suspend_always yield_value(T v) {
+      value = std::move(v);
+      return {};
+    }
+    void return_void() {}
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    iterator() = default;
+    explicit iterator(Handle handle) : handle_(handle) {}
+
+    T &operator*() const { return handle_.promise().value; }
+    T *operator->() const { return &handle_.promise().value; }
+    iterator &operator++() {
+      Resume(handle_);
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+    bool operator==(std::default_sentinel_t) const {
+      return !handle_ || handle_.done();
+    }
+
+   private:
+    Handle handle_;
+  };
+
+  Generator(Generator &&other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  Generator &operator=(Generator &&other) noexcept {
+    if (this != &other) {
+      if (handle_) handle_.destroy();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  Generator(const Generator &) = delete;
+  Generator &operator=(const Generator &) = delete;
+  ~Generator() {
+    if (handle_) handle_.destroy();
+  }
+
+  // Runs the coroutine to the first element.
+  iterator begin() {
+    Resume(handle_);
+    return iterator(handle_);
+  }
+  std::default_sentinel_t end() const { return {}; }
+
+ private:
+  explicit Generator(Handle handle) : handle_(handle) {}
+
+  static void Resume(Handle handle) {
+    handle.resume();
+    if (handle.promise().exception) {
+      std::rethrow_exception(handle.promise().exception);
+    }
+  }
+
+  Handle handle_;
+};
+
+}  // namespace fbjson
+
+#endif  // __cpp_impl_coroutine
+
+#endif  // FBJSON_GENERATOR_H_
@@ -0,0 +1,104 @@
+#ifndef FBJSON_INCLUDE_CACHE_H_
+#define FBJSON_INCLUDE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Declarations of included schema files, shared by the parsers of a process.
+// `flatbuffers::Parser` reads and parses every included `.fbs` file again for
+// each schema and each parser. The cache parses the files included by a
+// schema once, keeps their declarations as a binary schema and loads them
+// into the next parser (`LoadBinarySchema`). The included files are then
+// marked as already parsed, so the parser only reads the schema itself.
+// Entries are keyed by the parser options, the include paths and the files
+// a schema includes directly, and hold every file they include transitively.
+// Before use, an entry is checked against these files by modification time
+// and size, or by a hash of their contents; a changed file rebuilds the
+// entry.
+// Thread-safe.
+class IncludeCache {
+ public:
+  enum class Validation {
+    kModificationTime,
+    kContentHash,
+  };
+
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    // entries rebuilt because an included file changed
+    size_t invalidations = 0;
+  };
+
+  explicit IncludeCache(Validation validation = Validation::kModificationTime)
+      : validation_(validation) {}
+
+  IncludeCache(const IncludeCache &) = delete;
+  IncludeCache &operator=(const IncludeCache &) = delete;
+
+  // Cache of the process.
+  static IncludeCache &Default();
+
+  // Same as `parser->Parse(source, include_paths, source_filename)` on an
+  // empty parser. Schemas without includes, proto files and schemas whose
+  // includes fail to parse go through `Parser::Parse` unchanged, so errors
+  // are reported as without the cache.
+  bool Parse(flatbuffers::Parser *parser, const char *source,
+             const char **include_paths = nullptr,
+             const char *source_filename = nullptr);
+
+  Stats stats() const;
+  size_t size() const;
+  void Clear();
+
+ private:
+  struct File {
+    std::string path;
+    int64_t mtime;
+    uint64_t size;
+    uint64_t hash;
+  };
+
+  struct Entry {
+    // `Parser::Serialize` of the included declarations, with builtin
+    // attributes
+    std::string bfbs;
+    std::vector<File> files;
+    // `Parser::included_files_` and `files_included_per_file_`
+    std::map<std::string, std::string> included_files;
+    std::map<std::string, std::set<std::string>> files_included_per_file;
+    // `attribute` declarations
+    std::map<std::string, bool> known_attributes;
+  };
+
+  // Resolved paths of the leading `include` statements of `source`, in the
+  // way the parser resolves them. False if the statements can't be read
+  // without the parser's lexer.
+  static bool ScanIncludes(const char *source, const char **include_paths,
+                           std::vector<std::string> *names,
+                           std::vector<std::string> *paths);
+  static bool Stat(const std::string &path, File *file);
+  static bool Hash(const std::string &path, File *file);
+  bool IsValid(const Entry &entry) const;
+  std::shared_ptr<const Entry> Build(const flatbuffers::IDLOptions &opts,
+                                     const std::vector<std::string> &names,
+                                     const char **include_paths) const;
+
+  const Validation validation_;
+  mutable std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<const Entry>> entries_;
+  Stats stats_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_INCLUDE_CACHE_H_
@@ -0,0 +1,66 @@
+#ifndef FBJSON_JSON_SCANNER_H_
+#define FBJSON_JSON_SCANNER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fbjson {
+
+// Structural scanner for JSON text.
+// Tracks nesting, string, escape and comment state of the lexer used by
+// `flatbuffers::Parser`, so it can find where the root value ends without
+// decoding values. The state is kept between calls: input can be split at
+// any byte.
+class JsonScanner {
+ public:
+  enum class Status {
+    // The root value isn't closed yet.
+    kNeedMoreData,
+    // The root value is closed.
+    kComplete,
+    // Unbalanced brackets or a string outside of the root value.
+    kError
+  };
+
+  // Scan the next `size` bytes. On `kComplete`, `*consumed` is the number of
+  // bytes up to and including the closing bracket of the root value,
+  // otherwise all bytes are consumed.
+  Status Scan(const char *data, size_t size, size_t *consumed);
+
+  void Reset();
+
+  // True if the opening bracket of the root value has been seen.
+  bool started() const { return !stack_.empty() || state_ == State::kDone; }
+  size_t depth() const { return stack_.size(); }
+  const char *error() const { return error_; }
+
+  // True if `data` contains only whitespace and complete comments.
+  // Any other byte is regarded as the start of the next document.
+  static bool IsBlank(const char *data, size_t size);
+
+ private:
+  enum class State : uint8_t {
+    kValue,
+    kString,
+    kEscape,
+    kSlash,
+    kLineComment,
+    kBlockComment,
+    kBlockCommentStar,
+    kDone,
+    kError
+  };
+
+  Status Fail(const char *error);
+
+  State state_ = State::kValue;
+  char quote_ = 0;
+  // closing brackets of the open containers
+  std::vector<char> stack_;
+  const char *error_ = nullptr;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_JSON_SCANNER_H_
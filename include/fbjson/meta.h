@@ -0,0 +1,117 @@
+#ifndef FBJSON_META_H_
+#define FBJSON_META_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Compile-time schema metadata.
+// `fbs_meta` emits these tables as constexpr arrays (`*_meta_generated.h`)
+// next to the header generated by flatc, so a parser needs no schema
+// structures built at runtime.
+
+namespace fbjson {
+namespace meta {
+
+enum class Kind : uint8_t {
+  kNone,
+  kBool,
+  kByte,
+  kUByte,
+  kShort,
+  kUShort,
+  kInt,
+  kUInt,
+  kLong,
+  kULong,
+  kFloat,
+  kDouble,
+  kString,
+  kTable,
+  kVector,
+  // structs and unions aren't supported by the metadata parser
+  kUnsupported
+};
+
+// Inline size of a value in a table or vector.
+constexpr size_t SizeOf(Kind kind) {
+  return kind == Kind::kBool || kind == Kind::kByte || kind == Kind::kUByte
+             ? 1
+             : kind == Kind::kShort || kind == Kind::kUShort
+                   ? 2
+                   : kind == Kind::kLong || kind == Kind::kULong ||
+                             kind == Kind::kDouble
+                         ? 8
+                         : 4;
+}
+
+constexpr bool IsScalar(Kind kind) {
+  return kind >= Kind::kBool && kind <= Kind::kDouble;
+}
+
+// FNV-1a hash of a field name.
+constexpr uint32_t HashName(const char *name, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+struct Field {
+  uint32_t name_hash;
+  const char *name;
+  uint16_t offset;
+  Kind kind;
+  // element of a vector
+  Kind element;
+  // index of the table for tables and vectors of tables, otherwise -1
+  int16_t table;
+  int64_t default_integer;
+  double default_real;
+  bool required;
+  bool deprecated;
+  // `[ubyte]` with the `flexbuffer` attribute: holds any JSON value
+  bool flexbuffer;
+};
+
+struct Table {
+  const char *name;
+  // fields in declaration order
+  const Field *fields;
+  uint16_t num_fields;
+  // indices of `fields` sorted by `name_hash`
+  const uint16_t *by_hash;
+
+  // Find a field by name, returns nullptr if there is no such field.
+  const Field *Lookup(const char *name, size_t len) const {
+    const auto hash = HashName(name, len);
+    size_t lo = 0, hi = num_fields;
+    while (lo < hi) {
+      const auto mid = (lo + hi) / 2;
+      if (fields[by_hash[mid]].name_hash < hash) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    for (; lo < num_fields && fields[by_hash[lo]].name_hash == hash; lo++) {
+      const auto &f = fields[by_hash[lo]];
+      if (!std::strncmp(f.name, name, len) && !f.name[len]) return &f;
+    }
+    return nullptr;
+  }
+};
+
+struct Schema {
+  const Table *tables;
+  size_t num_tables;
+  // index of the root table or -1
+  int root;
+};
+
+}  // namespace meta
+}  // namespace fbjson
+
+#endif  // FBJSON_META_H_
@@ -0,0 +1,123 @@
+#ifndef FBJSON_META_PARSER_H_
+#define FBJSON_META_PARSER_H_
+
+#include <string>
+#include <vector>
+#include "fbjson/flex_parser.h"
+#include "fbjson/meta.h"
+#include "fbjson/parse_stats.h"
+#include "fbjson/vtable_cache.h"
+#include "flatbuffers/flatbuffers.h"
+
+namespace fbjson {
+
+struct MetaParserOptions {
+  // Store identical string values once, like `CreateSharedString`.
+  bool share_strings = false;
+  VtableDedup vtable_dedup = VtableDedup::kLinear;
+  // Keep unknown fields of tables with a `flexbuffer` field: they are stored
+  // there as a FlexBuffer map of the JSON values instead of being skipped.
+  // The field can't be set explicitly in the same object then.
+  bool keep_unknown_fields = false;
+};
+
+// JSON parser driven by compile-time metadata (`fbjson/meta.h`).
+// Supports tables with scalar, string, table and vector fields, in object
+// or array (positional) form. Unknown fields are skipped unless
+// `keep_unknown_fields` is set. Values of `flexbuffer` fields are parsed by
+// `FlexParser`. Produces the same bytes as `flatbuffers::Parser` for these
+// schemas, except inside FlexBuffers where the encoding of numbers may
+// differ.
+class MetaParser {
+ public:
+  explicit MetaParser(const meta::Schema &schema,
+                      MetaParserOptions options = MetaParserOptions())
+      : opts(options), schema_(schema) {}
+
+  // Parse `json` as table `root` (`-1` for the schema's root) into
+  // `builder_`. Returns false and sets `error_` on failure.
+  bool Parse(const char *json, int root = -1,
+             const char *file_identifier = nullptr);
+
+  // Build only these fields, given as "<table>.<field>" with the fully
+  // qualified table name, e.g. "fbt.tStrIntInt.f1". Tables without listed
+  // fields are built in full. Other fields are skipped without decoding
+  // numbers or unescaping strings, so errors inside them go unnoticed.
+  // An empty list builds all fields. Returns false for unknown names.
+  bool SetProjection(const std::vector<std::string> &fields);
+
+  // Memory held by the shared string table.
+  size_t SharedStringsMemory() const {
+    return shared_strings_.capacity() * sizeof(SharedString);
+  }
+
+  MetaParserOptions opts;
+  // Accumulated over `Parse` calls, see `fbjson/parse_stats.h`.
+  ParseStats stats_;
+  VtableCacheBuilder builder_;
+  std::string error_;
+
+ private:
+  struct FieldValue {
+    const meta::Field *field;
+    meta::Kind kind;
+    union {
+      int64_t i;
+      uint64_t u;
+      double d;
+      flatbuffers::uoffset_t o;
+    };
+  };
+
+  // Unknown field kept for the `flexbuffer` field of its table.
+  struct UnknownField {
+    std::string key;
+    // start of the value in the document
+    const char *value;
+  };
+
+  // Slot of the open-addressing table of shared strings, offset 0 is empty.
+  struct SharedString {
+    uint32_t hash;
+    flatbuffers::uoffset_t offset;
+  };
+
+  flatbuffers::uoffset_t CreateSharedString(const std::string &s);
+  bool ParseRoot(const char *json, int root, const char *file_identifier);
+  bool ParseTable(const meta::Table &table, flatbuffers::uoffset_t *out);
+  bool ParseField(const meta::Field &field);
+  bool ParseValue(meta::Kind kind, int table, FieldValue *value);
+  bool ParseVector(const meta::Field &field, flatbuffers::uoffset_t *out);
+  bool ParseScalar(meta::Kind kind, FieldValue *value);
+  // A value of a `flexbuffer` field, or the unknown fields from `base` on.
+  bool ParseFlexBuffer(flatbuffers::uoffset_t *out);
+  bool BuildUnknownFields(size_t base, flatbuffers::uoffset_t *out);
+  bool FinishFlexBuffer(flatbuffers::uoffset_t *out);
+  bool ParseString(std::string *out);
+  // Without `validate` strings are skipped without unescaping.
+  bool SkipValue(bool validate = true);
+  bool SkipString();
+  void SkipWhitespace();
+  bool Expect(char c);
+  bool Error(const std::string &message);
+  void WriteScalar(const FieldValue &value);
+  void PushScalar(const FieldValue &value);
+
+  const meta::Schema &schema_;
+  const char *cursor_ = nullptr;
+  int depth_ = 0;
+  std::vector<FieldValue> stack_;
+  std::string string_;
+  // Per table, fields to build; empty for all fields.
+  std::vector<std::vector<bool>> projection_;
+  std::vector<SharedString> shared_strings_;
+  size_t num_shared_strings_ = 0;
+  // Per table, the `flexbuffer` field or null; empty until first needed.
+  std::vector<const meta::Field *> flexbuffer_fields_;
+  std::vector<UnknownField> unknown_;
+  FlexParser flex_{ flexbuffers::BUILDER_FLAG_SHARE_ALL };
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_META_PARSER_H_
@@ -0,0 +1,19 @@
+#ifndef FBJSON_OPTIONS_H_
+#define FBJSON_OPTIONS_H_
+
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Parser options for JSON input shared by tests, tools and benchmarks:
+// strict JSON, fields unknown to the schema are skipped.
+inline flatbuffers::IDLOptions StrictJsonOptions() {
+  flatbuffers::IDLOptions opts;
+  opts.skip_unexpected_fields_in_json = true;
+  opts.strict_json = true;
+  return opts;
+}
+
+}  // namespace fbjson
+
+#endif  // FBJSON_OPTIONS_H_
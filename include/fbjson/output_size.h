@@ -0,0 +1,75 @@
+#ifndef FBJSON_OUTPUT_SIZE_H_
+#define FBJSON_OUTPUT_SIZE_H_
+
+#include <cstddef>
+#include <unordered_map>
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Heap allocator for `FlatBufferBuilder` which counts buffer growths and the
+// bytes copied by them.
+class CountingAllocator : public flatbuffers::Allocator {
+ public:
+  uint8_t *allocate(size_t size) override;
+  void deallocate(uint8_t *p, size_t size) override;
+  uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                               size_t new_size, size_t in_use_back,
+                               size_t in_use_front) override;
+
+  size_t allocations() const { return allocations_; }
+  size_t grows() const { return grows_; }
+  size_t bytes_copied() const { return bytes_copied_; }
+  void ResetCounters() { allocations_ = grows_ = bytes_copied_ = 0; }
+
+ private:
+  size_t allocations_ = 0;
+  size_t grows_ = 0;
+  size_t bytes_copied_ = 0;
+};
+
+// Estimates the size of the FlatBuffer built from a JSON document, so the
+// builder can reserve it once instead of growing by reallocation.
+// The first estimate for a root type comes from the schema (inline size of
+// fields against the JSON text needed to write them), later ones from the
+// output/input ratio of recent documents of the same root type.
+// Not thread-safe, use one estimator per thread like the parser.
+class OutputSizeEstimator {
+ public:
+  size_t Estimate(const flatbuffers::StructDef &root, size_t json_size);
+
+  // Record the actual output size of a document.
+  void Learn(const flatbuffers::StructDef &root, size_t json_size,
+             size_t output_size);
+
+  // Parse `json` with `parser` into a builder reserved for the estimated
+  // size, then learn from the result. The builder's buffer is kept between
+  // documents while it is large enough and not released, otherwise it is
+  // replaced by one of the estimated size from `allocator` (may be null).
+  // `allocator` must outlive the parser, which keeps using the buffer.
+  bool Parse(flatbuffers::Parser *parser, const char *json, size_t json_size,
+             flatbuffers::Allocator *allocator = nullptr);
+
+ private:
+  struct Ratio {
+    double value = 0;
+    size_t documents = 0;
+  };
+
+  // Buffer of a builder set up by `Parse`: its allocator and a lower bound
+  // of its capacity.
+  struct Reservation {
+    flatbuffers::Allocator *allocator = nullptr;
+    size_t bytes = 0;
+  };
+
+  static double SchemaRatio(const flatbuffers::StructDef &root);
+
+  std::unordered_map<const flatbuffers::StructDef *, Ratio> ratios_;
+  std::unordered_map<const flatbuffers::FlatBufferBuilder *, Reservation>
+      reserved_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_OUTPUT_SIZE_H_
@@ -0,0 +1,75 @@
+#ifndef FBJSON_PARALLEL_ARRAY_H_
+#define FBJSON_PARALLEL_ARRAY_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "fbjson/schema_registry.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Location of an element of a root array, whitespace excluded.
+struct ArrayElement {
+  size_t offset;
+  size_t size;
+};
+
+// Structural prescan of a document whose root value is an array: finds the
+// elements without decoding them. Commas and brackets inside strings are
+// skipped (quotes preceded by an odd number of backslashes are escaped).
+// Only the structure is checked; elements are validated by the parser.
+// Comments and trailing commas are rejected.
+bool SplitArray(const char *json, size_t size,
+                std::vector<ArrayElement> *elements, std::string *error);
+
+// Parser for a large root array of tables which uses several cores: the
+// array is split by `SplitArray`, then the elements are parsed by worker
+// threads into independent FlatBuffers of the schema's root type.
+// Not thread-safe: one document at a time.
+class ParallelArrayParser {
+ public:
+  // Seconds spent in the stages of the last call.
+  struct Timings {
+    double split = 0;
+    double parse = 0;
+    double join = 0;
+  };
+
+  // `schema` must outlive the parser. Parsers for the threads are created
+  // on the first call. `threads` includes the calling thread.
+  ParallelArrayParser(const Schema &schema, size_t threads);
+  ~ParallelArrayParser();
+
+  // One FlatBuffer per element, in array order.
+  // On failure `error()` names the first failed element.
+  bool Parse(const char *json, size_t size,
+             std::vector<flatbuffers::DetachedBuffer> *buffers);
+
+  // Parse, then copy the elements into one FlatBuffer: a table of type
+  // `container_type` whose vector field `field` holds them. The copy runs on
+  // the calling thread.
+  bool ParseJoined(const char *json, size_t size, const char *container_type,
+                   const char *field, flatbuffers::DetachedBuffer *buffer);
+
+  const std::string &error() const { return error_; }
+  const Timings &timings() const { return timings_; }
+  size_t threads() const { return threads_; }
+
+ private:
+  bool Init();
+
+  const Schema &schema_;
+  const size_t threads_;
+  std::vector<std::unique_ptr<flatbuffers::Parser>> parsers_;
+  // binary schema for joining
+  std::string bfbs_;
+  std::vector<ArrayElement> elements_;
+  Timings timings_;
+  std::string error_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_PARALLEL_ARRAY_H_
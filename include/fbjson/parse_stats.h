@@ -0,0 +1,85 @@
+#ifndef FBJSON_PARSE_STATS_H_
+#define FBJSON_PARSE_STATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+namespace fbjson {
+
+// Cycle counters and event counts of parser phases. Filled only when the
+// library is built with `FBJSON_PARSE_STATS` (CMake option of the same
+// name), otherwise the instrumentation compiles to nothing.
+struct ParseStats {
+  enum Phase {
+    // Whitespace, punctuation and token boundaries: the time not spent in
+    // the other phases. Events are the values scanned.
+    kLex,
+    kFieldLookup,
+    kNumber,
+    kString,
+    // Strings, scalars and vectors written to the builder.
+    kBuilder,
+    // Table start and vtable finishing.
+    kVtable,
+    kNumPhases
+  };
+
+  uint64_t cycles[kNumPhases] = {};
+  uint64_t events[kNumPhases] = {};
+
+  void Reset() { *this = ParseStats(); }
+  uint64_t TotalCycles() const;
+  static const char *PhaseName(int phase);
+  // "lex 1234 cycles/56 events (12.3%), field_lookup ..."
+  std::string ToString() const;
+};
+
+// Time stamp counter where available, nanoseconds otherwise.
+inline uint64_t ReadCycleCounter() {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+#ifdef FBJSON_PARSE_STATS
+// Adds the cycles of its lifetime and one event to a phase.
+class ParseStatsScope {
+ public:
+  ParseStatsScope(ParseStats &stats, ParseStats::Phase phase)
+      : stats_(stats), phase_(phase), start_(ReadCycleCounter()) {}
+  ~ParseStatsScope() {
+    stats_.cycles[phase_] += ReadCycleCounter() - start_;
+    stats_.events[phase_]++;
+  }
+
+ private:
+  ParseStats &stats_;
+  ParseStats::Phase phase_;
+  uint64_t start_;
+};
+
+#  define FBJSON_PARSE_STATS_SCOPE(stats, phase)   \
+    ::fbjson::ParseStatsScope parse_stats_scope_( \
+        stats, ::fbjson::ParseStats::phase)
+#  define FBJSON_PARSE_STATS_EVENT(stats, phase) \
+    (stats).events[::fbjson::ParseStats::phase]++
+#else
+#  define FBJSON_PARSE_STATS_SCOPE(stats, phase) (void)0
+#  define FBJSON_PARSE_STATS_EVENT(stats, phase) (void)0
+#endif
+
+}  // namespace fbjson
+
+#endif  // FBJSON_PARSE_STATS_H_
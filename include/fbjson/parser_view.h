@@ -0,0 +1,56 @@
+#ifndef FBJSON_PARSER_VIEW_H_
+#define FBJSON_PARSER_VIEW_H_
+
+#include "fbjson/symbol_index.h"
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// JSON parser which shares the type definitions of a base parser and has its
+// own options (`strict_json`, `skip_unexpected_fields_in_json`, ...) and
+// builder. Creating a view copies no definitions, but it does copy the
+// enum symbol table (the name map and the pointer vector), which costs a
+// map node per enum; this is how `flatbuffers::Parser` borrows enums to
+// parse nested FlatBuffers. Tables are only reached through the root type
+// and the fields.
+// Only JSON is parsed through a view; the root type is selected with
+// `SetRootType`. The base parser must outlive its views and must not parse
+// declarations while they exist. Views of one base may parse on different
+// threads, each view on one thread at a time.
+// Views of a large schema which select root types by name can share one
+// `SymbolIndex` of the base instead of walking its `std::map` of structs.
+class ParserView {
+ public:
+  // Starts with the root type, file identifier and extension of `base`.
+  // `index`, if any, indexes `base` and must outlive the view.
+  ParserView(const flatbuffers::Parser &base,
+             const flatbuffers::IDLOptions &opts,
+             const SymbolIndex *index = nullptr);
+  ~ParserView();
+
+  ParserView(const ParserView &) = delete;
+  ParserView &operator=(const ParserView &) = delete;
+
+  // Select the root type by fully qualified name. Unlike
+  // `Parser::SetRootType`, the shared definitions aren't modified.
+  bool SetRootType(const char *name);
+
+  // Parse JSON into `parser().builder_`, returns false and sets
+  // `parser().error_` on failure. Input other than a JSON object or array
+  // (e.g. declarations) is rejected: definitions would be added to the
+  // borrowed tables.
+  bool Parse(const char *json, const char *source_filename = nullptr);
+
+  // For `GenerateText`, the builder and the error message.
+  flatbuffers::Parser &parser() { return parser_; }
+  const flatbuffers::Parser &parser() const { return parser_; }
+
+ private:
+  const flatbuffers::Parser &base_;
+  const SymbolIndex *index_;
+  flatbuffers::Parser parser_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_PARSER_VIEW_H_
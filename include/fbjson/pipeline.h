@@ -0,0 +1,87 @@
+#ifndef FBJSON_PIPELINE_H_
+#define FBJSON_PIPELINE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "fbjson/schema_registry.h"
+
+namespace fbjson {
+
+struct PipelineOptions {
+  // Threads of each stage.
+  size_t read_threads = 1;
+  size_t parse_threads = 1;
+  size_t verify_threads = 1;
+  size_t write_threads = 1;
+  // Capacity of each queue between two stages.
+  size_t queue_capacity = 64;
+  // Check produced buffers against the binary schema.
+  // The verify stage is skipped if disabled.
+  bool verify = true;
+  // Directory for `<file stem>.<schema file_extension>` outputs. Inputs
+  // with the same stem write the same output, the caller must keep stems
+  // unique. If empty, the write stage only drops the buffers.
+  std::string output_dir;
+};
+
+struct PipelineStats {
+  enum Stage { kRead, kParse, kVerify, kWrite, kNumStages };
+
+  struct StageStats {
+    size_t threads = 0;
+    size_t items = 0;
+    // Time spent processing items, summed over threads.
+    double busy_seconds = 0;
+    // Back-pressure: pushes which found the output queue full, and the time
+    // spent waiting for a free cell.
+    size_t full_waits = 0;
+    double blocked_seconds = 0;
+    // Starvation: pops which found the input queue empty, and the time spent
+    // waiting for an item.
+    size_t empty_waits = 0;
+    double idle_seconds = 0;
+
+    // Fraction of the wall time the stage threads were busy.
+    double Utilization(double wall_seconds) const;
+  };
+
+  size_t files = 0;
+  size_t failed = 0;
+  size_t input_bytes = 0;
+  size_t output_bytes = 0;
+  double seconds = 0;
+  StageStats stages[kNumStages];
+
+  static const char *StageName(Stage stage);
+  // Throughput and a table of stage counters.
+  std::string ToString() const;
+};
+
+// Staged JSON to FlatBuffers converter: read -> parse -> verify -> write.
+// Each stage runs its own threads, stages are joined by bounded lock-free
+// queues, so a slow stage throttles the ones before it instead of piling up
+// documents in memory. Parse threads keep one parser each, created from
+// `schema` with its `opts`.
+class ConversionPipeline {
+ public:
+  // `schema` must outlive the pipeline.
+  ConversionPipeline(const Schema &schema, PipelineOptions options);
+
+  // Convert `files`, blocks until all of them are processed.
+  // Returns false if setup failed or any file failed; `errors()` has one
+  // "file: message" line per failed file.
+  bool Run(const std::vector<std::string> &files, PipelineStats *stats);
+
+  const std::vector<std::string> &errors() const { return errors_; }
+  const PipelineOptions &options() const { return options_; }
+
+ private:
+  const Schema &schema_;
+  const PipelineOptions options_;
+  std::vector<std::string> errors_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_PIPELINE_H_
@@ -0,0 +1,130 @@
+#ifndef FBJSON_SCHEMA_REGISTRY_H_
+#define FBJSON_SCHEMA_REGISTRY_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "flatbuffers/flatbuffers.h"
+#include "fbjson/parser_view.h"
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+class IncludeCache;
+
+// Immutable description of a registered schema.
+// Everything needed to build a parser is loaded once at registration time, so
+// parse contexts never touch the file system.
+struct Schema {
+  // Identifier of produced buffers if the schema doesn't declare one.
+  std::string file_identifier;
+  std::string path;
+  std::string text;
+  std::string root_type;
+  std::vector<std::string> include_dirs;
+  flatbuffers::IDLOptions opts;
+  // Declarations of included files, nullptr if every parser reads them.
+  IncludeCache *include_cache = nullptr;
+  // Parser built once by `SchemaRegistry::Register`, never modified after:
+  // `ParseContext`s parse through `ParserView`s of it.
+  std::shared_ptr<const flatbuffers::Parser> base;
+
+  // Build a parser ready to convert JSON for this schema.
+  // Returns nullptr and fills `error` on failure.
+  std::unique_ptr<flatbuffers::Parser> CreateParser(std::string *error) const;
+};
+
+// Multi-schema registry keyed by file identifier.
+// In contrast to `flatbuffers::Registry`, schemas are loaded and parsed once
+// and shared between threads. Each thread converts through its own
+// `ParseContext`, which keeps one `ParserView` per schema: its own builder
+// on the definitions of the schema's parser, without parsing it again.
+// Registration is serialized by a mutex; lookups are lock-free: readers load
+// an immutable snapshot which is never freed before the registry itself.
+class SchemaRegistry {
+ public:
+  class ParseContext;
+
+  SchemaRegistry();
+  ~SchemaRegistry();
+
+  SchemaRegistry(const SchemaRegistry &) = delete;
+  SchemaRegistry &operator=(const SchemaRegistry &) = delete;
+
+  // Options for schemas registered after this call.
+  void SetOptions(const flatbuffers::IDLOptions &opts);
+  // Include directory for schemas registered after this call.
+  void AddIncludeDirectory(const char *path);
+  // Cache of included declarations for schemas registered after this call,
+  // e.g. `IncludeCache::Default()`. Must outlive the registry.
+  void SetIncludeCache(IncludeCache *cache);
+
+  // Load and check the schema, then make it visible to all contexts.
+  // `root_type` overrides the root type declared in the schema.
+  // If the schema has no `file_identifier` declaration, `file_identifier`
+  // is used for the produced buffers.
+  bool Register(const char *file_identifier, const char *schema_path,
+                const char *root_type = nullptr);
+
+  // Lock-free lookup, returns nullptr if the identifier is unknown.
+  const Schema *Find(const char *file_identifier) const;
+
+  size_t size() const;
+
+  std::string GetLastError() const;
+
+ private:
+  using Key = uint32_t;
+  using Snapshot = std::vector<std::pair<Key, const Schema *>>;
+
+  static Key MakeKey(const char *file_identifier);
+
+  std::atomic<const Snapshot *> snapshot_;
+  // writer side
+  mutable std::mutex mutex_;
+  flatbuffers::IDLOptions opts_;
+  std::vector<std::string> include_dirs_;
+  IncludeCache *include_cache_ = nullptr;
+  std::vector<std::unique_ptr<const Schema>> schemas_;
+  std::vector<std::unique_ptr<const Snapshot>> snapshots_;
+  std::string last_error_;
+};
+
+// Per-thread conversion state.
+// Not thread-safe: create one context for each worker thread.
+class SchemaRegistry::ParseContext {
+ public:
+  explicit ParseContext(const SchemaRegistry &registry)
+      : registry_(registry) {}
+
+  // Convert JSON to a FlatBuffer of the schema registered as
+  // `file_identifier`. Returns an empty buffer on failure.
+  flatbuffers::DetachedBuffer TextToFlatBuffer(const char *text,
+                                               const char *file_identifier);
+
+  // Parse JSON into the builder of the context's parser, which is returned.
+  // The result is valid until the next call for the same schema.
+  // Only JSON objects and arrays are parsed (`ParserView::Parse`).
+  // Returns nullptr on failure.
+  flatbuffers::Parser *Parse(const char *text, const char *file_identifier);
+
+  // Convert a FlatBuffer to JSON, the schema is selected by the identifier
+  // stored in the buffer.
+  bool FlatBufferToText(const uint8_t *flatbuf, size_t len, std::string *dest);
+
+  const std::string &GetLastError() const { return last_error_; }
+
+ private:
+  ParserView *GetView(const char *file_identifier);
+
+  const SchemaRegistry &registry_;
+  std::vector<std::pair<const Schema *, std::unique_ptr<ParserView>>> views_;
+  std::string last_error_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_SCHEMA_REGISTRY_H_
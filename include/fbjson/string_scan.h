@@ -0,0 +1,32 @@
+#ifndef FBJSON_STRING_SCAN_H_
+#define FBJSON_STRING_SCAN_H_
+
+#include <cstddef>
+#include <string>
+
+namespace fbjson {
+
+// Vectorized scanning of string contents for runs which JSON holds as is:
+// printable ASCII (0x20-0x7e) except `"` and `\`. Such runs are copied in
+// bulk, only the remaining bytes (quotes, escapes, control characters,
+// DEL and UTF-8) are looked at one by one.
+// SSE2 on x86-64, NEON on AArch64, a byte loop elsewhere or with
+// `FBJSON_NO_SIMD`.
+
+// Length of the plain prefix of the `size` bytes at `s`.
+size_t PlainPrefix(const char *s, size_t size);
+
+// First byte of the NUL-terminated `s` which isn't plain; the terminator
+// itself stops the scan. Reads aligned 16-byte blocks, which may extend past
+// the terminator but never cross a page.
+const char *SkipPlain(const char *s);
+
+// Same text as `flatbuffers::EscapeString` (quoted, escapes, `\u` or raw
+// UTF-8 by `natural_utf8`, `\x` for invalid UTF-8 by `allow_non_utf8`,
+// otherwise false), with plain runs copied at once.
+bool AppendEscaped(const char *s, size_t size, std::string *text,
+                   bool allow_non_utf8, bool natural_utf8);
+
+}  // namespace fbjson
+
+#endif  // FBJSON_STRING_SCAN_H_
@@ -0,0 +1,100 @@
+#ifndef FBJSON_SYMBOL_INDEX_H_
+#define FBJSON_SYMBOL_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// Flat lookup index of the structs, tables, enums and fields of a parser.
+// `flatbuffers::Parser` keeps its symbols in `std::map`s of heap nodes,
+// which miss the cache on every step of a lookup in large schemas. Once
+// the schema is frozen (no more declarations are parsed), the index holds
+// the same symbols in open-addressing tables of fixed-size slots, with all
+// names in one contiguous buffer. Lookups compare a hash and the length
+// before touching a name.
+// `FindStruct` and `FindField` only read the index, they may be used after
+// the parser is destroyed. The definitions returned by the other lookups
+// are owned by the parser, which must outlive their use.
+class SymbolIndex {
+ public:
+  // Which definitions are indexed.
+  enum class Scope {
+    // structs, tables and enums, with the fields of structs and tables
+    kAll,
+    // tables and their fields, in the order of `FrozenSchema`
+    kTables,
+  };
+
+  explicit SymbolIndex(const flatbuffers::Parser &parser,
+                       Scope scope = Scope::kAll);
+
+  // Position of an indexed struct or table in `parser.structs_.vec`, leaving
+  // out structs with `Scope::kTables`, by fully qualified name, -1 if there
+  // is none.
+  int FindStruct(const char *name, size_t len) const;
+  // Position of a field in the `fields.vec` of the struct at position
+  // `struct_index`, -1 if there is no such field.
+  int FindField(int struct_index, const char *name, size_t len) const;
+  const flatbuffers::StructDef *LookupStruct(const char *name,
+                                             size_t len) const;
+  const flatbuffers::EnumDef *LookupEnum(const char *name, size_t len) const;
+  // Field of the struct at position `struct_index`, nullptr if there is
+  // no such field.
+  const flatbuffers::FieldDef *LookupField(int struct_index, const char *name,
+                                           size_t len) const;
+
+  const flatbuffers::StructDef &struct_def(int struct_index) const {
+    return *structs_[static_cast<size_t>(struct_index)];
+  }
+  size_t num_structs() const { return structs_.size(); }
+
+  // Bytes held by the index.
+  size_t MemoryUsage() const;
+
+ private:
+  // `def` is nullptr in empty slots.
+  struct Slot {
+    uint32_t hash;
+    // struct position for fields, otherwise 0
+    uint32_t owner;
+    // name in `names_`
+    uint32_t name;
+    uint32_t length;
+    // position in `structs_` for structs, in their struct for fields,
+    // otherwise 0
+    uint32_t index;
+    const void *def;
+  };
+
+  class Table {
+   public:
+    void Reserve(size_t symbols);
+    void Add(const Slot &slot);
+    // nullptr if there is no such symbol
+    const Slot *Find(uint32_t hash, uint32_t owner, const char *name,
+                     size_t len, const std::string &names) const;
+    size_t MemoryUsage() const { return slots_.capacity() * sizeof(Slot); }
+
+   private:
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+  };
+
+  static uint32_t Hash(const char *name, size_t len, uint32_t owner);
+  Slot MakeSlot(const std::string &name, uint32_t owner, uint32_t index,
+                const void *def);
+
+  std::string names_;
+  std::vector<const flatbuffers::StructDef *> structs_;
+  Table struct_table_;
+  Table enum_table_;
+  Table field_table_;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_SYMBOL_INDEX_H_
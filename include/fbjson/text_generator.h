@@ -0,0 +1,57 @@
+#ifndef FBJSON_TEXT_GENERATOR_H_
+#define FBJSON_TEXT_GENERATOR_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+struct TextOptions {
+  // Digits after the decimal point of `float` and `double` values, in fixed
+  // notation with trailing zeros trimmed (`flatbuffers::GenerateText` prints
+  // 6 for floats and 12 for doubles). Negative prints the shortest text that
+  // reads back as the same value.
+  int float_precision = -1;
+  // No line breaks, indentation or spaces after colons, whatever
+  // `IDLOptions::indent_step` is.
+  bool compact = false;
+  // Size of the text handed to a `ChunkWriter` at once. A chunk grows past
+  // it only by the last value printed (a long string is written whole).
+  size_t chunk_size = 64 * 1024;
+};
+
+// Writes `size` bytes of text, returns false on failure to stop printing.
+using ChunkWriter = std::function<bool(const char *data, size_t size)>;
+
+// `ChunkWriter` for a file descriptor opened for writing.
+ChunkWriter FdChunkWriter(int fd);
+
+// `ChunkWriter` into the fixed buffer `buf` of `capacity` bytes. `*size`
+// counts the bytes written; a chunk which doesn't fit fails the writer.
+ChunkWriter BufferChunkWriter(char *buf, size_t capacity, size_t *size);
+
+// Text of a FlatBuffer of the parser's root type, like
+// `flatbuffers::GenerateText` and with the same `parser.opts` (indentation,
+// strict JSON, defaults, enum identifiers, UTF-8 handling, size prefix),
+// except for the formatting of floating point values. Appends to `text`.
+// Returns false if a string can't be printed (invalid UTF-8).
+bool GenerateText(const flatbuffers::Parser &parser, const void *flatbuffer,
+                  const TextOptions &options, std::string *text);
+
+// Same text written through `write` in chunks of about
+// `options.chunk_size`, so memory use doesn't depend on the buffer size.
+// Also returns false if the writer fails.
+bool GenerateText(const flatbuffers::Parser &parser, const void *flatbuffer,
+                  const TextOptions &options, const ChunkWriter &write);
+
+// Append a floating point value formatted per `TextOptions::float_precision`.
+// Whole numbers keep one decimal (`1.0`); non-finite values print as `nan`,
+// `inf` and `-inf`.
+void AppendFloat(float value, int precision, std::string *text);
+void AppendFloat(double value, int precision, std::string *text);
+
+}  // namespace fbjson
+
+#endif  // FBJSON_TEXT_GENERATOR_H_
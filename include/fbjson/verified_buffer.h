@@ -0,0 +1,72 @@
+#ifndef FBJSON_VERIFIED_BUFFER_H_
+#define FBJSON_VERIFIED_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+
+namespace fbjson {
+
+// FlatBuffer which `flatbuffers::Parser` built from JSON. The builder writes
+// every offset, vtable, length and alignment itself, so the buffer is well
+// formed by construction and readers may skip the `flatbuffers::Verifier`
+// pass. The exception are `nested_flatbuffer` fields written as `[ubyte]`
+// arrays, which the parser copies unchecked; `ParseVerified` runs the
+// verifier over every nested buffer. Only `ParseVerified` creates non-empty
+// instances, holding one is the proof that the bytes were checked.
+// With `FBJSON_CHECK_VERIFIED` (CMake option of the same name, for debug
+// builds) `ParseVerified` checks the claim with `CrossCheckVerified`.
+class VerifiedBuffer {
+ public:
+  VerifiedBuffer() = default;
+
+  const uint8_t *data() const { return buffer_.data(); }
+  size_t size() const { return buffer_.size(); }
+  bool empty() const { return !root_; }
+
+  // Table the buffer was built for.
+  const flatbuffers::StructDef *root_type() const { return root_; }
+  bool size_prefixed() const { return size_prefixed_; }
+
+  // Root of the buffer, `T` is the generated type of `root_type()`.
+  template<typename T> const T *GetRoot() const {
+    return size_prefixed_ ? flatbuffers::GetSizePrefixedRoot<T>(data())
+                          : flatbuffers::GetRoot<T>(data());
+  }
+
+  // Give up the bytes, e.g. to write them out.
+  flatbuffers::DetachedBuffer Release() {
+    root_ = nullptr;
+    return std::move(buffer_);
+  }
+
+ private:
+  friend bool ParseVerified(flatbuffers::Parser *parser, const char *json,
+                            VerifiedBuffer *buffer,
+                            const char *source_filename);
+
+  flatbuffers::DetachedBuffer buffer_;
+  const flatbuffers::StructDef *root_ = nullptr;
+  bool size_prefixed_ = false;
+};
+
+// Parse `json` with `parser` and move the built buffer into `buffer`.
+// Returns false and sets `parser->error_` if parsing fails, the text holds
+// only declarations or a nested FlatBuffer fails verification; `buffer` is
+// empty then. Schemas with nested FlatBuffers are serialized into the
+// builder for the check (`Parser::Serialize`).
+bool ParseVerified(flatbuffers::Parser *parser, const char *json,
+                   VerifiedBuffer *buffer,
+                   const char *source_filename = nullptr);
+
+// Run `flatbuffers::Verify` over `buffer` with the reflection schema of
+// `parser` (`Parser::Serialize`, which overwrites the builder).
+// Returns false and sets `parser->error_` if the verifier rejects it.
+bool CrossCheckVerified(flatbuffers::Parser *parser,
+                        const VerifiedBuffer &buffer);
+
+}  // namespace fbjson
+
+#endif  // FBJSON_VERIFIED_BUFFER_H_
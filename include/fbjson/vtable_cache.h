@@ -0,0 +1,77 @@
+#ifndef FBJSON_VTABLE_CACHE_H_
+#define FBJSON_VTABLE_CACHE_H_
+
+#include <vector>
+#include "flatbuffers/flatbuffers.h"
+
+namespace fbjson {
+
+enum class VtableDedup {
+  // Every table gets its own vtable.
+  kNone,
+  // `FlatBufferBuilder` default: compare with every vtable written before.
+  kLinear,
+  // Look up identical vtables in a hash index.
+  kHash
+};
+
+// Builder with a selectable vtable deduplication mode.
+// The linear search of `FlatBufferBuilder` is quadratic for documents with
+// many tables of different shapes; `kHash` keeps an open-addressing index
+// of written vtables instead. The hash mode writes vtables itself with the
+// layout of `FlatBufferBuilder::EndTable` in flatbuffers 1.10, with other
+// versions it falls back to `kLinear`.
+// The base builder is private: its `EndTable` and `Clear` would bypass the
+// index, so the type can't be passed as a `FlatBufferBuilder &`. The
+// building and buffer access members are re-exported instead.
+class VtableCacheBuilder : private flatbuffers::FlatBufferBuilder {
+ public:
+  using flatbuffers::FlatBufferBuilder::FlatBufferBuilder;
+
+  void SetVtableDedup(VtableDedup mode);
+  VtableDedup vtable_dedup() const { return mode_; }
+
+  flatbuffers::uoffset_t EndTable(flatbuffers::uoffset_t start);
+  void Clear();
+  void Reset();
+
+  using flatbuffers::FlatBufferBuilder::AddElement;
+  using flatbuffers::FlatBufferBuilder::AddOffset;
+  using flatbuffers::FlatBufferBuilder::CreateString;
+  using flatbuffers::FlatBufferBuilder::CreateVector;
+  using flatbuffers::FlatBufferBuilder::EndVector;
+  using flatbuffers::FlatBufferBuilder::Finish;
+  using flatbuffers::FlatBufferBuilder::ForceDefaults;
+  using flatbuffers::FlatBufferBuilder::GetBufferPointer;
+  using flatbuffers::FlatBufferBuilder::GetCurrentBufferPointer;
+  using flatbuffers::FlatBufferBuilder::GetSize;
+  using flatbuffers::FlatBufferBuilder::PushElement;
+  using flatbuffers::FlatBufferBuilder::Release;
+  using flatbuffers::FlatBufferBuilder::StartTable;
+  using flatbuffers::FlatBufferBuilder::StartVector;
+
+  // Memory held by the hash index.
+  size_t VtableIndexMemory() const {
+    return index_.capacity() * sizeof(Slot);
+  }
+
+ private:
+  // Offset 0 marks an empty slot.
+  struct Slot {
+    uint32_t hash;
+    flatbuffers::uoffset_t offset;
+  };
+
+  // Offset of an identical vtable, or 0 after adding `offset` as new.
+  flatbuffers::uoffset_t FindOrAdd(const uint8_t *vtable,
+                                   flatbuffers::voffset_t size,
+                                   flatbuffers::uoffset_t offset);
+
+  VtableDedup mode_ = VtableDedup::kLinear;
+  std::vector<Slot> index_;
+  size_t num_vtables_ = 0;
+};
+
+}  // namespace fbjson
+
+#endif  // FBJSON_VTABLE_CACHE_H_
@@ -0,0 +1,120 @@
+#include "fbjson/array_stream.h"
+
+namespace fbjson {
+
+namespace {
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+}  // namespace
+
+void ArrayStreamParser::Reset() {
+  scanner_.Reset();
+  state_ = State::kBeforeArray;
+  after_comma_ = false;
+  element_.clear();
+  elements_ = 0;
+  error_.clear();
+}
+
+ArrayStreamParser::Status ArrayStreamParser::Fail(const std::string &message) {
+  state_ = State::kError;
+  error_ = message;
+  return Status::kError;
+}
+
+ArrayStreamParser::Status ArrayStreamParser::Feed(const char *data,
+                                                  size_t size,
+                                                  size_t *consumed) {
+  *consumed = 0;
+  if (state_ == State::kDone) return Status::kDone;
+  if (state_ == State::kError) return Status::kError;
+  for (size_t i = 0; i < size; i++) {
+    const auto c = data[i];
+    switch (state_) {
+      case State::kBeforeArray:
+        if (c == '[') {
+          state_ = State::kBeforeElement;
+        } else if (!IsSpace(c)) {
+          *consumed = i;
+          return Fail("root value must be an array");
+        }
+        break;
+      case State::kBeforeElement:
+        if (c == ']' && (!after_comma_ || !parser_->opts.strict_json)) {
+          state_ = State::kDone;
+          *consumed = i + 1;
+          return Status::kDone;
+        }
+        if (c != '{') {
+          if (IsSpace(c)) break;
+          *consumed = i;
+          return Fail("array element " + std::to_string(elements_) +
+                      " must be an object");
+        }
+        // the scanner takes the opening bracket
+        state_ = State::kElement;
+        [[fallthrough]];
+      case State::kElement: {
+        size_t n = 0;
+        const auto status = scanner_.Scan(data + i, size - i, &n);
+        element_.append(data + i, n);
+        if (status == JsonScanner::Status::kNeedMoreData) {
+          *consumed = size;
+          return Status::kNeedMoreData;
+        }
+        *consumed = i + n;
+        if (status == JsonScanner::Status::kError) {
+          return Fail(scanner_.error());
+        }
+        scanner_.Reset();
+        const auto ok = parser_->Parse(element_.c_str());
+        // keep the capacity for the next element
+        element_.clear();
+        if (!ok) {
+          return Fail("array element " + std::to_string(elements_) + ": " +
+                      parser_->error_);
+        }
+        elements_++;
+        state_ = State::kAfterElement;
+        return Status::kElement;
+      }
+      case State::kAfterElement:
+        if (c == ',') {
+          after_comma_ = true;
+          state_ = State::kBeforeElement;
+        } else if (c == ']') {
+          state_ = State::kDone;
+          *consumed = i + 1;
+          return Status::kDone;
+        } else if (!IsSpace(c)) {
+          *consumed = i;
+          return Fail("expected ',' or ']' after array element " +
+                      std::to_string(elements_ - 1));
+        }
+        break;
+      case State::kDone:
+      case State::kError: break;
+    }
+  }
+  *consumed = size;
+  return Status::kNeedMoreData;
+}
+
+ArrayStreamParser::Status ArrayStreamParser::Finish() {
+  if (state_ == State::kDone || state_ == State::kError) {
+    return state_ == State::kDone ? Status::kDone : Status::kError;
+  }
+  return Fail(state_ == State::kBeforeArray ? "empty input"
+                                            : "unexpected end of input");
+}
+
+ChunkReader FileChunkReader(std::FILE *file) {
+  return [file](char *buf, size_t size) {
+    return std::fread(buf, 1, size, file);
+  };
+}
+
+}  // namespace fbjson
@@ -0,0 +1,293 @@
+#include "fbjson/binary_schema.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+#include "flatbuffers/reflection.h"
+#include "flatbuffers/util.h"
+
+namespace fbjson {
+
+namespace {
+
+using AttributeVector =
+    flatbuffers::Vector<flatbuffers::Offset<reflection::KeyValue>>;
+
+// Rebuilds parser definitions from reflection tables.
+// Objects and enums are referenced by their index in the schema.
+// Every definition is owned by the symbol table it is added to, including
+// duplicates: `SymbolTable::Add` stores them in `vec` before it reports the
+// clash, so they must not be deleted here.
+class SchemaLoader {
+ public:
+  SchemaLoader(const reflection::Schema &schema, flatbuffers::Parser *parser)
+      : schema_(schema), parser_(parser) {}
+
+  bool Load(std::string *error);
+
+ private:
+  // Split "ns1.ns2.Name" into the namespace and the short name.
+  flatbuffers::Namespace *GetNamespace(const std::string &full_name,
+                                       std::string *name);
+  bool ConvertType(const reflection::Type &type, flatbuffers::Type *out,
+                   std::string *error) const;
+  // Name as written in the schema, looked up the way
+  // `Parser::LookupCreateStruct` does: qualified with `ns`, then with each
+  // of its parent namespaces.
+  flatbuffers::StructDef *LookupStruct(const flatbuffers::Namespace &ns,
+                                       const std::string &name) const;
+  static void CopyAttributes(const AttributeVector *attributes,
+                             flatbuffers::Definition *def);
+  bool LoadEnum(const reflection::Enum &e, flatbuffers::EnumDef *def,
+                std::string *error);
+  bool LoadObject(const reflection::Object &object,
+                  flatbuffers::StructDef *def, std::string *error);
+
+  const reflection::Schema &schema_;
+  flatbuffers::Parser *parser_;
+  std::vector<flatbuffers::StructDef *> structs_;
+  std::vector<flatbuffers::EnumDef *> enums_;
+  std::map<std::string, flatbuffers::Namespace *> namespaces_;
+};
+
+flatbuffers::Namespace *SchemaLoader::GetNamespace(
+    const std::string &full_name, std::string *name) {
+  const auto dot = full_name.find_last_of('.');
+  const auto ns_name =
+      dot == std::string::npos ? std::string() : full_name.substr(0, dot);
+  *name = dot == std::string::npos ? full_name : full_name.substr(dot + 1);
+  auto &ns = namespaces_[ns_name];
+  if (!ns) {
+    ns = new flatbuffers::Namespace();
+    for (size_t pos = 0; pos < ns_name.size();) {
+      auto end = ns_name.find('.', pos);
+      if (end == std::string::npos) end = ns_name.size();
+      ns->components.push_back(ns_name.substr(pos, end - pos));
+      pos = end + 1;
+    }
+    // the parser owns all namespaces
+    parser_->namespaces_.push_back(ns);
+  }
+  return ns;
+}
+
+bool SchemaLoader::ConvertType(const reflection::Type &type,
+                               flatbuffers::Type *out,
+                               std::string *error) const {
+  // Both enums have the same order of base types.
+  auto convert = [&](reflection::BaseType bt) {
+    return bt == reflection::Obj
+               ? flatbuffers::BASE_TYPE_STRUCT
+               : static_cast<flatbuffers::BaseType>(static_cast<int>(bt));
+  };
+  out->base_type = convert(type.base_type());
+  out->element = type.base_type() == reflection::Vector
+                     ? convert(type.element())
+                     : flatbuffers::BASE_TYPE_NONE;
+  out->struct_def = nullptr;
+  out->enum_def = nullptr;
+  const auto index = type.index();
+  if (index < 0) return true;
+  const auto object_type = type.base_type() == reflection::Obj ||
+                           (type.base_type() == reflection::Vector &&
+                            type.element() == reflection::Obj);
+  if (object_type) {
+    if (static_cast<size_t>(index) >= structs_.size()) {
+      *error = "binary schema: object index out of range";
+      return false;
+    }
+    out->struct_def = structs_[index];
+  } else {
+    if (static_cast<size_t>(index) >= enums_.size()) {
+      *error = "binary schema: enum index out of range";
+      return false;
+    }
+    out->enum_def = enums_[index];
+  }
+  return true;
+}
+
+flatbuffers::StructDef *SchemaLoader::LookupStruct(
+    const flatbuffers::Namespace &ns, const std::string &name) const {
+  for (auto components = ns.components.size() + 1; components--;) {
+    const auto sd =
+        parser_->structs_.Lookup(ns.GetFullyQualifiedName(name, components));
+    if (sd) return sd;
+  }
+  return nullptr;
+}
+
+void SchemaLoader::CopyAttributes(const AttributeVector *attributes,
+                                  flatbuffers::Definition *def) {
+  if (!attributes) return;
+  for (auto kv : *attributes) {
+    auto value = new flatbuffers::Value();
+    value->constant = kv->value() ? kv->value()->str() : "";
+    def->attributes.Add(kv->key()->str(), value);
+  }
+}
+
+bool SchemaLoader::LoadEnum(const reflection::Enum &e,
+                            flatbuffers::EnumDef *def, std::string *error) {
+  def->is_union = e.is_union();
+  CopyAttributes(e.attributes(), def);
+  if (!ConvertType(*e.underlying_type(), &def->underlying_type, error)) {
+    return false;
+  }
+  for (auto v : *e.values()) {
+    auto val = new flatbuffers::EnumVal(v->name()->str(), v->value());
+    if (v->union_type()) {
+      if (!ConvertType(*v->union_type(), &val->union_type, error)) {
+        delete val;
+        return false;
+      }
+    } else if (v->object()) {
+      // schemas written before `union_type` was added
+      flatbuffers::Type type(flatbuffers::BASE_TYPE_STRUCT);
+      type.struct_def = parser_->structs_.Lookup(v->object()->name()->str());
+      val->union_type = type;
+    }
+    if (def->vals.Add(val->name, val)) {
+      *error = "binary schema: duplicate enum value " + v->name()->str();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SchemaLoader::LoadObject(const reflection::Object &object,
+                              flatbuffers::StructDef *def,
+                              std::string *error) {
+  CopyAttributes(object.attributes(), def);
+  def->sortbysize = !def->attributes.Lookup("original_order");
+  // Fields are sorted by name in the binary schema, the parser expects
+  // declaration order (field id).
+  std::vector<const reflection::Field *> fields;
+  for (auto f : *object.fields()) fields.push_back(f);
+  std::sort(fields.begin(), fields.end(),
+            [](const reflection::Field *a, const reflection::Field *b) {
+              return a->id() < b->id();
+            });
+  for (size_t i = 0; i < fields.size(); i++) {
+    const auto &f = *fields[i];
+    auto field = new flatbuffers::FieldDef();
+    field->name = f.name()->str();
+    field->file = def->file;
+    if (def->fields.Add(field->name, field)) {
+      *error = "binary schema: duplicate field " + f.name()->str();
+      return false;
+    }
+    if (!ConvertType(*f.type(), &field->value.type, error)) return false;
+    field->value.offset = f.offset();
+    const auto bt = field->value.type.base_type;
+    if (flatbuffers::IsFloat(bt)) {
+      // `NumToString` keeps 12 digits, a default must survive the round trip
+      char buf[32];
+      std::snprintf(buf, sizeof(buf), "%.17g", f.default_real());
+      field->value.constant = buf;
+    } else if (bt == flatbuffers::BASE_TYPE_ULONG) {
+      field->value.constant = flatbuffers::NumToString(
+          static_cast<uint64_t>(f.default_integer()));
+    } else if (flatbuffers::IsScalar(bt)) {
+      field->value.constant = flatbuffers::NumToString(f.default_integer());
+    }
+    field->deprecated = f.deprecated();
+    field->required = f.required();
+    field->key = f.key();
+    def->has_key = def->has_key || f.key();
+    CopyAttributes(f.attributes(), field);
+    // builtin attributes, only present in schemas serialized with
+    // `binary_schema_builtins`
+    field->native_inline =
+        field->attributes.Lookup("native_inline") != nullptr;
+    field->flexbuffer = field->attributes.Lookup("flexbuffer") != nullptr;
+    if (field->flexbuffer) parser_->uses_flexbuffers_ = true;
+    if (auto nested = field->attributes.Lookup("nested_flatbuffer")) {
+      field->nested_flatbuffer =
+          LookupStruct(*def->defined_namespace, nested->constant);
+    }
+    if (def->fixed) {
+      // struct fields are padded up to the next field
+      const auto size =
+          bt == flatbuffers::BASE_TYPE_STRUCT
+              ? field->value.type.struct_def->bytesize
+              : flatbuffers::SizeOf(bt);
+      const auto next = i + 1 < fields.size() ? fields[i + 1]->offset()
+                                              : def->bytesize;
+      field->padding = next - f.offset() - size;
+    }
+  }
+  return true;
+}
+
+bool SchemaLoader::Load(std::string *error) {
+  if (!parser_->structs_.vec.empty() || !parser_->enums_.vec.empty()) {
+    *error = "binary schema: parser already has type definitions";
+    return false;
+  }
+  // Declare all types first, fields reference them by index and struct
+  // fields need the size of nested structs.
+  for (auto object : *schema_.objects()) {
+    auto def = new flatbuffers::StructDef();
+    const auto full_name = object->name()->str();
+    def->defined_namespace = GetNamespace(full_name, &def->name);
+    def->predecl = false;
+    def->fixed = object->is_struct();
+    def->minalign = static_cast<size_t>(object->minalign());
+    def->bytesize = static_cast<size_t>(object->bytesize());
+    def->index = static_cast<int>(structs_.size());
+    if (parser_->structs_.Add(full_name, def)) {
+      *error = "binary schema: duplicate object " + full_name;
+      return false;
+    }
+    structs_.push_back(def);
+  }
+  if (schema_.enums()) {
+    for (auto e : *schema_.enums()) {
+      auto def = new flatbuffers::EnumDef();
+      const auto full_name = e->name()->str();
+      def->defined_namespace = GetNamespace(full_name, &def->name);
+      def->index = static_cast<int>(enums_.size());
+      if (parser_->enums_.Add(full_name, def)) {
+        *error = "binary schema: duplicate enum " + full_name;
+        return false;
+      }
+      enums_.push_back(def);
+    }
+    for (size_t i = 0; i < enums_.size(); i++) {
+      const auto e =
+          schema_.enums()->Get(static_cast<flatbuffers::uoffset_t>(i));
+      if (!LoadEnum(*e, enums_[i], error)) return false;
+    }
+  }
+  for (size_t i = 0; i < structs_.size(); i++) {
+    const auto object =
+        schema_.objects()->Get(static_cast<flatbuffers::uoffset_t>(i));
+    if (!LoadObject(*object, structs_[i], error)) return false;
+  }
+  if (schema_.root_table()) {
+    parser_->root_struct_def_ =
+        parser_->structs_.Lookup(schema_.root_table()->name()->str());
+  }
+  if (schema_.file_ident()) {
+    parser_->file_identifier_ = schema_.file_ident()->str();
+  }
+  if (schema_.file_ext()) parser_->file_extension_ = schema_.file_ext()->str();
+  return true;
+}
+
+}  // namespace
+
+bool LoadBinarySchema(const uint8_t *bfbs, size_t size,
+                      flatbuffers::Parser *parser, std::string *error) {
+  flatbuffers::Verifier verifier(bfbs, size);
+  if (!reflection::VerifySchemaBuffer(verifier)) {
+    *error = "binary schema: verification failed";
+    return false;
+  }
+  SchemaLoader loader(*reflection::GetSchema(bfbs), parser);
+  return loader.Load(error);
+}
+
+}  // namespace fbjson
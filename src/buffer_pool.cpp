@@ -0,0 +1,156 @@
+#include "fbjson/buffer_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace fbjson {
+
+namespace {
+
+const size_t kHugePageSize = size_t(2) << 20;
+
+size_t RoundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+BufferPool::BufferPool(BufferPoolOptions options) : options_(options) {
+  for (auto size = options_.min_size; size && size <= options_.max_size;
+       size *= 2) {
+    classes_.push_back({ size, {} });
+  }
+}
+
+BufferPool::~BufferPool() {
+  for (auto &c : classes_) {
+    if (options_.huge_pages) continue;
+    for (auto p : c.free) delete[] p;
+  }
+  for (const auto &m : mappings_) {
+#if defined(__linux__)
+    munmap(m.first, m.second);
+#else
+    delete[] static_cast<uint8_t *>(m.first);
+#endif
+  }
+}
+
+int BufferPool::ClassIndex(size_t size) const {
+  for (size_t i = 0; i < classes_.size(); i++) {
+    if (size <= classes_[i].size) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+// Called with the mutex held.
+uint8_t *BufferPool::Map(size_t size) {
+  size = RoundUp(size, kHugePageSize);
+  void *p = nullptr;
+#if defined(__linux__)
+  p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (p == MAP_FAILED) {
+    // No reserved huge pages, ask for transparent ones. They only back
+    // 2 MiB-aligned ranges, so map one huge page more and trim both ends.
+    const auto span = size + kHugePageSize;
+    p = mmap(nullptr, span, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    const auto raw = static_cast<uint8_t *>(p);
+    const auto aligned = reinterpret_cast<uint8_t *>(
+        RoundUp(reinterpret_cast<uintptr_t>(raw), kHugePageSize));
+    if (aligned != raw) munmap(raw, static_cast<size_t>(aligned - raw));
+    const auto tail = static_cast<size_t>(raw + span - (aligned + size));
+    if (tail) munmap(aligned + size, tail);
+    p = aligned;
+#  ifdef MADV_HUGEPAGE
+    madvise(p, size, MADV_HUGEPAGE);
+#  endif
+  }
+#else
+  p = new uint8_t[size];
+#endif
+  mappings_.emplace_back(p, size);
+  stats_.mapped_bytes += size;
+  return static_cast<uint8_t *>(p);
+}
+
+// Called with the mutex held.
+void BufferPool::Unmap(uint8_t *p) {
+  const auto it =
+      std::find_if(mappings_.begin(), mappings_.end(),
+                   [p](const std::pair<void *, size_t> &m) {
+                     return m.first == p;
+                   });
+  if (it == mappings_.end()) return;
+#if defined(__linux__)
+  munmap(it->first, it->second);
+#else
+  delete[] static_cast<uint8_t *>(it->first);
+#endif
+  stats_.mapped_bytes -= it->second;
+  *it = mappings_.back();
+  mappings_.pop_back();
+}
+
+uint8_t *BufferPool::allocate(size_t size) {
+  const auto index = ClassIndex(size);
+  if (index < 0) return new uint8_t[size];
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &c = classes_[index];
+  if (c.free.empty()) {
+    stats_.misses++;
+    if (!options_.huge_pages) return new uint8_t[c.size];
+    if (c.size >= kHugePageSize) return Map(c.size);
+    // carve a slab into buffers of this class
+    const auto slab = Map(kHugePageSize);
+    for (auto offset = c.size; offset + c.size <= kHugePageSize;
+         offset += c.size) {
+      c.free.push_back(slab + offset);
+      stats_.cached_bytes += c.size;
+    }
+    return slab;
+  }
+  stats_.hits++;
+  const auto p = c.free.back();
+  c.free.pop_back();
+  stats_.cached_bytes -= c.size;
+  return p;
+}
+
+void BufferPool::deallocate(uint8_t *p, size_t size) {
+  const auto index = ClassIndex(size);
+  if (index < 0) {
+    delete[] p;
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &c = classes_[index];
+  if (stats_.cached_bytes + c.size > options_.max_cached_bytes) {
+    if (!options_.huge_pages) {
+      delete[] p;
+      return;
+    }
+    // Buffers of huge page size or more are mappings of their own. Slab
+    // buffers can't be unmapped one by one, they stay cached.
+    if (c.size >= kHugePageSize) {
+      Unmap(p);
+      return;
+    }
+  }
+  c.free.push_back(p);
+  stats_.cached_bytes += c.size;
+}
+
+BufferPool::Stats BufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace fbjson
@@ -0,0 +1,60 @@
+#include "fbjson/document_framer.h"
+
+namespace fbjson {
+
+void DocumentFramer::Reset() {
+  scanner_.Reset();
+  buffer_.clear();
+  status_ = Status::kNeedMoreData;
+  error_.clear();
+}
+
+DocumentFramer::Status DocumentFramer::Feed(const char *data, size_t size,
+                                            size_t *consumed) {
+  size_t n = 0;
+  if (status_ == Status::kNeedMoreData) {
+    const auto scan = scanner_.Scan(data, size, &n);
+    buffer_.append(data, n);
+    if (scan == JsonScanner::Status::kComplete) {
+      Complete();
+    } else if (scan == JsonScanner::Status::kError) {
+      // include the offending byte into the parser's error message
+      if (n < size) buffer_.push_back(data[n]);
+      Fail(scanner_.error());
+    }
+  }
+  if (consumed) *consumed = n;
+  return status_;
+}
+
+DocumentFramer::Status DocumentFramer::Finish() {
+  if (status_ != Status::kNeedMoreData) return status_;
+  if (!scanner_.started()) {
+    status_ = Status::kError;
+    error_ = "error: no JSON document in input";
+    return status_;
+  }
+  return Fail("error: unexpected end of input");
+}
+
+DocumentFramer::Status DocumentFramer::Complete() {
+  if (!parser_->Parse(buffer_.c_str())) {
+    status_ = Status::kError;
+    error_ = parser_->error_;
+    parser_->builder_.Clear();
+    return status_;
+  }
+  status_ = Status::kDone;
+  return status_;
+}
+
+DocumentFramer::Status DocumentFramer::Fail(const char *fallback_error) {
+  // Report the same message as a parse of the whole input would. The parse
+  // may leave a partial or complete buffer behind, which must not be read.
+  status_ = Status::kError;
+  error_ = parser_->Parse(buffer_.c_str()) ? fallback_error : parser_->error_;
+  parser_->builder_.Clear();
+  return status_;
+}
+
+}  // namespace fbjson
@@ -0,0 +1,428 @@
+#include "fbjson/flex_parser.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "fbjson/meta.h"
+#include "fbjson/string_scan.h"
+#include "flatbuffers/util.h"
+
+namespace fbjson {
+
+namespace {
+
+// Same limit as `flatbuffers::Parser`.
+const int kMaxDepth = 64;
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+int HexDigit(char c) {
+  if (IsDigit(c)) return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+bool Hex4(const char **p, uint32_t *ucc) {
+  *ucc = 0;
+  for (int i = 0; i < 4; i++) {
+    const auto d = HexDigit((*p)[i]);
+    if (d < 0) return false;
+    *ucc = (*ucc << 4) | static_cast<uint32_t>(d);
+  }
+  *p += 4;
+  return true;
+}
+
+}  // namespace
+
+bool FlexParser::Error(const std::string &message) {
+  error_ = "error: " + message;
+  return false;
+}
+
+void FlexParser::SkipWhitespace() {
+  while (*cursor_ == ' ' || *cursor_ == '\t' || *cursor_ == '\r' ||
+         *cursor_ == '\n') {
+    cursor_++;
+  }
+}
+
+bool FlexParser::Parse(const char *json) {
+  builder_.Clear();
+  if (!ParseValue(json)) return false;
+  SkipWhitespace();
+  if (*cursor_) return Error("unexpected data after the root value");
+  builder_.Finish();
+  return true;
+}
+
+const char *FlexParser::ParseValue(const char *json, const char *key) {
+  error_.clear();
+  cursor_ = json;
+  depth_ = 0;
+  keys_.clear();
+  key_hashes_.clear();
+  return Value(&builder_, key) ? cursor_ : nullptr;
+}
+
+bool FlexParser::Value(flexbuffers::Builder *b, const char *key) {
+  SkipWhitespace();
+  switch (*cursor_) {
+    case '{': return Object(b, key);
+    case '[': return Array(b, key);
+    case '"':
+      if (!String(&string_)) return false;
+      if (b) {
+        if (key) b->Key(key);
+        b->String(string_.data(), string_.size());
+      }
+      return true;
+    case 't':
+      if (std::strncmp(cursor_, "true", 4)) break;
+      cursor_ += 4;
+      if (b) {
+        if (key) b->Key(key);
+        b->Bool(true);
+      }
+      return true;
+    case 'f':
+      if (std::strncmp(cursor_, "false", 5)) break;
+      cursor_ += 5;
+      if (b) {
+        if (key) b->Key(key);
+        b->Bool(false);
+      }
+      return true;
+    case 'n':
+      if (std::strncmp(cursor_, "null", 4)) break;
+      cursor_ += 4;
+      if (b) {
+        if (key) b->Key(key);
+        b->Null();
+      }
+      return true;
+    default:
+      if (*cursor_ == '-' || IsDigit(*cursor_)) return Number(b, key);
+      break;
+  }
+  return Error("cannot parse value starting with: " +
+               (*cursor_ ? std::string(1, *cursor_) : "end of file"));
+}
+
+bool FlexParser::Object(flexbuffers::Builder *b, const char *key) {
+  if (++depth_ > kMaxDepth) return Error("maximum nesting depth reached");
+  cursor_++;
+  size_t start = 0;
+  if (b) start = key ? b->StartMap(key) : b->StartMap();
+  const auto base = keys_.size();
+  SkipWhitespace();
+  while (*cursor_ != '}') {
+    if (*cursor_ != '"') return Error("expecting: string constant");
+    if (!String(&string_)) return false;
+    SkipWhitespace();
+    if (*cursor_ != ':') return Error("expecting: :");
+    cursor_++;
+    // the builder reads keys up to the first zero
+    string_.resize(std::strlen(string_.c_str()));
+    const auto hash = meta::HashName(string_.data(), string_.size());
+    auto duplicate = false;
+    for (auto i = base; i < keys_.size() && !duplicate; i++) {
+      duplicate = key_hashes_[i] == hash && keys_[i] == string_;
+    }
+    if (duplicate) {
+      if (!Value(nullptr, nullptr)) return false;
+    } else {
+      keys_.push_back(string_);
+      key_hashes_.push_back(hash);
+      // the key is passed to the builder before nested keys are pushed
+      if (!Value(b, keys_.back().c_str())) return false;
+    }
+    SkipWhitespace();
+    if (*cursor_ == ',') {
+      cursor_++;
+      SkipWhitespace();
+      if (*cursor_ == '}') return Error("unexpected trailing comma");
+    } else if (*cursor_ != '}') {
+      return Error("expecting: } instead got: " +
+                   (*cursor_ ? std::string(1, *cursor_) : "end of file"));
+    }
+  }
+  cursor_++;
+  keys_.resize(base);
+  key_hashes_.resize(base);
+  if (b) b->EndMap(start);
+  depth_--;
+  return true;
+}
+
+bool FlexParser::Array(flexbuffers::Builder *b, const char *key) {
+  if (++depth_ > kMaxDepth) return Error("maximum nesting depth reached");
+  cursor_++;
+  size_t start = 0;
+  if (b) start = key ? b->StartVector(key) : b->StartVector();
+  SkipWhitespace();
+  while (*cursor_ != ']') {
+    if (!Value(b, nullptr)) return false;
+    SkipWhitespace();
+    if (*cursor_ == ',') {
+      cursor_++;
+      SkipWhitespace();
+      if (*cursor_ == ']') return Error("unexpected trailing comma");
+    } else if (*cursor_ != ']') {
+      return Error("expecting: ] instead got: " +
+                   (*cursor_ ? std::string(1, *cursor_) : "end of file"));
+    }
+  }
+  cursor_++;
+  if (b) b->EndVector(start, false, false);
+  depth_--;
+  return true;
+}
+
+bool FlexParser::Number(flexbuffers::Builder *b, const char *key) {
+  // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+  const auto begin = cursor_;
+  auto p = begin;
+  if (*p == '-') p++;
+  if (*p == '0') {
+    p++;
+  } else if (IsDigit(*p)) {
+    while (IsDigit(*p)) p++;
+  } else {
+    return Error("invalid number: " + std::string(begin, p + (*p != 0)));
+  }
+  auto integer = true;
+  if (*p == '.') {
+    integer = false;
+    if (!IsDigit(*++p)) {
+      return Error("invalid number: " + std::string(begin, p));
+    }
+    while (IsDigit(*p)) p++;
+  }
+  if (*p == 'e' || *p == 'E') {
+    integer = false;
+    p++;
+    if (*p == '+' || *p == '-') p++;
+    if (!IsDigit(*p)) {
+      return Error("invalid number: " + std::string(begin, p));
+    }
+    while (IsDigit(*p)) p++;
+  }
+  cursor_ = p;
+  if (!b) return true;
+  if (key) b->Key(key);
+  if (integer) {
+    errno = 0;
+    const auto i = std::strtoll(begin, nullptr, 10);
+    if (errno != ERANGE) {
+      b->Int(i);
+      return true;
+    }
+    if (*begin != '-') {
+      errno = 0;
+      const auto u = std::strtoull(begin, nullptr, 10);
+      if (errno != ERANGE) {
+        b->UInt(u);
+        return true;
+      }
+    }
+  }
+  b->Double(std::strtod(begin, nullptr));
+  return true;
+}
+
+bool FlexParser::String(std::string *out) {
+  cursor_++;
+  out->clear();
+  for (;;) {
+    // copy the run of plain characters at once
+    const auto run = SkipPlain(cursor_);
+    out->append(cursor_, run);
+    cursor_ = run;
+    const auto c = static_cast<unsigned char>(*cursor_);
+    if (c == '"') {
+      cursor_++;
+      return true;
+    }
+    // UTF-8 or DEL
+    if (c >= 0x7f) {
+      const auto start = cursor_;
+      if (flatbuffers::FromUTF8(&cursor_) < 0) {
+        return Error("illegal UTF-8 sequence");
+      }
+      out->append(start, cursor_);
+      continue;
+    }
+    if (c < 0x20) {
+      return Error(c ? "illegal character in string constant"
+                     : "unexpected end of string");
+    }
+    // escape sequence
+    cursor_++;
+    switch (*cursor_++) {
+      case '"': out->push_back('"'); break;
+      case '\\': out->push_back('\\'); break;
+      case '/': out->push_back('/'); break;
+      case 'b': out->push_back('\b'); break;
+      case 'f': out->push_back('\f'); break;
+      case 'n': out->push_back('\n'); break;
+      case 'r': out->push_back('\r'); break;
+      case 't': out->push_back('\t'); break;
+      case 'u': {
+        uint32_t ucc = 0;
+        if (!Hex4(&cursor_, &ucc)) {
+          return Error("invalid \\u escape in string constant");
+        }
+        if (ucc >= 0xD800 && ucc < 0xDC00) {
+          // surrogate pair
+          uint32_t low = 0;
+          if (cursor_[0] != '\\' || cursor_[1] != 'u' ||
+              (cursor_ += 2, !Hex4(&cursor_, &low)) || low < 0xDC00 ||
+              low > 0xDFFF) {
+            return Error("illegal Unicode sequence (unpaired high surrogate)");
+          }
+          ucc = 0x10000 + ((ucc - 0xD800) << 10) + (low - 0xDC00);
+        } else if (ucc >= 0xDC00 && ucc <= 0xDFFF) {
+          return Error("illegal Unicode sequence (unpaired low surrogate)");
+        }
+        flatbuffers::ToUTF8(ucc, out);
+        break;
+      }
+      default: return Error("unknown escape code in string constant");
+    }
+  }
+}
+
+namespace {
+
+void AppendString(const char *s, size_t size, std::string *json) {
+  static const char kHex[] = "0123456789abcdef";
+  json->push_back('"');
+  for (size_t i = 0; i < size; i++) {
+    const auto plain = PlainPrefix(s + i, size - i);
+    json->append(s + i, plain);
+    i += plain;
+    if (i == size) break;
+    const auto c = static_cast<unsigned char>(s[i]);
+    switch (c) {
+      case '"': *json += "\\\""; break;
+      case '\\': *json += "\\\\"; break;
+      case '\b': *json += "\\b"; break;
+      case '\f': *json += "\\f"; break;
+      case '\n': *json += "\\n"; break;
+      case '\r': *json += "\\r"; break;
+      case '\t': *json += "\\t"; break;
+      default:
+        if (c < 0x20) {
+          *json += "\\u00";
+          json->push_back(kHex[c >> 4]);
+          json->push_back(kHex[c & 15]);
+        } else {
+          json->push_back(static_cast<char>(c));
+        }
+        break;
+    }
+  }
+  json->push_back('"');
+}
+
+}  // namespace
+
+bool FlexToJson(flexbuffers::Reference value, std::string *json) {
+  switch (value.GetType()) {
+    case flexbuffers::FBT_NULL: *json += "null"; return true;
+    case flexbuffers::FBT_BOOL:
+      *json += value.AsBool() ? "true" : "false";
+      return true;
+    case flexbuffers::FBT_INT:
+    case flexbuffers::FBT_INDIRECT_INT:
+      *json += std::to_string(value.AsInt64());
+      return true;
+    case flexbuffers::FBT_UINT:
+    case flexbuffers::FBT_INDIRECT_UINT:
+      *json += std::to_string(value.AsUInt64());
+      return true;
+    case flexbuffers::FBT_FLOAT:
+    case flexbuffers::FBT_INDIRECT_FLOAT: {
+      const auto d = value.AsDouble();
+      if (!std::isfinite(d)) return false;
+      char buf[32];
+      std::snprintf(buf, sizeof(buf), "%.17g", d);
+      *json += buf;
+      // keep it a floating point number when read back
+      if (!std::strpbrk(buf, ".e")) *json += ".0";
+      return true;
+    }
+    case flexbuffers::FBT_KEY: {
+      const auto key = value.AsKey();
+      AppendString(key, std::strlen(key), json);
+      return true;
+    }
+    case flexbuffers::FBT_STRING: {
+      const auto s = value.AsString();
+      AppendString(s.c_str(), s.length(), json);
+      return true;
+    }
+    case flexbuffers::FBT_BLOB: {
+      const auto blob = value.AsBlob();
+      json->push_back('[');
+      for (size_t i = 0; i < blob.size(); i++) {
+        if (i) json->push_back(',');
+        *json += std::to_string(blob.data()[i]);
+      }
+      json->push_back(']');
+      return true;
+    }
+    case flexbuffers::FBT_MAP: {
+      const auto map = value.AsMap();
+      const auto keys = map.Keys();
+      const auto values = map.Values();
+      json->push_back('{');
+      for (size_t i = 0; i < map.size(); i++) {
+        if (i) json->push_back(',');
+        if (!FlexToJson(keys[i], json)) return false;
+        json->push_back(':');
+        if (!FlexToJson(values[i], json)) return false;
+      }
+      json->push_back('}');
+      return true;
+    }
+    case flexbuffers::FBT_VECTOR: {
+      const auto vector = value.AsVector();
+      json->push_back('[');
+      for (size_t i = 0; i < vector.size(); i++) {
+        if (i) json->push_back(',');
+        if (!FlexToJson(vector[i], json)) return false;
+      }
+      json->push_back(']');
+      return true;
+    }
+    default:
+      if (value.IsTypedVector()) {
+        const auto vector = value.AsTypedVector();
+        json->push_back('[');
+        for (size_t i = 0; i < vector.size(); i++) {
+          if (i) json->push_back(',');
+          if (!FlexToJson(vector[i], json)) return false;
+        }
+        json->push_back(']');
+        return true;
+      }
+      if (value.IsFixedTypedVector()) {
+        const auto vector = value.AsFixedTypedVector();
+        json->push_back('[');
+        for (size_t i = 0; i < vector.size(); i++) {
+          if (i) json->push_back(',');
+          if (!FlexToJson(vector[i], json)) return false;
+        }
+        json->push_back(']');
+        return true;
+      }
+      return false;
+  }
+}
+
+}  // namespace fbjson
@@ -0,0 +1,238 @@
+#include "fbjson/frozen_schema.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "flatbuffers/util.h"
+
+namespace fbjson {
+
+namespace {
+
+// Red-black tree node: color, parent, left, right, then the value.
+const size_t kMapNodeHeader = 32;
+// Longest string in the small string buffer.
+const size_t kSmallString = 15;
+
+size_t StringBytes(const std::string &s) {
+  return s.capacity() > kSmallString ? s.capacity() + 1 : 0;
+}
+
+template<typename T> size_t VectorBytes(const std::vector<T> &v) {
+  return v.capacity() * sizeof(T);
+}
+
+template<typename T>
+size_t SymbolTableBytes(const flatbuffers::SymbolTable<T> &table) {
+  auto bytes = VectorBytes(table.vec);
+  for (const auto &entry : table.dict) {
+    bytes += kMapNodeHeader + sizeof(entry) + StringBytes(entry.first);
+  }
+  return bytes;
+}
+
+size_t DocBytes(const std::vector<std::string> &doc) {
+  auto bytes = VectorBytes(doc);
+  for (const auto &line : doc) bytes += StringBytes(line);
+  return bytes;
+}
+
+void AddDefinition(const flatbuffers::Definition &def, SchemaMemory *memory) {
+  memory->strings += StringBytes(def.name) + StringBytes(def.file);
+  memory->docs += DocBytes(def.doc_comment);
+  memory->attributes += SymbolTableBytes(def.attributes);
+  for (const auto value : def.attributes.vec) {
+    memory->attributes += sizeof(*value) + StringBytes(value->constant);
+  }
+}
+
+// Default values are kept as written in the schema (hex, leading zeros).
+// Values above INT64_MAX (ulong) keep their bit pattern.
+int64_t DefaultInteger(const std::string &constant) {
+  const auto base =
+      constant.find_first_of("xX") != std::string::npos ? 16 : 10;
+  return constant[0] == '-'
+             ? std::strtoll(constant.c_str(), nullptr, base)
+             : static_cast<int64_t>(
+                   std::strtoull(constant.c_str(), nullptr, base));
+}
+
+}  // namespace
+
+SchemaMemory MeasureSchema(const flatbuffers::Parser &parser) {
+  SchemaMemory memory;
+  memory.symbols += SymbolTableBytes(parser.structs_) +
+                    SymbolTableBytes(parser.enums_) +
+                    SymbolTableBytes(parser.types_);
+  memory.symbols += parser.types_.vec.size() * sizeof(flatbuffers::Type);
+  for (const auto sd : parser.structs_.vec) {
+    memory.structs += sizeof(*sd);
+    if (sd->original_location) {
+      memory.strings += sizeof(std::string) +
+                        StringBytes(*sd->original_location);
+    }
+    AddDefinition(*sd, &memory);
+    memory.symbols += SymbolTableBytes(sd->fields);
+    for (const auto fd : sd->fields.vec) {
+      memory.fields += sizeof(*fd);
+      memory.strings += StringBytes(fd->value.constant);
+      AddDefinition(*fd, &memory);
+    }
+  }
+  for (const auto ed : parser.enums_.vec) {
+    memory.enums += sizeof(*ed);
+    AddDefinition(*ed, &memory);
+    memory.symbols += SymbolTableBytes(ed->vals);
+    for (const auto ev : ed->vals.vec) {
+      memory.enums += sizeof(*ev);
+      memory.strings += StringBytes(ev->name);
+      memory.docs += DocBytes(ev->doc_comment);
+    }
+  }
+  memory.strings += VectorBytes(parser.namespaces_);
+  for (const auto ns : parser.namespaces_) {
+    memory.strings += sizeof(*ns) + VectorBytes(ns->components);
+    for (const auto &component : ns->components) {
+      memory.strings += StringBytes(component);
+    }
+  }
+  return memory;
+}
+
+meta::Kind ToMetaKind(const flatbuffers::Type &type,
+                      flatbuffers::BaseType base_type) {
+  using meta::Kind;
+  switch (base_type) {
+    case flatbuffers::BASE_TYPE_NONE: return Kind::kNone;
+    case flatbuffers::BASE_TYPE_BOOL: return Kind::kBool;
+    case flatbuffers::BASE_TYPE_CHAR: return Kind::kByte;
+    case flatbuffers::BASE_TYPE_UCHAR: return Kind::kUByte;
+    case flatbuffers::BASE_TYPE_SHORT: return Kind::kShort;
+    case flatbuffers::BASE_TYPE_USHORT: return Kind::kUShort;
+    case flatbuffers::BASE_TYPE_INT: return Kind::kInt;
+    case flatbuffers::BASE_TYPE_UINT: return Kind::kUInt;
+    case flatbuffers::BASE_TYPE_LONG: return Kind::kLong;
+    case flatbuffers::BASE_TYPE_ULONG: return Kind::kULong;
+    case flatbuffers::BASE_TYPE_FLOAT: return Kind::kFloat;
+    case flatbuffers::BASE_TYPE_DOUBLE: return Kind::kDouble;
+    case flatbuffers::BASE_TYPE_STRING: return Kind::kString;
+    case flatbuffers::BASE_TYPE_VECTOR: return Kind::kVector;
+    case flatbuffers::BASE_TYPE_STRUCT:
+      return type.struct_def && !type.struct_def->fixed ? Kind::kTable
+                                                        : Kind::kUnsupported;
+    default: return Kind::kUnsupported;
+  }
+}
+
+FrozenSchema::FrozenSchema(const flatbuffers::Parser &parser) {
+  std::vector<const flatbuffers::StructDef *> tables;
+  std::vector<std::string> table_names;
+  std::unordered_map<const flatbuffers::StructDef *, int> positions;
+  size_t num_fields = 0, names = 0;
+  for (const auto sd : parser.structs_.vec) {
+    if (sd->fixed) continue;
+    positions[sd] = static_cast<int>(tables.size());
+    tables.push_back(sd);
+    table_names.push_back(
+        sd->defined_namespace
+            ? sd->defined_namespace->GetFullyQualifiedName(sd->name)
+            : sd->name);
+    names += table_names.back().size() + 1;
+    num_fields += sd->fields.vec.size();
+    for (const auto fd : sd->fields.vec) names += fd->name.size() + 1;
+  }
+  schema_.tables = nullptr;
+  schema_.num_tables = 0;
+  schema_.root = -1;
+  // `meta::Field::table` and the field indices are 16 bits
+  if (tables.size() > INT16_MAX) {
+    error_ = "too many tables to freeze: " +
+             flatbuffers::NumToString(tables.size()) + ", at most " +
+             flatbuffers::NumToString(INT16_MAX);
+    return;
+  }
+  for (size_t t = 0; t < tables.size(); t++) {
+    const auto fields = tables[t]->fields.vec.size();
+    if (fields > UINT16_MAX) {
+      error_ = "too many fields to freeze in " + table_names[t] + ": " +
+               flatbuffers::NumToString(fields) + ", at most " +
+               flatbuffers::NumToString(UINT16_MAX);
+      return;
+    }
+  }
+  // every part keeps the alignment of the next one
+  size_ = tables.size() * sizeof(meta::Table) +
+          num_fields * (sizeof(meta::Field) + sizeof(uint16_t)) + names;
+  arena_.reset(new char[size_]);
+  auto table_out = reinterpret_cast<meta::Table *>(arena_.get());
+  auto field_out = reinterpret_cast<meta::Field *>(table_out + tables.size());
+  auto by_hash_out = reinterpret_cast<uint16_t *>(field_out + num_fields);
+  auto name_out = reinterpret_cast<char *>(by_hash_out + num_fields);
+  auto copy_name = [&](const std::string &name) {
+    const auto copy = name_out;
+    std::memcpy(name_out, name.c_str(), name.size() + 1);
+    name_out += name.size() + 1;
+    return copy;
+  };
+  auto table_index = [&](const flatbuffers::StructDef *sd) {
+    const auto it = positions.find(sd);
+    return it == positions.end() ? -1 : it->second;
+  };
+
+  std::vector<std::pair<uint32_t, uint16_t>> hashes;
+  for (size_t t = 0; t < tables.size(); t++) {
+    const auto &defs = tables[t]->fields.vec;
+    auto table = new (table_out + t) meta::Table();
+    table->name = copy_name(table_names[t]);
+    table->num_fields = static_cast<uint16_t>(defs.size());
+    if (defs.empty()) continue;
+    table->fields = field_out;
+    table->by_hash = by_hash_out;
+    hashes.clear();
+    for (size_t i = 0; i < defs.size(); i++) {
+      const auto &fd = *defs[i];
+      const auto &type = fd.value.type;
+      auto field = new (field_out++) meta::Field();
+      field->name = copy_name(fd.name);
+      field->name_hash = meta::HashName(fd.name.c_str(), fd.name.size());
+      field->offset = fd.value.offset;
+      field->kind = ToMetaKind(type, type.base_type);
+      field->element = type.base_type == flatbuffers::BASE_TYPE_VECTOR
+                           ? ToMetaKind(type, type.element)
+                           : meta::Kind::kNone;
+      field->table = static_cast<int16_t>(table_index(type.struct_def));
+      const auto is_float = flatbuffers::IsFloat(type.base_type);
+      if (is_float) {
+        field->default_real = std::strtod(fd.value.constant.c_str(), nullptr);
+      } else if (flatbuffers::IsScalar(type.base_type)) {
+        field->default_integer = DefaultInteger(fd.value.constant);
+      }
+      field->required = fd.required;
+      field->deprecated = fd.deprecated;
+      field->flexbuffer = fd.flexbuffer;
+      hashes.emplace_back(field->name_hash, static_cast<uint16_t>(i));
+    }
+    std::stable_sort(hashes.begin(), hashes.end());
+    for (const auto &hash : hashes) *by_hash_out++ = hash.second;
+  }
+  schema_.tables = table_out;
+  schema_.num_tables = tables.size();
+  schema_.root = table_index(parser.root_struct_def_);
+  index_.reset(new SymbolIndex(parser, SymbolIndex::Scope::kTables));
+}
+
+int FrozenSchema::FindTable(const char *name) const {
+  return index_ ? index_->FindStruct(name, std::strlen(name)) : -1;
+}
+
+int FrozenSchema::FindField(int table, const char *name) const {
+  return index_ ? index_->FindField(table, name, std::strlen(name)) : -1;
+}
+
+}  // namespace fbjson
@@ -0,0 +1,246 @@
+#include "fbjson/include_cache.h"
+
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include "fbjson/binary_schema.h"
+#include "flatbuffers/util.h"
+
+namespace fbjson {
+
+namespace {
+
+// Skip whitespace and comments.
+const char *SkipSpace(const char *p) {
+  for (;;) {
+    if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+      p++;
+    } else if (p[0] == '/' && p[1] == '/') {
+      while (*p && *p != '\n') p++;
+    } else if (p[0] == '/' && p[1] == '*') {
+      const auto end = std::strstr(p + 2, "*/");
+      if (!end) return p;
+      p = end + 2;
+    } else {
+      return p;
+    }
+  }
+}
+
+// FNV-1a
+uint64_t HashBytes(const std::string &bytes) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const auto c : bytes) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// Options which change how declarations are read.
+std::string OptionsKey(const flatbuffers::IDLOptions &opts) {
+  std::string key;
+  for (const auto flag :
+       { opts.strict_json, opts.skip_unexpected_fields_in_json,
+         opts.union_value_namespacing, opts.allow_non_utf8,
+         opts.natural_utf8 }) {
+    key += flag ? '1' : '0';
+  }
+  return key;
+}
+
+}  // namespace
+
+IncludeCache &IncludeCache::Default() {
+  static IncludeCache cache;
+  return cache;
+}
+
+bool IncludeCache::ScanIncludes(const char *source, const char **include_paths,
+                                std::vector<std::string> *names,
+                                std::vector<std::string> *paths) {
+  static const char *current_directory[] = { "", nullptr };
+  if (!include_paths) include_paths = current_directory;
+  static const char kInclude[] = "include";
+  const auto include_len = sizeof(kInclude) - 1;
+  for (auto p = SkipSpace(source);; p = SkipSpace(p)) {
+    if (std::strncmp(p, kInclude, include_len) ||
+        std::isalnum(static_cast<unsigned char>(p[include_len])) ||
+        p[include_len] == '_') {
+      // declarations, `native_include` or the end of the schema
+      return true;
+    }
+    p = SkipSpace(p + include_len);
+    if (*p != '"') return false;
+    const auto end = std::strpbrk(p + 1, "\"\\\n");
+    // escapes are left to the parser
+    if (!end || *end != '"') return false;
+    std::string name(p + 1, end);
+    p = SkipSpace(end + 1);
+    if (*p++ != ';') return false;
+    // the first include path where the file exists, otherwise the last one
+    std::string path;
+    for (auto dir = include_paths; *dir; dir++) {
+      path = flatbuffers::ConCatPathFileName(*dir, name);
+      if (flatbuffers::FileExists(path.c_str())) break;
+    }
+    if (path.empty()) return false;
+    names->push_back(std::move(name));
+    paths->push_back(std::move(path));
+  }
+}
+
+bool IncludeCache::Stat(const std::string &path, File *file) {
+  std::error_code ec;
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) return false;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) return false;
+  file->mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+  file->size = static_cast<uint64_t>(size);
+  return true;
+}
+
+bool IncludeCache::Hash(const std::string &path, File *file) {
+  std::string contents;
+  if (!flatbuffers::LoadFile(path.c_str(), true, &contents)) return false;
+  file->size = contents.size();
+  file->hash = HashBytes(contents);
+  return true;
+}
+
+bool IncludeCache::IsValid(const Entry &entry) const {
+  for (const auto &file : entry.files) {
+    File current;
+    if (validation_ == Validation::kContentHash) {
+      if (!Hash(file.path, &current) || current.size != file.size ||
+          current.hash != file.hash) {
+        return false;
+      }
+    } else if (!Stat(file.path, &current) || current.mtime != file.mtime ||
+               current.size != file.size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<const IncludeCache::Entry> IncludeCache::Build(
+    const flatbuffers::IDLOptions &opts, const std::vector<std::string> &names,
+    const char **include_paths) const {
+  // A schema of the include statements only: the parser resolves nested
+  // includes against the include paths, not against the including file.
+  std::string includes;
+  for (const auto &name : names) includes += "include \"" + name + "\";\n";
+  flatbuffers::Parser parser(opts);
+  if (!parser.Parse(includes.c_str(), include_paths)) return nullptr;
+
+  // Files changed between the parse and the checks below are caught by the
+  // content hash only.
+  std::shared_ptr<Entry> entry(new Entry());
+  for (const auto &included : parser.included_files_) {
+    File file;
+    file.path = included.first;
+    file.mtime = 0;
+    file.hash = 0;
+    if (!Stat(file.path, &file)) return nullptr;
+    if (validation_ == Validation::kContentHash && !Hash(file.path, &file)) {
+      return nullptr;
+    }
+    entry->files.push_back(std::move(file));
+  }
+  // builtin attributes (`hash`, `nested_flatbuffer`, ...) are dropped
+  // from binary schemas by default
+  parser.opts.binary_schema_builtins = true;
+  parser.Serialize();
+  entry->bfbs.assign(
+      reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+      parser.builder_.GetSize());
+  entry->included_files = parser.included_files_;
+  entry->files_included_per_file = parser.files_included_per_file_;
+  entry->known_attributes = parser.known_attributes_;
+  return entry;
+}
+
+bool IncludeCache::Parse(flatbuffers::Parser *parser, const char *source,
+                         const char **include_paths,
+                         const char *source_filename) {
+  std::vector<std::string> names, paths;
+  if (parser->opts.proto_mode || !parser->structs_.vec.empty() ||
+      !parser->enums_.vec.empty() ||
+      !ScanIncludes(source, include_paths, &names, &paths) || names.empty()) {
+    return parser->Parse(source, include_paths, source_filename);
+  }
+  auto key = OptionsKey(parser->opts);
+  key += '\n';
+  for (auto dir = include_paths; dir && *dir; dir++) {
+    key += *dir;
+    key += '\n';
+  }
+  for (const auto &path : paths) {
+    key += '\n';
+    key += path;
+  }
+
+  std::shared_ptr<const Entry> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = entries_.find(key);
+    if (it != entries_.end()) entry = it->second;
+  }
+  // files are checked and parsed outside of the lock
+  const bool invalidated = entry && !IsValid(*entry);
+  if (!entry || invalidated) {
+    entry = Build(parser->opts, names, include_paths);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.misses++;
+    if (invalidated) stats_.invalidations++;
+    if (!entry) {
+      entries_.erase(key);
+    } else {
+      entries_[key] = entry;
+    }
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.hits++;
+  }
+  // a schema included by its own includes is parsed as an include
+  if (!entry || (source_filename &&
+                 entry->included_files.count(source_filename))) {
+    return parser->Parse(source, include_paths, source_filename);
+  }
+
+  std::string error;
+  if (!LoadBinarySchema(reinterpret_cast<const uint8_t *>(entry->bfbs.data()),
+                        entry->bfbs.size(), parser, &error)) {
+    parser->error_ = error;
+    return false;
+  }
+  // the parser skips includes of files it has already parsed
+  parser->included_files_.insert(entry->included_files.begin(),
+                                 entry->included_files.end());
+  parser->files_included_per_file_.insert(
+      entry->files_included_per_file.begin(),
+      entry->files_included_per_file.end());
+  parser->known_attributes_.insert(entry->known_attributes.begin(),
+                                   entry->known_attributes.end());
+  return parser->Parse(source, include_paths, source_filename);
+}
+
+IncludeCache::Stats IncludeCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+size_t IncludeCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void IncludeCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  stats_ = Stats();
+}
+
+}  // namespace fbjson
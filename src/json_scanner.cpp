@@ -0,0 +1,141 @@
+#include "fbjson/json_scanner.h"
+
+namespace fbjson {
+
+void JsonScanner::Reset() {
+  state_ = State::kValue;
+  quote_ = 0;
+  stack_.clear();
+  error_ = nullptr;
+}
+
+JsonScanner::Status JsonScanner::Fail(const char *error) {
+  state_ = State::kError;
+  error_ = error;
+  return Status::kError;
+}
+
+JsonScanner::Status JsonScanner::Scan(const char *data, size_t size,
+                                      size_t *consumed) {
+  *consumed = 0;
+  if (state_ == State::kDone) return Status::kComplete;
+  if (state_ == State::kError) return Status::kError;
+  for (size_t i = 0; i < size; i++) {
+    const auto c = data[i];
+    switch (state_) {
+      case State::kString:
+        if (c == '\\') {
+          state_ = State::kEscape;
+        } else if (c == quote_) {
+          state_ = State::kValue;
+        }
+        break;
+      case State::kEscape: state_ = State::kString; break;
+      case State::kSlash:
+        if (c == '/') {
+          state_ = State::kLineComment;
+        } else if (c == '*') {
+          state_ = State::kBlockComment;
+        } else {
+          *consumed = i;
+          return Fail("illegal character: /");
+        }
+        break;
+      case State::kLineComment:
+        if (c == '\n') state_ = State::kValue;
+        break;
+      case State::kBlockComment:
+        if (c == '*') state_ = State::kBlockCommentStar;
+        break;
+      case State::kBlockCommentStar:
+        if (c == '/') {
+          state_ = State::kValue;
+        } else if (c != '*') {
+          state_ = State::kBlockComment;
+        }
+        break;
+      case State::kValue:
+        switch (c) {
+          case ' ':
+          case '\t':
+          case '\r':
+          case '\n': break;
+          case '/': state_ = State::kSlash; break;
+          case '{': stack_.push_back('}'); break;
+          case '[': stack_.push_back(']'); break;
+          case '}':
+          case ']':
+            *consumed = i;
+            if (stack_.empty()) return Fail("unexpected closing bracket");
+            if (stack_.back() != c) return Fail("mismatched closing bracket");
+            stack_.pop_back();
+            if (stack_.empty()) {
+              *consumed = i + 1;
+              state_ = State::kDone;
+              return Status::kComplete;
+            }
+            break;
+          case '"':
+          case '\'':
+            if (stack_.empty()) {
+              *consumed = i;
+              return Fail("root value must be an object or an array");
+            }
+            quote_ = c;
+            state_ = State::kString;
+            break;
+          default:
+            // Other bytes are left to the parser, including bytes before
+            // the root value (e.g. a byte order mark).
+            break;
+        }
+        break;
+      case State::kDone:
+      case State::kError: break;
+    }
+  }
+  *consumed = size;
+  return Status::kNeedMoreData;
+}
+
+bool JsonScanner::IsBlank(const char *data, size_t size) {
+  auto state = State::kValue;
+  for (size_t i = 0; i < size; i++) {
+    const auto c = data[i];
+    switch (state) {
+      case State::kValue:
+        if (c == '/') {
+          state = State::kSlash;
+        } else if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+          return false;
+        }
+        break;
+      case State::kSlash:
+        if (c == '/') {
+          state = State::kLineComment;
+        } else if (c == '*') {
+          state = State::kBlockComment;
+        } else {
+          return false;
+        }
+        break;
+      case State::kLineComment:
+        if (c == '\n') state = State::kValue;
+        break;
+      case State::kBlockComment:
+        if (c == '*') state = State::kBlockCommentStar;
+        break;
+      case State::kBlockCommentStar:
+        if (c == '/') {
+          state = State::kValue;
+        } else if (c != '*') {
+          state = State::kBlockComment;
+        }
+        break;
+      default: return false;
+    }
+  }
+  return state == State::kValue || state == State::kLineComment;
+}
+
+}  // namespace fbjson
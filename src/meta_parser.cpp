@@ -0,0 +1,676 @@
+#include "fbjson/meta_parser.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "fbjson/string_scan.h"
+#include "flatbuffers/util.h"
+
+namespace fbjson {
+
+namespace {
+
+// Same limit as `flatbuffers::Parser`.
+const int kMaxDepth = 64;
+
+bool IsDelimiter(char c) {
+  return c == ',' || c == ']' || c == '}' || c == ' ' || c == '\t' ||
+         c == '\r' || c == '\n' || c == ':' || c == '\0';
+}
+
+int HexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Exactly four hex digits, without the sign, spaces or "0x" `strtoul` takes.
+bool Hex4(const char **p, uint32_t *ucc) {
+  *ucc = 0;
+  for (int i = 0; i < 4; i++) {
+    const auto d = HexDigit((*p)[i]);
+    if (d < 0) return false;
+    *ucc = (*ucc << 4) | static_cast<uint32_t>(d);
+  }
+  *p += 4;
+  return true;
+}
+
+// Scalar token `Parser::SkipAnyJsonValue` accepts for an unknown field: a
+// number or one of the literals.
+bool IsScalarLiteral(const char *begin, const char *end) {
+  const std::string token(begin, end);
+  if (token == "true" || token == "false" || token == "null") return true;
+  const auto c = token[0];
+  if (!(c >= '0' && c <= '9') && c != '-' && c != '+' && c != '.') {
+    return false;
+  }
+  char *parsed = nullptr;
+  std::strtod(token.c_str(), &parsed);
+  return parsed == token.c_str() + token.size();
+}
+
+template<typename T> bool InRange(int64_t v) {
+  return v >= static_cast<int64_t>(std::numeric_limits<T>::min()) &&
+         v <= static_cast<int64_t>(std::numeric_limits<T>::max());
+}
+
+}  // namespace
+
+using meta::Kind;
+
+bool MetaParser::Error(const std::string &message) {
+  error_ = "error: " + message;
+  return false;
+}
+
+void MetaParser::SkipWhitespace() {
+  while (*cursor_ == ' ' || *cursor_ == '\t' || *cursor_ == '\r' ||
+         *cursor_ == '\n') {
+    cursor_++;
+  }
+}
+
+bool MetaParser::Expect(char c) {
+  SkipWhitespace();
+  if (*cursor_ != c) {
+    return Error(std::string("expecting: ") + c + " instead got: " +
+                 (*cursor_ ? std::string(1, *cursor_) : "end of file"));
+  }
+  cursor_++;
+  return true;
+}
+
+bool MetaParser::SetProjection(const std::vector<std::string> &fields) {
+  projection_.clear();
+  if (fields.empty()) return true;
+  std::vector<std::vector<bool>> projection(schema_.num_tables);
+  for (const auto &name : fields) {
+    const auto dot = name.rfind('.');
+    auto found = false;
+    for (size_t t = 0; t < schema_.num_tables && dot != std::string::npos;
+         t++) {
+      const auto &table = schema_.tables[t];
+      if (name.compare(0, dot, table.name)) continue;
+      const auto field =
+          table.Lookup(name.c_str() + dot + 1, name.size() - dot - 1);
+      if (!field) break;
+      projection[t].resize(table.num_fields);
+      projection[t][field - table.fields] = true;
+      found = true;
+    }
+    if (!found) return Error("unknown field in projection: " + name);
+  }
+  projection_.swap(projection);
+  return true;
+}
+
+bool MetaParser::Parse(const char *json, int root,
+                       const char *file_identifier) {
+#ifdef FBJSON_PARSE_STATS
+  // lexing is the time not spent in the other phases
+  const auto lex = stats_.cycles[ParseStats::kLex];
+  const auto others = stats_.TotalCycles() - lex;
+  const auto start = ReadCycleCounter();
+  const auto done = ParseRoot(json, root, file_identifier);
+  const auto elapsed = ReadCycleCounter() - start;
+  const auto measured = stats_.TotalCycles() - lex - others;
+  if (elapsed > measured) stats_.cycles[ParseStats::kLex] += elapsed - measured;
+  return done;
+#else
+  return ParseRoot(json, root, file_identifier);
+#endif
+}
+
+bool MetaParser::ParseRoot(const char *json, int root,
+                           const char *file_identifier) {
+  builder_.SetVtableDedup(opts.vtable_dedup);
+  builder_.Clear();
+  stack_.clear();
+  error_.clear();
+  depth_ = 0;
+  cursor_ = json;
+  std::fill(shared_strings_.begin(), shared_strings_.end(), SharedString());
+  num_shared_strings_ = 0;
+  unknown_.clear();
+  if (opts.keep_unknown_fields && flexbuffer_fields_.empty()) {
+    flexbuffer_fields_.resize(schema_.num_tables);
+    for (size_t t = 0; t < schema_.num_tables; t++) {
+      const auto &table = schema_.tables[t];
+      for (uint16_t i = 0; i < table.num_fields; i++) {
+        const auto &field = table.fields[i];
+        if (field.flexbuffer) flexbuffer_fields_[t] = &field;
+      }
+    }
+  }
+  if (root < 0) root = schema_.root;
+  if (root < 0 || static_cast<size_t>(root) >= schema_.num_tables) {
+    return Error("no root type set to parse json with");
+  }
+  flatbuffers::uoffset_t root_offset;
+  if (!ParseTable(schema_.tables[root], &root_offset)) return false;
+  SkipWhitespace();
+  if (*cursor_) return Error("unexpected data after the root value");
+  builder_.Finish(flatbuffers::Offset<flatbuffers::Table>(root_offset),
+                  file_identifier);
+  return true;
+}
+
+bool MetaParser::ParseTable(const meta::Table &table,
+                            flatbuffers::uoffset_t *out) {
+  if (++depth_ > kMaxDepth) return Error("maximum nesting depth reached");
+  SkipWhitespace();
+  const auto base = stack_.size();
+  // fields to build, null if all
+  const std::vector<bool> *projection = nullptr;
+  if (!projection_.empty() && !projection_[&table - schema_.tables].empty()) {
+    projection = &projection_[&table - schema_.tables];
+  }
+  // field for unknown fields, null if they are skipped
+  const meta::Field *flexbuffer = nullptr;
+  if (opts.keep_unknown_fields) {
+    flexbuffer = flexbuffer_fields_[&table - schema_.tables];
+  }
+  const auto unknown_base = unknown_.size();
+  const auto object = *cursor_ == '{';
+  if (!object && *cursor_ != '[') return Error("expecting: { or [");
+  const char close = object ? '}' : ']';
+  cursor_++;
+  SkipWhitespace();
+  for (uint16_t n = 0; *cursor_ != close; n++) {
+    const meta::Field *field = nullptr;
+    if (object) {
+      SkipWhitespace();
+      if (*cursor_ != '"') return Error("expecting: string constant");
+      if (!ParseString(&string_) || !Expect(':')) return false;
+      FBJSON_PARSE_STATS_SCOPE(stats_, kFieldLookup);
+      field = table.Lookup(string_.data(), string_.size());
+    } else {
+      if (n >= table.num_fields) {
+        return Error("too many fields in table " + std::string(table.name));
+      }
+      field = &table.fields[n];
+    }
+    if (!field && flexbuffer) {
+      // the builder reads keys up to the first zero
+      string_.resize(std::strlen(string_.c_str()));
+      for (auto i = unknown_base; i < unknown_.size(); i++) {
+        if (unknown_[i].key == string_) {
+          return Error("field set more than once: " + string_);
+        }
+      }
+      SkipWhitespace();
+      unknown_.push_back({ string_, cursor_ });
+      // validated when the FlexBuffer is built
+      if (!SkipValue(false)) return false;
+    } else if (!field || field->deprecated) {
+      if (!SkipValue()) return false;
+    } else if (projection && !(*projection)[field - table.fields]) {
+      if (!SkipValue(false)) return false;
+    } else {
+      for (auto i = base; i < stack_.size(); i++) {
+        if (stack_[i].field == field) {
+          return Error("field set more than once: " +
+                       std::string(field->name));
+        }
+      }
+      if (!ParseField(*field)) return false;
+    }
+    SkipWhitespace();
+    if (*cursor_ == ',') {
+      cursor_++;
+      SkipWhitespace();
+      if (*cursor_ == close) return Error("unexpected trailing comma");
+    } else if (*cursor_ != close) {
+      return Expect(close);
+    }
+  }
+  cursor_++;
+  if (unknown_.size() > unknown_base) {
+    for (auto i = base; i < stack_.size(); i++) {
+      if (stack_[i].field == flexbuffer) {
+        return Error("field set more than once: " +
+                     std::string(flexbuffer->name));
+      }
+    }
+    FieldValue value;
+    value.field = flexbuffer;
+    value.kind = Kind::kVector;
+    if (!BuildUnknownFields(unknown_base, &value.o)) return false;
+    stack_.push_back(value);
+    unknown_.resize(unknown_base);
+  }
+  for (uint16_t i = 0; i < table.num_fields; i++) {
+    const auto &field = table.fields[i];
+    if (!field.required || (projection && !(*projection)[i])) continue;
+    auto found = false;
+    for (auto j = base; j < stack_.size(); j++) {
+      found = found || stack_[j].field == &field;
+    }
+    if (!found) {
+      return Error("required field is missing: " + std::string(field.name) +
+                   " in " + table.name);
+    }
+  }
+  // Write fields like `flatbuffers::Parser` does: largest first, in reverse
+  // order of appearance.
+  flatbuffers::uoffset_t start;
+  {
+    FBJSON_PARSE_STATS_SCOPE(stats_, kVtable);
+    start = builder_.StartTable();
+  }
+  {
+    FBJSON_PARSE_STATS_SCOPE(stats_, kBuilder);
+    for (size_t size = sizeof(flatbuffers::largest_scalar_t); size;
+         size /= 2) {
+      for (auto i = stack_.size(); i > base; i--) {
+        const auto &value = stack_[i - 1];
+        if (meta::SizeOf(value.kind) != size) continue;
+        if (meta::IsScalar(value.kind)) {
+          WriteScalar(value);
+        } else {
+          builder_.AddOffset(value.field->offset,
+                             flatbuffers::Offset<void>(value.o));
+        }
+      }
+    }
+  }
+  {
+    FBJSON_PARSE_STATS_SCOPE(stats_, kVtable);
+    *out = builder_.EndTable(start);
+  }
+  stack_.resize(base);
+  depth_--;
+  return true;
+}
+
+bool MetaParser::ParseField(const meta::Field &field) {
+  FBJSON_PARSE_STATS_EVENT(stats_, kLex);
+  SkipWhitespace();
+  if (!std::strncmp(cursor_, "null", 4) && IsDelimiter(cursor_[4])) {
+    // same as absent field
+    cursor_ += 4;
+    return true;
+  }
+  FieldValue value;
+  value.field = &field;
+  value.kind = field.kind;
+  if (field.flexbuffer) {
+    if (!ParseFlexBuffer(&value.o)) return false;
+  } else if (field.kind == Kind::kVector) {
+    if (!ParseVector(field, &value.o)) return false;
+  } else if (!ParseValue(field.kind, field.table, &value)) {
+    return false;
+  }
+  stack_.push_back(value);
+  return true;
+}
+
+bool MetaParser::ParseValue(Kind kind, int table, FieldValue *value) {
+  switch (kind) {
+    case Kind::kString: {
+      if (!ParseString(&string_)) return false;
+      FBJSON_PARSE_STATS_SCOPE(stats_, kBuilder);
+      value->o = opts.share_strings ? CreateSharedString(string_)
+                                    : builder_.CreateString(string_).o;
+      return true;
+    }
+    case Kind::kTable:
+      return ParseTable(schema_.tables[table], &value->o);
+    case Kind::kNone:
+    case Kind::kVector:
+    case Kind::kUnsupported:
+      return Error("type isn't supported by the metadata parser: " +
+                   std::string(value->field->name));
+    default: return ParseScalar(kind, value);
+  }
+}
+
+flatbuffers::uoffset_t MetaParser::CreateSharedString(const std::string &s) {
+  // keep the load factor at most 1/2
+  if (2 * (num_shared_strings_ + 1) > shared_strings_.size()) {
+    std::vector<SharedString> slots(
+        std::max<size_t>(64, 2 * shared_strings_.size()), SharedString());
+    const auto mask = slots.size() - 1;
+    for (const auto &slot : shared_strings_) {
+      if (!slot.offset) continue;
+      auto i = slot.hash & mask;
+      while (slots[i].offset) i = (i + 1) & mask;
+      slots[i] = slot;
+    }
+    shared_strings_.swap(slots);
+  }
+  const auto hash = meta::HashName(s.data(), s.size());
+  const auto mask = shared_strings_.size() - 1;
+  auto i = hash & mask;
+  for (; shared_strings_[i].offset; i = (i + 1) & mask) {
+    const auto &slot = shared_strings_[i];
+    if (slot.hash != hash) continue;
+    const auto str = reinterpret_cast<const flatbuffers::String *>(
+        builder_.GetCurrentBufferPointer() + builder_.GetSize() - slot.offset);
+    if (str->size() == s.size() && !std::memcmp(str->c_str(), s.data(),
+                                                 s.size())) {
+      return slot.offset;
+    }
+  }
+  const auto offset = builder_.CreateString(s).o;
+  shared_strings_[i] = { hash, offset };
+  num_shared_strings_++;
+  return offset;
+}
+
+bool MetaParser::ParseVector(const meta::Field &field,
+                             flatbuffers::uoffset_t *out) {
+  if (!Expect('[')) return false;
+  const auto base = stack_.size();
+  SkipWhitespace();
+  while (*cursor_ != ']') {
+    FieldValue value;
+    value.field = &field;
+    value.kind = field.element;
+    if (!ParseValue(field.element, field.table, &value)) return false;
+    stack_.push_back(value);
+    SkipWhitespace();
+    if (*cursor_ == ',') {
+      cursor_++;
+      SkipWhitespace();
+      if (*cursor_ == ']') return Error("unexpected trailing comma");
+    } else if (*cursor_ != ']') {
+      return Expect(']');
+    }
+  }
+  cursor_++;
+  const auto count = stack_.size() - base;
+  FBJSON_PARSE_STATS_SCOPE(stats_, kBuilder);
+  builder_.StartVector(count, meta::SizeOf(field.element));
+  // start at the back, since the data is built backwards
+  for (auto i = stack_.size(); i > base; i--) {
+    const auto &value = stack_[i - 1];
+    if (meta::IsScalar(value.kind)) {
+      PushScalar(value);
+    } else {
+      builder_.PushElement(flatbuffers::Offset<void>(value.o));
+    }
+  }
+  *out = builder_.EndVector(count);
+  stack_.resize(base);
+  return true;
+}
+
+bool MetaParser::ParseFlexBuffer(flatbuffers::uoffset_t *out) {
+  flex_.builder_.Clear();
+  const auto end = flex_.ParseValue(cursor_);
+  if (!end) {
+    error_ = flex_.error_;
+    return false;
+  }
+  cursor_ = end;
+  return FinishFlexBuffer(out);
+}
+
+bool MetaParser::BuildUnknownFields(size_t base,
+                                    flatbuffers::uoffset_t *out) {
+  auto &fb = flex_.builder_;
+  fb.Clear();
+  const auto map = fb.StartMap();
+  for (auto i = base; i < unknown_.size(); i++) {
+    if (!flex_.ParseValue(unknown_[i].value, unknown_[i].key.c_str())) {
+      error_ = flex_.error_;
+      return false;
+    }
+  }
+  fb.EndMap(map);
+  return FinishFlexBuffer(out);
+}
+
+bool MetaParser::FinishFlexBuffer(flatbuffers::uoffset_t *out) {
+  flex_.builder_.Finish();
+  FBJSON_PARSE_STATS_SCOPE(stats_, kBuilder);
+  *out = builder_.CreateVector(flex_.builder_.GetBuffer()).o;
+  return true;
+}
+
+bool MetaParser::ParseScalar(Kind kind, FieldValue *value) {
+  SkipWhitespace();
+  FBJSON_PARSE_STATS_SCOPE(stats_, kNumber);
+  const auto begin = cursor_;
+  auto end = begin;
+  while (!IsDelimiter(*end)) end++;
+  if (end == begin) {
+    return Error("cannot parse value starting with: " +
+                 (*begin ? std::string(1, *begin) : "end of file"));
+  }
+  const std::string token(begin, end);
+  cursor_ = end;
+  if (token == "true" || token == "false") {
+    if (kind == Kind::kFloat || kind == Kind::kDouble) {
+      return Error("expecting a number instead got: " + token);
+    }
+    value->i = token == "true" ? 1 : 0;
+    return true;
+  }
+  char *parsed = nullptr;
+  errno = 0;
+  if (kind == Kind::kFloat || kind == Kind::kDouble) {
+    value->d = std::strtod(token.c_str(), &parsed);
+  } else {
+    const auto hex = token.find_first_of("xX") != std::string::npos;
+    if (kind == Kind::kULong) {
+      if (token[0] == '-') return Error("constant does not fit: " + token);
+      value->u = std::strtoull(token.c_str(), &parsed, hex ? 16 : 10);
+    } else {
+      value->i = std::strtoll(token.c_str(), &parsed, hex ? 16 : 10);
+    }
+  }
+  if (parsed != token.c_str() + token.size()) {
+    return Error("invalid number: " + token);
+  }
+  auto fits = errno != ERANGE;
+  switch (kind) {
+    case Kind::kBool: fits = fits && InRange<uint8_t>(value->i); break;
+    case Kind::kByte: fits = fits && InRange<int8_t>(value->i); break;
+    case Kind::kUByte: fits = fits && InRange<uint8_t>(value->i); break;
+    case Kind::kShort: fits = fits && InRange<int16_t>(value->i); break;
+    case Kind::kUShort: fits = fits && InRange<uint16_t>(value->i); break;
+    case Kind::kInt: fits = fits && InRange<int32_t>(value->i); break;
+    case Kind::kUInt: fits = fits && InRange<uint32_t>(value->i); break;
+    default: break;
+  }
+  return fits || Error("constant does not fit: " + token);
+}
+
+bool MetaParser::ParseString(std::string *out) {
+  SkipWhitespace();
+  FBJSON_PARSE_STATS_SCOPE(stats_, kString);
+  if (*cursor_ != '"') return Error("expecting: string constant");
+  cursor_++;
+  out->clear();
+  for (;;) {
+    // copy the run of plain characters at once
+    const auto run = SkipPlain(cursor_);
+    out->append(cursor_, run);
+    cursor_ = run;
+    const auto c = static_cast<unsigned char>(*cursor_);
+    if (c == '"') {
+      cursor_++;
+      return true;
+    }
+    // UTF-8 or DEL
+    if (c >= 0x7f) {
+      const auto start = cursor_;
+      if (flatbuffers::FromUTF8(&cursor_) < 0) {
+        return Error("illegal UTF-8 sequence");
+      }
+      out->append(start, cursor_);
+      continue;
+    }
+    if (c < 0x20) {
+      return Error(c ? "illegal character in string constant"
+                     : "unexpected end of string");
+    }
+    // escape sequence
+    cursor_++;
+    switch (*cursor_++) {
+      case '"': out->push_back('"'); break;
+      case '\\': out->push_back('\\'); break;
+      case '/': out->push_back('/'); break;
+      case 'b': out->push_back('\b'); break;
+      case 'f': out->push_back('\f'); break;
+      case 'n': out->push_back('\n'); break;
+      case 'r': out->push_back('\r'); break;
+      case 't': out->push_back('\t'); break;
+      case 'u': {
+        uint32_t ucc = 0;
+        if (!Hex4(&cursor_, &ucc)) {
+          return Error("invalid \\u escape in string constant");
+        }
+        if (ucc >= 0xD800 && ucc < 0xDC00) {
+          // surrogate pair
+          uint32_t low = 0;
+          if (cursor_[0] != '\\' || cursor_[1] != 'u' ||
+              (cursor_ += 2, !Hex4(&cursor_, &low)) || low < 0xDC00 ||
+              low > 0xDFFF) {
+            return Error("illegal Unicode sequence (unpaired high surrogate)");
+          }
+          ucc = 0x10000 + ((ucc - 0xD800) << 10) + (low - 0xDC00);
+        } else if (ucc >= 0xDC00 && ucc <= 0xDFFF) {
+          return Error("illegal Unicode sequence (unpaired low surrogate)");
+        }
+        flatbuffers::ToUTF8(ucc, out);
+        break;
+      }
+      default: return Error("unknown escape code in string constant");
+    }
+  }
+}
+
+bool MetaParser::SkipString() {
+  if (*cursor_ != '"') return Error("expecting: string constant");
+  auto p = cursor_ + 1;
+  for (;;) {
+    p += std::strcspn(p, "\"\\");
+    if (*p == '"') {
+      cursor_ = p + 1;
+      return true;
+    }
+    if (!*p || !p[1]) return Error("unexpected end of string");
+    // escape sequence
+    p += 2;
+  }
+}
+
+bool MetaParser::SkipValue(bool validate) {
+  FBJSON_PARSE_STATS_EVENT(stats_, kLex);
+  SkipWhitespace();
+  const auto c = *cursor_;
+  if (c == '"') return validate ? ParseString(&string_) : SkipString();
+  if (c != '{' && c != '[') {
+    const auto begin = cursor_;
+    while (!IsDelimiter(*cursor_)) cursor_++;
+    if (cursor_ == begin) {
+      return Error("cannot parse value starting with: " +
+                   (c ? std::string(1, c) : "end of file"));
+    }
+    return !validate || IsScalarLiteral(begin, cursor_) ||
+           Error("cannot parse value: " + std::string(begin, cursor_));
+  }
+  if (++depth_ > kMaxDepth) return Error("maximum nesting depth reached");
+  const char close = c == '{' ? '}' : ']';
+  cursor_++;
+  SkipWhitespace();
+  while (*cursor_ != close) {
+    if (close == '}') {
+      SkipWhitespace();
+      if (!(validate ? ParseString(&string_) : SkipString()) ||
+          !Expect(':')) {
+        return false;
+      }
+    }
+    if (!SkipValue(validate)) return false;
+    SkipWhitespace();
+    if (*cursor_ == ',') {
+      cursor_++;
+      SkipWhitespace();
+      if (*cursor_ == close) return Error("unexpected trailing comma");
+    } else if (*cursor_ != close) {
+      return Expect(close);
+    }
+  }
+  cursor_++;
+  depth_--;
+  return true;
+}
+
+void MetaParser::WriteScalar(const FieldValue &v) {
+  const auto &f = *v.field;
+  const auto o = f.offset;
+  const auto di = f.default_integer;
+  switch (v.kind) {
+    case Kind::kBool:
+      builder_.AddElement<uint8_t>(o, static_cast<uint8_t>(v.i),
+                                   static_cast<uint8_t>(di));
+      break;
+    case Kind::kByte:
+      builder_.AddElement<int8_t>(o, static_cast<int8_t>(v.i),
+                                  static_cast<int8_t>(di));
+      break;
+    case Kind::kUByte:
+      builder_.AddElement<uint8_t>(o, static_cast<uint8_t>(v.i),
+                                   static_cast<uint8_t>(di));
+      break;
+    case Kind::kShort:
+      builder_.AddElement<int16_t>(o, static_cast<int16_t>(v.i),
+                                   static_cast<int16_t>(di));
+      break;
+    case Kind::kUShort:
+      builder_.AddElement<uint16_t>(o, static_cast<uint16_t>(v.i),
+                                    static_cast<uint16_t>(di));
+      break;
+    case Kind::kInt:
+      builder_.AddElement<int32_t>(o, static_cast<int32_t>(v.i),
+                                   static_cast<int32_t>(di));
+      break;
+    case Kind::kUInt:
+      builder_.AddElement<uint32_t>(o, static_cast<uint32_t>(v.i),
+                                    static_cast<uint32_t>(di));
+      break;
+    case Kind::kLong: builder_.AddElement<int64_t>(o, v.i, di); break;
+    case Kind::kULong:
+      builder_.AddElement<uint64_t>(o, v.u, static_cast<uint64_t>(di));
+      break;
+    case Kind::kFloat:
+      builder_.AddElement<float>(o, static_cast<float>(v.d),
+                                 static_cast<float>(f.default_real));
+      break;
+    case Kind::kDouble:
+      builder_.AddElement<double>(o, v.d, f.default_real);
+      break;
+    default: break;
+  }
+}
+
+void MetaParser::PushScalar(const FieldValue &v) {
+  switch (v.kind) {
+    case Kind::kBool:
+    case Kind::kUByte:
+      builder_.PushElement(static_cast<uint8_t>(v.i));
+      break;
+    case Kind::kByte: builder_.PushElement(static_cast<int8_t>(v.i)); break;
+    case Kind::kShort: builder_.PushElement(static_cast<int16_t>(v.i)); break;
+    case Kind::kUShort:
+      builder_.PushElement(static_cast<uint16_t>(v.i));
+      break;
+    case Kind::kInt: builder_.PushElement(static_cast<int32_t>(v.i)); break;
+    case Kind::kUInt: builder_.PushElement(static_cast<uint32_t>(v.i)); break;
+    case Kind::kLong: builder_.PushElement(v.i); break;
+    case Kind::kULong: builder_.PushElement(v.u); break;
+    case Kind::kFloat: builder_.PushElement(static_cast<float>(v.d)); break;
+    case Kind::kDouble: builder_.PushElement(v.d); break;
+    default: break;
+  }
+}
+
+}  // namespace fbjson
@@ -0,0 +1,103 @@
+#include "fbjson/output_size.h"
+
+#include <algorithm>
+
+namespace fbjson {
+
+namespace {
+
+// Assumed length of a non-scalar JSON value (string, vector, table) for
+// the schema estimate.
+const double kValueLength = 16;
+// Learned ratios are increased by this factor to cover variance.
+const double kHeadroom = 1.125;
+const size_t kMinReserve = 64;
+
+}  // namespace
+
+uint8_t *CountingAllocator::allocate(size_t size) {
+  allocations_++;
+  return new uint8_t[size];
+}
+
+void CountingAllocator::deallocate(uint8_t *p, size_t) { delete[] p; }
+
+uint8_t *CountingAllocator::reallocate_downward(uint8_t *old_p,
+                                                size_t old_size,
+                                                size_t new_size,
+                                                size_t in_use_back,
+                                                size_t in_use_front) {
+  grows_++;
+  bytes_copied_ += in_use_back + in_use_front;
+  return Allocator::reallocate_downward(old_p, old_size, new_size,
+                                        in_use_back, in_use_front);
+}
+
+double OutputSizeEstimator::SchemaRatio(const flatbuffers::StructDef &root) {
+  // root offset, vtable header and soffset to the vtable
+  double output = 4 + 4 + 4;
+  // braces
+  double input = 2;
+  for (const auto field : root.fields.vec) {
+    if (field->deprecated) continue;
+    const auto &type = field->value.type;
+    // "name": value,
+    input += field->name.size() + 5;
+    output += sizeof(flatbuffers::voffset_t);
+    if (flatbuffers::IsScalar(type.base_type)) {
+      input += 4;
+      output += flatbuffers::SizeOf(type.base_type);
+    } else {
+      input += kValueLength;
+      // offset, length and the data itself
+      output += 4 + 4 + kValueLength;
+    }
+  }
+  return output / input;
+}
+
+size_t OutputSizeEstimator::Estimate(const flatbuffers::StructDef &root,
+                                     size_t json_size) {
+  auto &ratio = ratios_[&root];
+  if (!ratio.documents) ratio.value = SchemaRatio(root);
+  return std::max(kMinReserve,
+                  static_cast<size_t>(ratio.value * kHeadroom * json_size));
+}
+
+void OutputSizeEstimator::Learn(const flatbuffers::StructDef &root,
+                                size_t json_size, size_t output_size) {
+  if (!json_size) return;
+  auto &ratio = ratios_[&root];
+  const auto value = static_cast<double>(output_size) / json_size;
+  // exponential moving average, but never below the latest document
+  ratio.value =
+      ratio.documents ? std::max(value, (3 * ratio.value + value) / 4) : value;
+  ratio.documents++;
+}
+
+bool OutputSizeEstimator::Parse(flatbuffers::Parser *parser, const char *json,
+                                size_t json_size,
+                                flatbuffers::Allocator *allocator) {
+  const auto root = parser->root_struct_def_;
+  if (!root) return parser->Parse(json);
+  const auto estimate = Estimate(*root, json_size);
+  auto &builder = parser->builder_;
+  auto &reserved = reserved_[&builder];
+  // `Clear` keeps the buffer unless it was released, keep using it while it
+  // is large enough for the estimate
+  builder.Clear();
+  if (!builder.GetCurrentBufferPointer() || reserved.allocator != allocator ||
+      reserved.bytes < estimate) {
+    builder = flatbuffers::FlatBufferBuilder(estimate, allocator);
+    builder.ForceDefaults(parser->opts.force_defaults);
+    reserved.allocator = allocator;
+    reserved.bytes = estimate;
+  }
+  if (!parser->Parse(json)) return false;
+  // the buffer grew to at least the output size
+  reserved.bytes = std::max<size_t>(reserved.bytes, builder.GetSize());
+  Learn(*root, json_size, builder.GetSize());
+  return true;
+}
+
+}  // namespace fbjson
@@ -0,0 +1,232 @@
+#include "fbjson/parallel_array.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include "flatbuffers/reflection.h"
+
+namespace fbjson {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Position of the quote which closes a string, `p` points after the opening
+// quote. Returns `end` if the string is unterminated.
+const char *SkipString(const char *p, const char *end, char quote) {
+  const auto begin = p;
+  for (;;) {
+    p = static_cast<const char *>(std::memchr(p, quote, end - p));
+    if (!p) return end;
+    auto q = p;
+    while (q > begin && q[-1] == '\\') q--;
+    if ((p - q) % 2 == 0) return p;
+    p++;
+  }
+}
+
+// Elements claimed by a worker at once.
+const size_t kBatch = 32;
+
+}  // namespace
+
+bool SplitArray(const char *json, size_t size,
+                std::vector<ArrayElement> *elements, std::string *error) {
+  elements->clear();
+  const auto end = json + size;
+  auto fail = [&](const char *message, const char *at) {
+    *error = std::string(message) + " at offset " + std::to_string(at - json);
+    return false;
+  };
+  auto p = json;
+  while (p < end && IsSpace(*p)) p++;
+  if (p == end || *p != '[') return fail("root value must be an array", p);
+  // closing brackets of the containers open in the current element
+  std::vector<char> stack;
+  // first and last non-space bytes of the current element
+  const char *first = nullptr, *last = nullptr;
+  auto after_comma = false, closed = false;
+  for (p++; p < end && !closed; p++) {
+    const auto c = *p;
+    if (IsSpace(c)) continue;
+    if (stack.empty() && (c == ',' || c == ']')) {
+      if (first) {
+        elements->push_back({ static_cast<size_t>(first - json),
+                              static_cast<size_t>(last + 1 - first) });
+        first = nullptr;
+      } else if (c == ',' || after_comma) {
+        return fail("empty array element", p);
+      }
+      after_comma = c == ',';
+      closed = c == ']';
+      continue;
+    }
+    if (!first) first = p;
+    switch (c) {
+      case '"':
+      case '\'':
+        p = SkipString(p + 1, end, c);
+        if (p == end) return fail("unterminated string", first);
+        break;
+      case '{': stack.push_back('}'); break;
+      case '[': stack.push_back(']'); break;
+      case '}':
+      case ']':
+        if (stack.empty() || stack.back() != c) {
+          return fail("mismatched closing bracket", p);
+        }
+        stack.pop_back();
+        break;
+      case '/': return fail("comments are not supported", p);
+      default: break;
+    }
+    last = p;
+  }
+  if (!closed) return fail("unclosed array", end);
+  for (; p < end; p++) {
+    if (!IsSpace(*p)) return fail("unexpected characters after the array", p);
+  }
+  return true;
+}
+
+ParallelArrayParser::ParallelArrayParser(const Schema &schema, size_t threads)
+    : schema_(schema), threads_(std::max<size_t>(1, threads)) {}
+
+ParallelArrayParser::~ParallelArrayParser() = default;
+
+bool ParallelArrayParser::Init() {
+  if (!parsers_.empty()) return true;
+  for (size_t t = 0; t < threads_; t++) {
+    parsers_.push_back(schema_.CreateParser(&error_));
+    if (!parsers_.back()) {
+      parsers_.clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParallelArrayParser::Parse(
+    const char *json, size_t size,
+    std::vector<flatbuffers::DetachedBuffer> *buffers) {
+  timings_ = Timings();
+  error_.clear();
+  buffers->clear();
+  if (!Init()) return false;
+  auto start = Clock::now();
+  if (!SplitArray(json, size, &elements_, &error_)) return false;
+  timings_.split = Seconds(start);
+
+  start = Clock::now();
+  const auto count = elements_.size();
+  buffers->resize(count);
+  std::atomic<size_t> next(0);
+  // Lowest failed element: workers stop after it, elements before it are
+  // still parsed, so the reported error doesn't depend on scheduling.
+  std::atomic<size_t> failed(std::numeric_limits<size_t>::max());
+  std::mutex mutex;
+  auto work = [&](flatbuffers::Parser *parser) {
+    std::string text;
+    for (auto begin = next.fetch_add(kBatch); begin < count;
+         begin = next.fetch_add(kBatch)) {
+      for (auto i = begin; i < std::min(begin + kBatch, count); i++) {
+        if (i > failed.load(std::memory_order_relaxed)) return;
+        // the parser needs zero-terminated input
+        const auto &e = elements_[i];
+        text.assign(json + e.offset, e.size);
+        if (!parser->Parse(text.c_str())) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (i < failed) {
+            failed = i;
+            error_ = "array element " + std::to_string(i) + ": " +
+                     parser->error_;
+          }
+          return;
+        }
+        (*buffers)[i] = parser->builder_.Release();
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads_ && t * kBatch < count; t++) {
+    workers.emplace_back(work, parsers_[t].get());
+  }
+  work(parsers_[0].get());
+  for (auto &w : workers) w.join();
+  timings_.parse = Seconds(start);
+  if (!error_.empty()) {
+    buffers->clear();
+    return false;
+  }
+  return true;
+}
+
+bool ParallelArrayParser::ParseJoined(const char *json, size_t size,
+                                      const char *container_type,
+                                      const char *field,
+                                      flatbuffers::DetachedBuffer *buffer) {
+  std::vector<flatbuffers::DetachedBuffer> buffers;
+  if (!Parse(json, size, &buffers)) return false;
+  const auto start = Clock::now();
+  if (bfbs_.empty()) {
+    auto &parser = *parsers_.front();
+    parser.Serialize();
+    bfbs_.assign(
+        reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+        parser.builder_.GetSize());
+    parser.builder_.Clear();
+  }
+  const auto schema = reflection::GetSchema(bfbs_.data());
+  const reflection::Object *container = nullptr;
+  for (const auto object : *schema->objects()) {
+    if (object->name()->str() == container_type) container = object;
+  }
+  if (!container) {
+    error_ = std::string("unknown container type: ") + container_type;
+    return false;
+  }
+  const reflection::Field *vector_field = nullptr;
+  for (const auto f : *container->fields()) {
+    if (f->name()->str() == field) vector_field = f;
+  }
+  const auto root = schema->root_table();
+  if (!vector_field ||
+      vector_field->type()->base_type() != reflection::Vector ||
+      vector_field->type()->element() != reflection::Obj ||
+      schema->objects()->Get(vector_field->type()->index()) != root) {
+    error_ = std::string(container_type) + "." + field +
+             " must be a vector of " + root->name()->str();
+    return false;
+  }
+
+  size_t total = 0;
+  for (const auto &b : buffers) total += b.size();
+  flatbuffers::FlatBufferBuilder fbb(total + 1024);
+  std::vector<flatbuffers::Offset<const flatbuffers::Table *>> tables;
+  tables.reserve(buffers.size());
+  for (const auto &b : buffers) {
+    tables.push_back(flatbuffers::CopyTable(
+        fbb, *schema, *root, *flatbuffers::GetAnyRoot(b.data())));
+  }
+  const auto vector = fbb.CreateVector(tables);
+  const auto table = fbb.StartTable();
+  fbb.AddOffset(vector_field->offset(), vector);
+  fbb.Finish(flatbuffers::Offset<flatbuffers::Table>(fbb.EndTable(table)));
+  *buffer = fbb.Release();
+  timings_.join = Seconds(start);
+  return true;
+}
+
+}  // namespace fbjson
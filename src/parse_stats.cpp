@@ -0,0 +1,40 @@
+#include "fbjson/parse_stats.h"
+
+#include <cstdio>
+
+namespace fbjson {
+
+uint64_t ParseStats::TotalCycles() const {
+  uint64_t total = 0;
+  for (auto c : cycles) total += c;
+  return total;
+}
+
+const char *ParseStats::PhaseName(int phase) {
+  switch (phase) {
+    case kLex: return "lex";
+    case kFieldLookup: return "field_lookup";
+    case kNumber: return "number";
+    case kString: return "string";
+    case kBuilder: return "builder";
+    case kVtable: return "vtable";
+    default: return "unknown";
+  }
+}
+
+std::string ParseStats::ToString() const {
+  const auto total = TotalCycles();
+  std::string s;
+  for (int phase = 0; phase < kNumPhases; phase++) {
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "%s%s %llu cycles/%llu events (%.1f%%)",
+                  phase ? ", " : "", PhaseName(phase),
+                  static_cast<unsigned long long>(cycles[phase]),
+                  static_cast<unsigned long long>(events[phase]),
+                  total ? 100.0 * cycles[phase] / total : 0.0);
+    s += buf;
+  }
+  return s;
+}
+
+}  // namespace fbjson
@@ -0,0 +1,46 @@
+#include "fbjson/parser_view.h"
+
+#include <cstring>
+
+namespace fbjson {
+
+ParserView::ParserView(const flatbuffers::Parser &base,
+                       const flatbuffers::IDLOptions &opts,
+                       const SymbolIndex *index)
+    : base_(base), index_(index), parser_(opts) {
+  // enum values may be written with the qualified enum name
+  parser_.enums_.dict = base.enums_.dict;
+  parser_.enums_.vec = base.enums_.vec;
+  parser_.root_struct_def_ = base.root_struct_def_;
+  parser_.file_identifier_ = base.file_identifier_;
+  parser_.file_extension_ = base.file_extension_;
+  parser_.uses_flexbuffers_ = base.uses_flexbuffers_;
+}
+
+ParserView::~ParserView() {
+  // the definitions belong to the base parser
+  parser_.enums_.dict.clear();
+  parser_.enums_.vec.clear();
+}
+
+bool ParserView::Parse(const char *json, const char *source_filename) {
+  auto p = json;
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+  if (*p != '{' && *p != '[') {
+    parser_.error_ = "a parser view only parses JSON objects and arrays";
+    return false;
+  }
+  return parser_.Parse(json, nullptr, source_filename);
+}
+
+bool ParserView::SetRootType(const char *name) {
+  // `Parser::LookupStruct` counts references in the definition
+  const auto root = index_ ? index_->LookupStruct(name, std::strlen(name))
+                           : base_.structs_.Lookup(name);
+  if (!root || root->fixed) return false;
+  // JSON parsing only reads the definition
+  parser_.root_struct_def_ = const_cast<flatbuffers::StructDef *>(root);
+  return true;
+}
+
+}  // namespace fbjson
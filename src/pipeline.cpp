@@ -0,0 +1,304 @@
+#include "fbjson/pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "fbjson/bounded_queue.h"
+#include "flatbuffers/reflection.h"
+#include "flatbuffers/util.h"
+
+namespace fbjson {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using StageStats = PipelineStats::StageStats;
+
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Job {
+  size_t index = 0;
+  std::string json;
+  flatbuffers::DetachedBuffer buffer;
+};
+
+using JobPtr = std::unique_ptr<Job>;
+
+// Queue between two stages, closed when the last producer thread exits.
+struct Channel {
+  Channel(size_t capacity, size_t num_producers)
+      : queue(capacity), producers(num_producers) {}
+
+  void Close() { producers.fetch_sub(1, std::memory_order_release); }
+
+  BoundedQueue<JobPtr> queue;
+  std::atomic<size_t> producers;
+};
+
+void Push(Channel *out, JobPtr job, StageStats *stats) {
+  if (out->queue.TryPush(std::move(job))) return;
+  stats->full_waits++;
+  const auto start = Clock::now();
+  while (!out->queue.TryPush(std::move(job))) std::this_thread::yield();
+  stats->blocked_seconds += Seconds(start);
+}
+
+// Returns false once the channel is closed and drained.
+bool Pop(Channel *in, JobPtr *job, StageStats *stats) {
+  if (in->queue.TryPop(job)) return true;
+  stats->empty_waits++;
+  const auto start = Clock::now();
+  for (;;) {
+    // Load the producer count first: everything pushed before the close is
+    // visible to the pop below.
+    const auto closed = !in->producers.load(std::memory_order_acquire);
+    if (in->queue.TryPop(job)) break;
+    if (closed) {
+      stats->idle_seconds += Seconds(start);
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  stats->idle_seconds += Seconds(start);
+  return true;
+}
+
+void Merge(StageStats *total, const StageStats &s) {
+  total->items += s.items;
+  total->busy_seconds += s.busy_seconds;
+  total->full_waits += s.full_waits;
+  total->blocked_seconds += s.blocked_seconds;
+  total->empty_waits += s.empty_waits;
+  total->idle_seconds += s.idle_seconds;
+}
+
+}  // namespace
+
+double PipelineStats::StageStats::Utilization(double wall_seconds) const {
+  return threads && wall_seconds > 0
+             ? busy_seconds / (wall_seconds * static_cast<double>(threads))
+             : 0;
+}
+
+const char *PipelineStats::StageName(Stage stage) {
+  static const char *const kNames[] = { "read", "parse", "verify", "write" };
+  return kNames[stage];
+}
+
+std::string PipelineStats::ToString() const {
+  const double mb = 1024.0 * 1024.0;
+  char line[160];
+  std::string out;
+  std::snprintf(line, sizeof(line),
+                "files: %zu converted, %zu failed, input: %.2f MB, "
+                "output: %.2f MB, wall time: %.3f s\n",
+                files, failed, input_bytes / mb, output_bytes / mb, seconds);
+  out += line;
+  if (seconds > 0) {
+    std::snprintf(line, sizeof(line),
+                  "throughput: %.1f files/s, %.2f MB/s\n", files / seconds,
+                  input_bytes / mb / seconds);
+    out += line;
+  }
+  std::snprintf(line, sizeof(line), "%-8s %7s %9s %6s %10s %10s %10s\n",
+                "stage", "threads", "items", "util", "busy s", "full",
+                "empty");
+  out += line;
+  for (int s = 0; s < kNumStages; s++) {
+    const auto &stage = stages[s];
+    if (!stage.threads) continue;
+    std::snprintf(line, sizeof(line),
+                  "%-8s %7zu %9zu %5.1f%% %10.3f %10zu %10zu\n",
+                  StageName(static_cast<Stage>(s)), stage.threads,
+                  stage.items, stage.Utilization(seconds) * 100,
+                  stage.busy_seconds, stage.full_waits, stage.empty_waits);
+    out += line;
+  }
+  return out;
+}
+
+ConversionPipeline::ConversionPipeline(const Schema &schema,
+                                       PipelineOptions options)
+    : schema_(schema), options_(std::move(options)) {}
+
+bool ConversionPipeline::Run(const std::vector<std::string> &files,
+                             PipelineStats *stats) {
+  *stats = PipelineStats();
+  errors_.clear();
+
+  // Parsers are created up front, so a broken schema fails before any
+  // thread starts.
+  const auto num_parsers = std::max<size_t>(1, options_.parse_threads);
+  std::vector<std::unique_ptr<flatbuffers::Parser>> parsers;
+  std::string error;
+  for (size_t i = 0; i <= num_parsers; i++) {
+    parsers.push_back(schema_.CreateParser(&error));
+    if (!parsers.back()) {
+      errors_.push_back(schema_.path + ": " + error);
+      return false;
+    }
+  }
+  // The extra parser provides the binary schema for verification.
+  auto &schema_parser = *parsers.back();
+  schema_parser.Serialize();
+  const std::string bfbs(
+      reinterpret_cast<const char *>(schema_parser.builder_.GetBufferPointer()),
+      schema_parser.builder_.GetSize());
+  const auto extension = schema_parser.file_extension_.empty()
+                             ? std::string("bin")
+                             : schema_parser.file_extension_;
+  parsers.pop_back();
+  const auto reflection_schema = reflection::GetSchema(bfbs.data());
+  if (!options_.output_dir.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(options_.output_dir, ec);
+  }
+  const auto start = Clock::now();
+
+  auto &stages = stats->stages;
+  stages[PipelineStats::kRead].threads =
+      std::max<size_t>(1, options_.read_threads);
+  stages[PipelineStats::kParse].threads = num_parsers;
+  stages[PipelineStats::kVerify].threads =
+      options_.verify ? std::max<size_t>(1, options_.verify_threads) : 0;
+  stages[PipelineStats::kWrite].threads =
+      std::max<size_t>(1, options_.write_threads);
+
+  const auto capacity = std::max<size_t>(1, options_.queue_capacity);
+  Channel to_parse(capacity, stages[PipelineStats::kRead].threads);
+  Channel to_verify(capacity, num_parsers);
+  Channel to_write(capacity, options_.verify
+                                 ? stages[PipelineStats::kVerify].threads
+                                 : num_parsers);
+  Channel *const parse_out = options_.verify ? &to_verify : &to_write;
+
+  std::mutex mutex;
+  std::atomic<size_t> next(0);
+  auto fail = [&](const Job &job, const std::string &message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    errors_.push_back(files[job.index] + ": " + message);
+  };
+
+  std::vector<std::thread> threads;
+  // Run `body` on the stage threads and merge their counters on exit.
+  auto spawn = [&](PipelineStats::Stage stage,
+                   const std::function<void(size_t, StageStats *)> &body) {
+    for (size_t t = 0; t < stages[stage].threads; t++) {
+      threads.emplace_back([&, stage, body, t] {
+        StageStats local;
+        body(t, &local);
+        std::lock_guard<std::mutex> lock(mutex);
+        Merge(&stages[stage], local);
+      });
+    }
+  };
+
+  spawn(PipelineStats::kRead, [&](size_t, StageStats *s) {
+    size_t input_bytes = 0;
+    for (auto i = next++; i < files.size(); i = next++) {
+      const auto busy = Clock::now();
+      JobPtr job(new Job());
+      job->index = i;
+      if (!flatbuffers::LoadFile(files[i].c_str(), false, &job->json)) {
+        fail(*job, "can't read file");
+        continue;
+      }
+      input_bytes += job->json.size();
+      s->items++;
+      s->busy_seconds += Seconds(busy);
+      Push(&to_parse, std::move(job), s);
+    }
+    to_parse.Close();
+    std::lock_guard<std::mutex> lock(mutex);
+    stats->input_bytes += input_bytes;
+  });
+
+  spawn(PipelineStats::kParse, [&](size_t t, StageStats *s) {
+    auto &parser = *parsers[t];
+    JobPtr job;
+    while (Pop(&to_parse, &job, s)) {
+      const auto busy = Clock::now();
+      // No source file name: the parser would record every path in
+      // `included_files_` and skip paths it has seen before. Errors are
+      // prefixed with the path by `fail`.
+      if (!parser.Parse(job->json.c_str())) {
+        fail(*job, parser.error_);
+        continue;
+      }
+      // whitespace or declarations only: there is no buffer to release
+      if (!parser.builder_.GetSize()) {
+        fail(*job, "no JSON document in file");
+        continue;
+      }
+      job->buffer = parser.builder_.Release();
+      job->json = std::string();
+      s->items++;
+      s->busy_seconds += Seconds(busy);
+      Push(parse_out, std::move(job), s);
+    }
+    parse_out->Close();
+  });
+
+  if (options_.verify) {
+    spawn(PipelineStats::kVerify, [&](size_t, StageStats *s) {
+      JobPtr job;
+      while (Pop(&to_verify, &job, s)) {
+        const auto busy = Clock::now();
+        if (!flatbuffers::Verify(*reflection_schema,
+                                 *reflection_schema->root_table(),
+                                 job->buffer.data(), job->buffer.size())) {
+          fail(*job, "verification failed");
+          continue;
+        }
+        s->items++;
+        s->busy_seconds += Seconds(busy);
+        Push(&to_write, std::move(job), s);
+      }
+      to_write.Close();
+    });
+  }
+
+  spawn(PipelineStats::kWrite, [&](size_t, StageStats *s) {
+    size_t output_bytes = 0;
+    JobPtr job;
+    while (Pop(&to_write, &job, s)) {
+      const auto busy = Clock::now();
+      if (!options_.output_dir.empty()) {
+        const auto out = flatbuffers::ConCatPathFileName(
+            options_.output_dir,
+            flatbuffers::StripExtension(
+                flatbuffers::StripPath(files[job->index])) +
+                "." + extension);
+        if (!flatbuffers::SaveFile(
+                out.c_str(), reinterpret_cast<const char *>(job->buffer.data()),
+                job->buffer.size(), true)) {
+          fail(*job, "can't write " + out);
+          continue;
+        }
+      }
+      output_bytes += job->buffer.size();
+      job.reset();
+      s->items++;
+      s->busy_seconds += Seconds(busy);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    stats->output_bytes += output_bytes;
+    stats->files += s->items;
+  });
+
+  for (auto &t : threads) t.join();
+  std::sort(errors_.begin(), errors_.end());
+  stats->failed = errors_.size();
+  stats->seconds = Seconds(start);
+  return errors_.empty();
+}
+
+}  // namespace fbjson
@@ -0,0 +1,192 @@
+#include "fbjson/schema_registry.h"
+
+#include <algorithm>
+#include <cstring>
+#include "fbjson/include_cache.h"
+#include "flatbuffers/util.h"
+
+namespace fbjson {
+
+std::unique_ptr<flatbuffers::Parser> Schema::CreateParser(
+    std::string *error) const {
+  std::unique_ptr<flatbuffers::Parser> parser(
+      new flatbuffers::Parser(opts));
+  std::vector<const char *> include_paths;
+  for (const auto &dir : include_dirs) include_paths.push_back(dir.c_str());
+  include_paths.push_back(nullptr);
+  const auto ok =
+      include_cache
+          ? include_cache->Parse(parser.get(), text.c_str(),
+                                 include_paths.data(), path.c_str())
+          : parser->Parse(text.c_str(), include_paths.data(), path.c_str());
+  if (!ok) {
+    *error = parser->error_;
+    return nullptr;
+  }
+  if (!root_type.empty() && !parser->SetRootType(root_type.c_str())) {
+    *error = "unknown root type: " + root_type;
+    return nullptr;
+  }
+  if (!parser->root_struct_def_) {
+    *error = "no root type set for schema: " + path;
+    return nullptr;
+  }
+  if (parser->file_identifier_.empty()) {
+    parser->file_identifier_ = file_identifier;
+  } else if (!file_identifier.empty() &&
+             parser->file_identifier_ != file_identifier) {
+    *error = "schema " + path + " declares file_identifier \"" +
+             parser->file_identifier_ + "\" instead of \"" + file_identifier +
+             "\"";
+    return nullptr;
+  }
+  return parser;
+}
+
+SchemaRegistry::SchemaRegistry() : snapshot_(nullptr) {
+  snapshots_.emplace_back(new Snapshot());
+  snapshot_.store(snapshots_.back().get(), std::memory_order_release);
+}
+
+SchemaRegistry::~SchemaRegistry() = default;
+
+SchemaRegistry::Key SchemaRegistry::MakeKey(const char *file_identifier) {
+  Key key = 0;
+  for (size_t i = 0; i < flatbuffers::kFileIdentifierLength; i++) {
+    if (!file_identifier[i]) return key;
+    key |= static_cast<Key>(static_cast<uint8_t>(file_identifier[i]))
+           << (8 * i);
+  }
+  return key;
+}
+
+void SchemaRegistry::SetOptions(const flatbuffers::IDLOptions &opts) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  opts_ = opts;
+}
+
+void SchemaRegistry::AddIncludeDirectory(const char *path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  include_dirs_.push_back(path);
+}
+
+void SchemaRegistry::SetIncludeCache(IncludeCache *cache) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  include_cache_ = cache;
+}
+
+bool SchemaRegistry::Register(const char *file_identifier,
+                              const char *schema_path,
+                              const char *root_type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!file_identifier ||
+      std::strlen(file_identifier) != flatbuffers::kFileIdentifierLength) {
+    last_error_ = "file identifier must be 4 characters long";
+    return false;
+  }
+  std::unique_ptr<Schema> schema(new Schema());
+  schema->file_identifier = file_identifier;
+  schema->path = schema_path;
+  schema->root_type = root_type ? root_type : "";
+  schema->include_dirs = include_dirs_;
+  schema->opts = opts_;
+  schema->include_cache = include_cache_;
+  if (!flatbuffers::LoadFile(schema_path, false, &schema->text)) {
+    last_error_ = "could not load schema: " + schema->path;
+    return false;
+  }
+  // Broken schemas are rejected here, the contexts share the parser.
+  schema->base = schema->CreateParser(&last_error_);
+  if (!schema->base) return false;
+
+  const auto key = MakeKey(file_identifier);
+  const auto current = snapshot_.load(std::memory_order_relaxed);
+  std::unique_ptr<Snapshot> next(new Snapshot(*current));
+  auto it = std::lower_bound(
+      next->begin(), next->end(), key,
+      [](const Snapshot::value_type &e, Key k) { return e.first < k; });
+  if (it != next->end() && it->first == key) {
+    it->second = schema.get();
+  } else {
+    next->emplace(it, key, schema.get());
+  }
+  schemas_.push_back(std::move(schema));
+  snapshots_.push_back(std::move(next));
+  snapshot_.store(snapshots_.back().get(), std::memory_order_release);
+  return true;
+}
+
+const Schema *SchemaRegistry::Find(const char *file_identifier) const {
+  if (!file_identifier) return nullptr;
+  const auto key = MakeKey(file_identifier);
+  const auto snapshot = snapshot_.load(std::memory_order_acquire);
+  auto it = std::lower_bound(
+      snapshot->begin(), snapshot->end(), key,
+      [](const Snapshot::value_type &e, Key k) { return e.first < k; });
+  return (it != snapshot->end() && it->first == key) ? it->second : nullptr;
+}
+
+size_t SchemaRegistry::size() const {
+  return snapshot_.load(std::memory_order_acquire)->size();
+}
+
+std::string SchemaRegistry::GetLastError() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_error_;
+}
+
+ParserView *SchemaRegistry::ParseContext::GetView(
+    const char *file_identifier) {
+  const auto schema = registry_.Find(file_identifier);
+  if (!schema) {
+    last_error_ = "unknown file identifier: ";
+    last_error_.append(file_identifier ? file_identifier : "null");
+    return nullptr;
+  }
+  for (auto &it : views_) {
+    if (it.first == schema) return it.second.get();
+  }
+  std::unique_ptr<ParserView> view(
+      new ParserView(*schema->base, schema->opts));
+  views_.emplace_back(schema, std::move(view));
+  return views_.back().second.get();
+}
+
+flatbuffers::Parser *SchemaRegistry::ParseContext::Parse(
+    const char *text, const char *file_identifier) {
+  auto view = GetView(file_identifier);
+  if (!view) return nullptr;
+  if (!view->Parse(text)) {
+    last_error_ = view->parser().error_;
+    return nullptr;
+  }
+  return &view->parser();
+}
+
+flatbuffers::DetachedBuffer SchemaRegistry::ParseContext::TextToFlatBuffer(
+    const char *text, const char *file_identifier) {
+  auto parser = Parse(text, file_identifier);
+  if (!parser) return flatbuffers::DetachedBuffer();
+  return parser->builder_.Release();
+}
+
+bool SchemaRegistry::ParseContext::FlatBufferToText(const uint8_t *flatbuf,
+                                                    size_t len,
+                                                    std::string *dest) {
+  if (len < sizeof(flatbuffers::uoffset_t) +
+                flatbuffers::kFileIdentifierLength) {
+    last_error_ = "buffer is too small to contain a file identifier";
+    return false;
+  }
+  std::string ident(flatbuffers::GetBufferIdentifier(flatbuf),
+                    flatbuffers::kFileIdentifierLength);
+  auto view = GetView(ident.c_str());
+  if (!view) return false;
+  if (!flatbuffers::GenerateText(view->parser(), flatbuf, dest)) {
+    last_error_ = "unable to generate text for FlatBuffer binary";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace fbjson
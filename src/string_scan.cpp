@@ -0,0 +1,139 @@
+#include "fbjson/string_scan.h"
+
+#include <cstdint>
+#include "flatbuffers/util.h"
+
+#if !defined(FBJSON_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#  include <emmintrin.h>
+#  define FBJSON_SCAN_SSE2
+#elif !defined(FBJSON_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#  define FBJSON_SCAN_NEON
+#endif
+
+// Blocks read past the terminator are outside of the string object. The
+// attribute goes on every function which loads a block, inlining isn't
+// guaranteed.
+#if defined(__clang__) || defined(__GNUC__)
+#  define FBJSON_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#  define FBJSON_NO_SANITIZE_ADDRESS
+#endif
+
+namespace fbjson {
+
+namespace {
+
+const size_t kBlock = 16;
+
+inline bool IsPlain(char c) {
+  const auto u = static_cast<unsigned char>(c);
+  return u >= 0x20 && u < 0x7f && u != '"' && u != '\\';
+}
+
+#if defined(FBJSON_SCAN_SSE2)
+// Bit i is set if byte i of the block isn't plain.
+inline unsigned SpecialMask(const __m128i block) {
+  // signed compares: bytes >= 0x80 are negative and fail the first one
+  const auto plain = _mm_and_si128(
+      _mm_cmpgt_epi8(block, _mm_set1_epi8(0x1f)),
+      _mm_cmplt_epi8(block, _mm_set1_epi8(0x7f)));
+  const auto escapes =
+      _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')),
+                   _mm_cmpeq_epi8(block, _mm_set1_epi8('\\')));
+  return static_cast<unsigned>(
+      _mm_movemask_epi8(_mm_andnot_si128(escapes, plain)) ^ 0xffff);
+}
+
+inline size_t FirstBit(unsigned mask) {
+#  if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_t>(__builtin_ctz(mask));
+#  else
+  size_t i = 0;
+  while (!(mask & 1)) mask >>= 1, i++;
+  return i;
+#  endif
+}
+
+// Offset of the first special byte of the block at `p`, or `kBlock`.
+FBJSON_NO_SANITIZE_ADDRESS inline size_t ScanBlock(const char *p,
+                                                   bool aligned) {
+  const auto addr = reinterpret_cast<const __m128i *>(p);
+  const auto mask =
+      SpecialMask(aligned ? _mm_load_si128(addr) : _mm_loadu_si128(addr));
+  return mask ? FirstBit(mask) : kBlock;
+}
+#elif defined(FBJSON_SCAN_NEON)
+FBJSON_NO_SANITIZE_ADDRESS inline size_t ScanBlock(const char *p, bool) {
+  const auto block = vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+  const auto plain =
+      vandq_u8(vcgtq_u8(block, vdupq_n_u8(0x1f)),
+               vcltq_u8(block, vdupq_n_u8(0x7f)));
+  const auto escapes = vorrq_u8(vceqq_u8(block, vdupq_n_u8('"')),
+                                vceqq_u8(block, vdupq_n_u8('\\')));
+  // all ones where the byte is plain
+  if (vminvq_u8(vbicq_u8(plain, escapes)) == 0xff) return kBlock;
+  size_t i = 0;
+  while (IsPlain(p[i])) i++;
+  return i;
+}
+#endif
+
+}  // namespace
+
+size_t PlainPrefix(const char *s, size_t size) {
+  size_t i = 0;
+#if defined(FBJSON_SCAN_SSE2) || defined(FBJSON_SCAN_NEON)
+  for (; i + kBlock <= size; i += kBlock) {
+    const auto n = ScanBlock(s + i, false);
+    if (n < kBlock) return i + n;
+  }
+#endif
+  while (i < size && IsPlain(s[i])) i++;
+  return i;
+}
+
+FBJSON_NO_SANITIZE_ADDRESS const char *SkipPlain(const char *s) {
+#if defined(FBJSON_SCAN_SSE2) || defined(FBJSON_SCAN_NEON)
+  // bytes up to the first aligned block
+  while (reinterpret_cast<uintptr_t>(s) % kBlock) {
+    if (!IsPlain(*s)) return s;
+    s++;
+  }
+  for (;; s += kBlock) {
+    const auto n = ScanBlock(s, true);
+    if (n < kBlock) return s + n;
+  }
+#else
+  while (IsPlain(*s)) s++;
+  return s;
+#endif
+}
+
+bool AppendEscaped(const char *s, size_t size, std::string *text,
+                   bool allow_non_utf8, bool natural_utf8) {
+  text->push_back('"');
+  for (size_t i = 0; i < size;) {
+    const auto plain = PlainPrefix(s + i, size - i);
+    text->append(s + i, plain);
+    i += plain;
+    if (i == size) break;
+    // A run of special bytes never ends inside a UTF-8 sequence (its
+    // continuation bytes are special), so `EscapeString` sees whole
+    // characters. Its quotes are dropped.
+    auto end = i + 1;
+    while (end < size && !IsPlain(s[end])) end++;
+    const auto start = text->size();
+    if (!flatbuffers::EscapeString(s + i, end - i, text, allow_non_utf8,
+                                   natural_utf8)) {
+      return false;
+    }
+    text->erase(start, 1);
+    text->pop_back();
+    i = end;
+  }
+  text->push_back('"');
+  return true;
+}
+
+}  // namespace fbjson
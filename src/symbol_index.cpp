@@ -0,0 +1,146 @@
+#include "fbjson/symbol_index.h"
+
+#include <cstring>
+#include <unordered_map>
+#include "fbjson/meta.h"
+
+namespace fbjson {
+
+void SymbolIndex::Table::Reserve(size_t symbols) {
+  // load factor at most 1/2
+  size_t capacity = 8;
+  while (capacity < 2 * symbols) capacity *= 2;
+  slots_.assign(capacity, Slot());
+  mask_ = capacity - 1;
+}
+
+void SymbolIndex::Table::Add(const Slot &slot) {
+  auto i = slot.hash & mask_;
+  while (slots_[i].def) i = (i + 1) & mask_;
+  slots_[i] = slot;
+}
+
+const SymbolIndex::Slot *SymbolIndex::Table::Find(
+    uint32_t hash, uint32_t owner, const char *name, size_t len,
+    const std::string &names) const {
+  for (auto i = hash & mask_;; i = (i + 1) & mask_) {
+    const auto &slot = slots_[i];
+    if (!slot.def) return nullptr;
+    if (slot.hash == hash && slot.owner == owner && slot.length == len &&
+        !std::memcmp(names.data() + slot.name, name, len)) {
+      return &slot;
+    }
+  }
+}
+
+uint32_t SymbolIndex::Hash(const char *name, size_t len, uint32_t owner) {
+  // fields of different structs spread over the whole table
+  return meta::HashName(name, len) ^ (owner * 2654435769u);
+}
+
+SymbolIndex::Slot SymbolIndex::MakeSlot(const std::string &name,
+                                        uint32_t owner, uint32_t index,
+                                        const void *def) {
+  Slot slot;
+  slot.hash = Hash(name.data(), name.size(), owner);
+  slot.owner = owner;
+  slot.name = static_cast<uint32_t>(names_.size());
+  slot.length = static_cast<uint32_t>(name.size());
+  slot.index = index;
+  slot.def = def;
+  names_ += name;
+  return slot;
+}
+
+SymbolIndex::SymbolIndex(const flatbuffers::Parser &parser, Scope scope) {
+  for (const auto sd : parser.structs_.vec) {
+    if (scope == Scope::kAll || !sd->fixed) structs_.push_back(sd);
+  }
+  std::unordered_map<const flatbuffers::StructDef *, uint32_t> positions;
+  for (size_t i = 0; i < structs_.size(); i++) {
+    positions[structs_[i]] = static_cast<uint32_t>(i);
+  }
+  const auto with_enums = scope == Scope::kAll;
+  size_t num_fields = 0, names = 0;
+  for (const auto &entry : parser.structs_.dict) {
+    if (positions.count(entry.second)) names += entry.first.size();
+  }
+  if (with_enums) {
+    for (const auto &entry : parser.enums_.dict) names += entry.first.size();
+  }
+  for (const auto sd : structs_) {
+    num_fields += sd->fields.vec.size();
+    for (const auto fd : sd->fields.vec) names += fd->name.size();
+  }
+  names_.reserve(names);
+  struct_table_.Reserve(structs_.size());
+  enum_table_.Reserve(with_enums ? parser.enums_.dict.size() : 0);
+  field_table_.Reserve(num_fields);
+
+  for (const auto &entry : parser.structs_.dict) {
+    const auto it = positions.find(entry.second);
+    if (it == positions.end()) continue;
+    struct_table_.Add(MakeSlot(entry.first, 0, it->second, entry.second));
+  }
+  if (with_enums) {
+    for (const auto &entry : parser.enums_.dict) {
+      enum_table_.Add(MakeSlot(entry.first, 0, 0, entry.second));
+    }
+  }
+  for (size_t i = 0; i < structs_.size(); i++) {
+    const auto owner = static_cast<uint32_t>(i);
+    const auto &fields = structs_[i]->fields.vec;
+    for (size_t f = 0; f < fields.size(); f++) {
+      field_table_.Add(
+          MakeSlot(fields[f]->name, owner, static_cast<uint32_t>(f),
+                   fields[f]));
+    }
+  }
+}
+
+int SymbolIndex::FindStruct(const char *name, size_t len) const {
+  const auto slot =
+      struct_table_.Find(Hash(name, len, 0), 0, name, len, names_);
+  return slot ? static_cast<int>(slot->index) : -1;
+}
+
+int SymbolIndex::FindField(int struct_index, const char *name,
+                           size_t len) const {
+  const auto owner = static_cast<uint32_t>(struct_index);
+  const auto slot =
+      field_table_.Find(Hash(name, len, owner), owner, name, len, names_);
+  return slot ? static_cast<int>(slot->index) : -1;
+}
+
+const flatbuffers::StructDef *SymbolIndex::LookupStruct(const char *name,
+                                                        size_t len) const {
+  const auto i = FindStruct(name, len);
+  return i < 0 ? nullptr : structs_[static_cast<size_t>(i)];
+}
+
+const flatbuffers::EnumDef *SymbolIndex::LookupEnum(const char *name,
+                                                    size_t len) const {
+  const auto slot =
+      enum_table_.Find(Hash(name, len, 0), 0, name, len, names_);
+  return slot ? static_cast<const flatbuffers::EnumDef *>(slot->def)
+              : nullptr;
+}
+
+const flatbuffers::FieldDef *SymbolIndex::LookupField(int struct_index,
+                                                      const char *name,
+                                                      size_t len) const {
+  const auto owner = static_cast<uint32_t>(struct_index);
+  const auto slot =
+      field_table_.Find(Hash(name, len, owner), owner, name, len, names_);
+  return slot ? static_cast<const flatbuffers::FieldDef *>(slot->def)
+              : nullptr;
+}
+
+size_t SymbolIndex::MemoryUsage() const {
+  return sizeof(*this) + names_.capacity() +
+         structs_.capacity() * sizeof(structs_[0]) +
+         struct_table_.MemoryUsage() + enum_table_.MemoryUsage() +
+         field_table_.MemoryUsage();
+}
+
+}  // namespace fbjson
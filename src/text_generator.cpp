@@ -0,0 +1,413 @@
+#include "fbjson/text_generator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "fbjson/string_scan.h"
+#include "flatbuffers/flexbuffers.h"
+#include "flatbuffers/util.h"
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace fbjson {
+
+namespace {
+
+using flatbuffers::BaseType;
+using flatbuffers::FieldDef;
+using flatbuffers::StructDef;
+using flatbuffers::Type;
+
+// `1e308` in fixed notation needs 309 digits before the point.
+const int kMaxPrecision = 100;
+
+#ifdef _WIN32
+// `_write` takes an `unsigned` count.
+const size_t kMaxWrite = size_t(1) << 30;
+#endif
+
+template<typename T> void FormatFloat(T value, int precision,
+                                      std::string *text) {
+  char buf[512];
+  const auto fixed = precision >= 0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  auto end = fixed ? std::to_chars(buf, buf + sizeof(buf), value,
+                                   std::chars_format::fixed,
+                                   std::min(precision, kMaxPrecision))
+                         .ptr
+                   : std::to_chars(buf, buf + sizeof(buf), value).ptr;
+  if (!fixed && std::is_same<T, float>::value) {
+    // Readers which parse a float as double and narrow it (`strtod`) round
+    // twice, and a few shortest texts (7.038531e-26) land on the neighbour.
+    *end = '\0';
+    if (static_cast<T>(std::strtod(buf, nullptr)) != value) {
+      end = std::to_chars(buf, buf + sizeof(buf), value,
+                          std::chars_format::general,
+                          std::numeric_limits<T>::max_digits10)
+                .ptr;
+    }
+  }
+#else
+  if (fixed) {
+    std::snprintf(buf, sizeof(buf), "%.*f", std::min(precision, kMaxPrecision),
+                  static_cast<double>(value));
+  } else {
+    // fewest significant digits which read back as the same value
+    for (int digits = std::numeric_limits<T>::digits10;; digits++) {
+      std::snprintf(buf, sizeof(buf), "%.*g", digits,
+                    static_cast<double>(value));
+      if (digits >= std::numeric_limits<T>::max_digits10 ||
+          static_cast<T>(std::strtod(buf, nullptr)) == value) {
+        break;
+      }
+    }
+  }
+  const auto end = buf + std::strlen(buf);
+#endif
+  const auto begin = text->size();
+  text->append(buf, end);
+  const auto printed = text->c_str() + begin;
+  if (std::strchr(printed, '.')) {
+    if (fixed) {
+      // "1.500000" -> "1.5", "1.000000" -> "1.0"
+      const auto last = text->find_last_not_of('0');
+      text->resize(last + ((*text)[last] == '.' ? 2 : 1));
+    }
+  } else if (!std::strpbrk(printed, "en")) {
+    // keep whole numbers floating point, `nan` and `inf` as they are
+    *text += ".0";
+  }
+}
+
+// Calls `f` with a value of the C++ type of a scalar base type.
+template<typename F> void WithScalarType(BaseType type, F &&f) {
+  switch (type) {
+    case flatbuffers::BASE_TYPE_CHAR: f(int8_t()); break;
+    case flatbuffers::BASE_TYPE_SHORT: f(int16_t()); break;
+    case flatbuffers::BASE_TYPE_USHORT: f(uint16_t()); break;
+    case flatbuffers::BASE_TYPE_INT: f(int32_t()); break;
+    case flatbuffers::BASE_TYPE_UINT: f(uint32_t()); break;
+    case flatbuffers::BASE_TYPE_LONG: f(int64_t()); break;
+    case flatbuffers::BASE_TYPE_ULONG: f(uint64_t()); break;
+    case flatbuffers::BASE_TYPE_FLOAT: f(float()); break;
+    case flatbuffers::BASE_TYPE_DOUBLE: f(double()); break;
+    // utype, bool, ubyte
+    default: f(uint8_t()); break;
+  }
+}
+
+// Same layout as `flatbuffers::GenerateText` (idl_gen_text.cpp), or none
+// in compact mode. With a writer, `text` holds the current chunk.
+class Printer {
+ public:
+  Printer(const flatbuffers::IDLOptions &opts, const TextOptions &options,
+          std::string *text, const ChunkWriter *write = nullptr)
+      : opts_(opts),
+        options_(options),
+        text_(*text),
+        write_(write),
+        compact_(options.compact),
+        indent_step_(compact_ ? 0 : std::max(opts.indent_step, 0)) {}
+
+  // A table, or a struct if `struct_def.fixed`.
+  bool Struct(const StructDef &struct_def, const flatbuffers::Table *table,
+              int indent) {
+    text_ += "{";
+    int fieldout = 0;
+    // type of the next union field, or types of the next vector of unions
+    const Type *union_type = nullptr;
+    const flatbuffers::Vector<uint8_t> *union_types = nullptr;
+    for (const auto fd : struct_def.fields.vec) {
+      const auto &type = fd->value.type;
+      const auto is_present =
+          struct_def.fixed || table->CheckField(fd->value.offset);
+      const auto output_anyway = opts_.output_default_scalars_in_json &&
+                                 flatbuffers::IsScalar(type.base_type) &&
+                                 !fd->deprecated;
+      if (!is_present && !output_anyway) continue;
+      if (fieldout++) text_ += ",";
+      NewLine();
+      Indentation(indent + indent_step_);
+      if (opts_.strict_json) text_ += "\"";
+      text_ += fd->name;
+      if (opts_.strict_json) text_ += "\"";
+      text_ += compact_ ? ":" : ": ";
+      if (flatbuffers::IsScalar(type.base_type)) {
+        ScalarField(*fd, table, struct_def.fixed);
+      } else if (!OffsetField(*fd, table, struct_def.fixed,
+                              indent + indent_step_, union_type,
+                              union_types)) {
+        return false;
+      }
+      if (type.base_type == flatbuffers::BASE_TYPE_UTYPE) {
+        const auto enum_val = type.enum_def->ReverseLookup(
+            table->GetField<uint8_t>(fd->value.offset, 0), true);
+        union_type = enum_val ? &enum_val->union_type : nullptr;
+      } else if (type.base_type == flatbuffers::BASE_TYPE_VECTOR &&
+                 type.element == flatbuffers::BASE_TYPE_UTYPE) {
+        union_types =
+            table->GetPointer<const flatbuffers::Vector<uint8_t> *>(
+                fd->value.offset);
+      }
+      if (!Flush(false)) return false;
+    }
+    NewLine();
+    Indentation(indent);
+    text_ += "}";
+    return true;
+  }
+
+  void NewLine() {
+    if (!compact_ && opts_.indent_step >= 0) text_ += '\n';
+  }
+
+  // Hands the chunk to the writer once it is full, or whatever is left if
+  // `all`. Without a writer the text stays in the string.
+  bool Flush(bool all) {
+    if (!write_ || (!all && text_.size() < options_.chunk_size)) return true;
+    const auto ok = text_.empty() || (*write_)(text_.data(), text_.size());
+    text_.clear();
+    return ok;
+  }
+
+ private:
+  void Indentation(int indent) {
+    if (!compact_) text_.append(indent, ' ');
+  }
+
+  template<typename T> void Scalar(T val, const Type &type) {
+    if (type.enum_def && opts_.output_enum_identifiers) {
+      const auto enum_val =
+          type.enum_def->ReverseLookup(static_cast<int64_t>(val));
+      if (enum_val) {
+        text_ += "\"";
+        text_ += enum_val->name;
+        text_ += "\"";
+        return;
+      }
+    }
+    if (type.base_type == flatbuffers::BASE_TYPE_BOOL) {
+      text_ += val != 0 ? "true" : "false";
+      return;
+    }
+    if constexpr (std::is_floating_point<T>::value) {
+      AppendFloat(val, options_.float_precision, &text_);
+    } else if constexpr (std::is_signed<T>::value) {
+      text_ += std::to_string(static_cast<int64_t>(val));
+    } else {
+      text_ += std::to_string(static_cast<uint64_t>(val));
+    }
+  }
+
+  void ScalarField(const FieldDef &fd, const flatbuffers::Table *table,
+                   bool fixed) {
+    WithScalarType(fd.value.type.base_type, [&](auto zero) {
+      using T = decltype(zero);
+      T val;
+      if (fixed) {
+        val = reinterpret_cast<const flatbuffers::Struct *>(table)->GetField<T>(
+            fd.value.offset);
+      } else {
+        T def = 0;
+        flatbuffers::StringToNumber(fd.value.constant.c_str(), &def);
+        val = table->GetField<T>(fd.value.offset, def);
+      }
+      Scalar(val, fd.value.type);
+    });
+  }
+
+  bool OffsetField(const FieldDef &fd, const flatbuffers::Table *table,
+                   bool fixed, int indent, const Type *union_type,
+                   const flatbuffers::Vector<uint8_t> *union_types) {
+    const auto &type = fd.value.type;
+    const void *val = nullptr;
+    if (fixed) {
+      // the only non-scalar fields in structs are structs
+      val = reinterpret_cast<const flatbuffers::Struct *>(table)
+                ->GetStruct<const void *>(fd.value.offset);
+    } else if (fd.flexbuffer) {
+      const auto vec =
+          table->GetPointer<const flatbuffers::Vector<uint8_t> *>(
+              fd.value.offset);
+      flexbuffers::GetRoot(vec->Data(), vec->size())
+          .ToString(true, opts_.strict_json, text_);
+      return true;
+    } else if (fd.nested_flatbuffer) {
+      const auto vec =
+          table->GetPointer<const flatbuffers::Vector<uint8_t> *>(
+              fd.value.offset);
+      return Struct(*fd.nested_flatbuffer,
+                    flatbuffers::GetRoot<flatbuffers::Table>(vec->Data()),
+                    indent);
+    } else {
+      val = flatbuffers::IsStruct(type)
+                ? table->GetStruct<const void *>(fd.value.offset)
+                : table->GetPointer<const void *>(fd.value.offset);
+    }
+    return Pointer(val, type, indent, union_type, union_types);
+  }
+
+  // `union_type` is the type of a union, `union_types` the parallel `_type`
+  // vector of a vector of unions.
+  bool Pointer(const void *val, const Type &type, int indent,
+               const Type *union_type,
+               const flatbuffers::Vector<uint8_t> *union_types = nullptr) {
+    switch (type.base_type) {
+      case flatbuffers::BASE_TYPE_UNION:
+        // a union without its type field can't be printed
+        return union_type && Pointer(val, *union_type, indent, nullptr);
+      case flatbuffers::BASE_TYPE_STRUCT:
+        return Struct(*type.struct_def,
+                      reinterpret_cast<const flatbuffers::Table *>(val),
+                      indent);
+      case flatbuffers::BASE_TYPE_STRING: {
+        const auto s = reinterpret_cast<const flatbuffers::String *>(val);
+        return AppendEscaped(s->c_str(), s->size(), &text_,
+                             opts_.allow_non_utf8, opts_.natural_utf8);
+      }
+      case flatbuffers::BASE_TYPE_VECTOR:
+        return Vector(val, type, indent, union_types);
+      default: return false;
+    }
+  }
+
+  bool Vector(const void *val, const Type &vector_type, int indent,
+              const flatbuffers::Vector<uint8_t> *union_types) {
+    const auto type = vector_type.VectorType();
+    const auto element = indent + indent_step_;
+    text_ += "[";
+    NewLine();
+    auto ok = true;
+    if (flatbuffers::IsScalar(type.base_type)) {
+      WithScalarType(type.base_type, [&](auto zero) {
+        using T = decltype(zero);
+        const auto &v = *reinterpret_cast<const flatbuffers::Vector<T> *>(val);
+        for (flatbuffers::uoffset_t i = 0; ok && i < v.size(); i++) {
+          Separator(i, element);
+          Scalar(v.Get(i), type);
+          ok = Flush(false);
+        }
+      });
+    } else if (flatbuffers::IsStruct(type)) {
+      const auto &v =
+          *reinterpret_cast<const flatbuffers::Vector<uint8_t> *>(val);
+      const auto size = type.struct_def->bytesize;
+      for (flatbuffers::uoffset_t i = 0; ok && i < v.size(); i++) {
+        Separator(i, element);
+        ok = Struct(*type.struct_def,
+                    reinterpret_cast<const flatbuffers::Table *>(
+                        v.Data() + i * size),
+                    element) &&
+             Flush(false);
+      }
+    } else {
+      const auto &v = *reinterpret_cast<
+          const flatbuffers::Vector<flatbuffers::Offset<void>> *>(val);
+      for (flatbuffers::uoffset_t i = 0; ok && i < v.size(); i++) {
+        Separator(i, element);
+        const Type *union_type = nullptr;
+        if (type.base_type == flatbuffers::BASE_TYPE_UNION && union_types &&
+            i < union_types->size()) {
+          const auto enum_val =
+              type.enum_def->ReverseLookup(union_types->Get(i), true);
+          union_type = enum_val ? &enum_val->union_type : nullptr;
+        }
+        ok = Pointer(v.Get(i), type, element, union_type) && Flush(false);
+      }
+    }
+    NewLine();
+    Indentation(indent);
+    text_ += "]";
+    return ok;
+  }
+
+  void Separator(flatbuffers::uoffset_t i, int indent) {
+    if (i) {
+      text_ += ",";
+      NewLine();
+    }
+    Indentation(indent);
+  }
+
+  const flatbuffers::IDLOptions &opts_;
+  const TextOptions &options_;
+  std::string &text_;
+  const ChunkWriter *write_;
+  const bool compact_;
+  const int indent_step_;
+};
+
+bool Print(const flatbuffers::Parser &parser, const void *flatbuffer,
+           Printer *printer) {
+  if (!parser.root_struct_def_) return false;
+  const auto root =
+      parser.opts.size_prefixed
+          ? flatbuffers::GetSizePrefixedRoot<flatbuffers::Table>(flatbuffer)
+          : flatbuffers::GetRoot<flatbuffers::Table>(flatbuffer);
+  if (!printer->Struct(*parser.root_struct_def_, root, 0)) return false;
+  printer->NewLine();
+  return printer->Flush(true);
+}
+
+}  // namespace
+
+void AppendFloat(float value, int precision, std::string *text) {
+  FormatFloat(value, precision, text);
+}
+
+void AppendFloat(double value, int precision, std::string *text) {
+  FormatFloat(value, precision, text);
+}
+
+ChunkWriter FdChunkWriter(int fd) {
+  return [fd](const char *data, size_t size) {
+    while (size) {
+#ifdef _WIN32
+      const auto n =
+          _write(fd, data, static_cast<unsigned>(std::min(size, kMaxWrite)));
+#else
+      const auto n = ::write(fd, data, size);
+#endif
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return false;
+      data += n;
+      size -= static_cast<size_t>(n);
+    }
+    return true;
+  };
+}
+
+ChunkWriter BufferChunkWriter(char *buf, size_t capacity, size_t *size) {
+  *size = 0;
+  return [buf, capacity, size](const char *data, size_t n) {
+    if (n > capacity - *size) return false;
+    std::memcpy(buf + *size, data, n);
+    *size += n;
+    return true;
+  };
+}
+
+bool GenerateText(const flatbuffers::Parser &parser, const void *flatbuffer,
+                  const TextOptions &options, std::string *text) {
+  Printer printer(parser.opts, options, text);
+  return Print(parser, flatbuffer, &printer);
+}
+
+bool GenerateText(const flatbuffers::Parser &parser, const void *flatbuffer,
+                  const TextOptions &options, const ChunkWriter &write) {
+  std::string chunk;
+  // room for the last value past the chunk size
+  chunk.reserve(options.chunk_size + 1024);
+  Printer printer(parser.opts, options, &chunk, &write);
+  return Print(parser, flatbuffer, &printer);
+}
+
+}  // namespace fbjson
@@ -0,0 +1,228 @@
+#include "fbjson/verified_buffer.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "flatbuffers/reflection.h"
+
+namespace fbjson {
+
+namespace {
+
+using flatbuffers::StructDef;
+
+// `Parser` copies nested FlatBuffers written as `[ubyte]` arrays into the
+// buffer as they are, unlike anything else the builder writes. The checker
+// walks the tables of a buffer and runs the verifier over every nested
+// buffer, then over the buffers nested in those.
+class NestedChecker {
+ public:
+  explicit NestedChecker(flatbuffers::Parser *parser) : parser_(parser) {}
+
+  bool Table(const StructDef &struct_def, const flatbuffers::Table *table) {
+    // type of the next union field, or types of the next vector of unions
+    const StructDef *union_table = nullptr;
+    const flatbuffers::Vector<uint8_t> *union_types = nullptr;
+    for (const auto fd : struct_def.fields.vec) {
+      const auto &type = fd->value.type;
+      const auto offset = fd->value.offset;
+      switch (type.base_type) {
+        case flatbuffers::BASE_TYPE_UTYPE:
+          union_table = UnionTable(type, table->GetField<uint8_t>(offset, 0));
+          break;
+        case flatbuffers::BASE_TYPE_UNION:
+          if (union_table &&
+              !SubTable(*union_table,
+                        table->GetPointer<const flatbuffers::Table *>(
+                            offset))) {
+            return false;
+          }
+          break;
+        case flatbuffers::BASE_TYPE_STRUCT:
+          if (!type.struct_def->fixed &&
+              !SubTable(*type.struct_def,
+                        table->GetPointer<const flatbuffers::Table *>(
+                            offset))) {
+            return false;
+          }
+          break;
+        case flatbuffers::BASE_TYPE_VECTOR:
+          if (type.element == flatbuffers::BASE_TYPE_UTYPE) {
+            union_types =
+                table->GetPointer<const flatbuffers::Vector<uint8_t> *>(
+                    offset);
+          } else if (!Vector(*fd, table, union_types)) {
+            return false;
+          }
+          break;
+        default: break;
+      }
+    }
+    return true;
+  }
+
+ private:
+  using Tables = flatbuffers::Vector<flatbuffers::Offset<flatbuffers::Table>>;
+
+  static const StructDef *UnionTable(const flatbuffers::Type &type,
+                                     uint8_t value) {
+    const auto enum_val = type.enum_def->ReverseLookup(value, true);
+    if (!enum_val) return nullptr;
+    const auto sd = enum_val->union_type.struct_def;
+    return enum_val->union_type.base_type == flatbuffers::BASE_TYPE_STRUCT &&
+                   sd && !sd->fixed
+               ? sd
+               : nullptr;
+  }
+
+  bool SubTable(const StructDef &struct_def, const flatbuffers::Table *table) {
+    return !table || Table(struct_def, table);
+  }
+
+  bool Vector(const flatbuffers::FieldDef &fd,
+              const flatbuffers::Table *table,
+              const flatbuffers::Vector<uint8_t> *union_types) {
+    const auto &type = fd.value.type;
+    if (fd.nested_flatbuffer) {
+      return Nested(
+          fd, table->GetPointer<const flatbuffers::Vector<uint8_t> *>(
+                  fd.value.offset));
+    }
+    const auto is_table = type.element == flatbuffers::BASE_TYPE_STRUCT &&
+                          !type.struct_def->fixed;
+    const auto is_union = type.element == flatbuffers::BASE_TYPE_UNION;
+    if (!is_table && !is_union) return true;
+    const auto tables = table->GetPointer<const Tables *>(fd.value.offset);
+    if (!tables) return true;
+    for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++) {
+      const auto sd =
+          is_table ? type.struct_def
+                   : union_types && i < union_types->size()
+                         ? UnionTable(type, union_types->Get(i))
+                         : nullptr;
+      if (sd && !SubTable(*sd, tables->Get(i))) return false;
+    }
+    return true;
+  }
+
+  bool Nested(const flatbuffers::FieldDef &fd,
+              const flatbuffers::Vector<uint8_t> *bytes) {
+    if (!bytes) return true;
+    const auto &nested = *fd.nested_flatbuffer;
+    const auto name = nested.defined_namespace
+                          ? nested.defined_namespace->GetFullyQualifiedName(
+                                nested.name)
+                          : nested.name;
+    // the verifier checks alignment by address, the vector is only aligned
+    // to its length field
+    std::vector<uint64_t> aligned((bytes->size() + 7) / 8);
+    if (bytes->size()) {
+      std::memcpy(aligned.data(), bytes->Data(), bytes->size());
+    }
+    const auto data = reinterpret_cast<const uint8_t *>(aligned.data());
+    const auto schema = Schema();
+    const auto object = schema->objects()->LookupByKey(name.c_str());
+    if (!object || !flatbuffers::Verify(*schema, *object, data,
+                                        bytes->size()) ||
+        !Table(nested, flatbuffers::GetRoot<flatbuffers::Table>(data))) {
+      if (parser_->error_.empty()) {
+        parser_->error_ = "field " + fd.name + " is not a valid nested " +
+                          name + " FlatBuffer";
+      }
+      return false;
+    }
+    return true;
+  }
+
+  // `Parser::Serialize` of the schema, once there is a nested buffer.
+  const reflection::Schema *Schema() {
+    if (bfbs_.empty()) {
+      parser_->Serialize();
+      bfbs_.assign(
+          reinterpret_cast<const char *>(parser_->builder_.GetBufferPointer()),
+          parser_->builder_.GetSize());
+      parser_->builder_.Clear();
+    }
+    return reflection::GetSchema(bfbs_.data());
+  }
+
+  flatbuffers::Parser *parser_;
+  std::string bfbs_;
+};
+
+// Whether a table of the schema has a `nested_flatbuffer` field.
+bool HasNestedFlatbuffers(const flatbuffers::Parser &parser) {
+  for (const auto sd : parser.structs_.vec) {
+    for (const auto fd : sd->fields.vec) {
+      if (fd->nested_flatbuffer) return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+bool ParseVerified(flatbuffers::Parser *parser, const char *json,
+                   VerifiedBuffer *buffer, const char *source_filename) {
+  *buffer = VerifiedBuffer();
+  if (!parser->Parse(json, nullptr, source_filename)) return false;
+  // declarations are parsed without building a buffer
+  if (!parser->builder_.GetSize()) {
+    parser->error_ = "no JSON document to build a buffer from";
+    return false;
+  }
+  buffer->buffer_ = parser->builder_.Release();
+  buffer->root_ = parser->root_struct_def_;
+  buffer->size_prefixed_ = parser->opts.size_prefixed;
+  if (HasNestedFlatbuffers(*parser)) {
+    // the builder is free again, `Parser::Serialize` may use it
+    parser->error_.clear();
+    auto data = buffer->data();
+    if (buffer->size_prefixed_) data += sizeof(flatbuffers::uoffset_t);
+    NestedChecker checker(parser);
+    if (!checker.Table(*buffer->root_,
+                       flatbuffers::GetRoot<flatbuffers::Table>(data))) {
+      *buffer = VerifiedBuffer();
+      return false;
+    }
+  }
+#ifdef FBJSON_CHECK_VERIFIED
+  if (!CrossCheckVerified(parser, *buffer)) {
+    *buffer = VerifiedBuffer();
+    return false;
+  }
+#endif
+  return true;
+}
+
+bool CrossCheckVerified(flatbuffers::Parser *parser,
+                        const VerifiedBuffer &buffer) {
+  if (buffer.empty()) {
+    parser->error_ = "cross-check: empty buffer";
+    return false;
+  }
+  const auto root = buffer.root_type();
+  const auto name = root->defined_namespace
+                        ? root->defined_namespace->GetFullyQualifiedName(
+                              root->name)
+                        : root->name;
+  parser->Serialize();
+  const auto schema =
+      reflection::GetSchema(parser->builder_.GetBufferPointer());
+  const auto object = schema->objects()->LookupByKey(name.c_str());
+  auto data = buffer.data();
+  auto size = buffer.size();
+  if (buffer.size_prefixed()) {
+    data += sizeof(flatbuffers::uoffset_t);
+    size -= sizeof(flatbuffers::uoffset_t);
+  }
+  const auto ok =
+      object && flatbuffers::Verify(*schema, *object, data, size);
+  parser->builder_.Clear();
+  if (!ok) {
+    parser->error_ = "cross-check: the verifier rejects the buffer of " + name;
+  }
+  return ok;
+}
+
+}  // namespace fbjson
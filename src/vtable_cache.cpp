@@ -0,0 +1,126 @@
+#include "fbjson/vtable_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+// `EndTable` below copies the vtable layout from this release.
+#if FLATBUFFERS_VERSION_MAJOR == 1 && FLATBUFFERS_VERSION_MINOR == 10
+#define FBJSON_VTABLE_HASH 1
+#else
+#define FBJSON_VTABLE_HASH 0
+#endif
+
+namespace fbjson {
+
+void VtableCacheBuilder::SetVtableDedup(VtableDedup mode) {
+  mode_ = mode == VtableDedup::kHash && !FBJSON_VTABLE_HASH
+              ? VtableDedup::kLinear
+              : mode;
+  DedupVtables(mode != VtableDedup::kNone);
+}
+
+void VtableCacheBuilder::Clear() {
+  FlatBufferBuilder::Clear();
+  std::fill(index_.begin(), index_.end(), Slot());
+  num_vtables_ = 0;
+}
+
+void VtableCacheBuilder::Reset() {
+  FlatBufferBuilder::Reset();
+  std::vector<Slot>().swap(index_);
+  num_vtables_ = 0;
+}
+
+flatbuffers::uoffset_t VtableCacheBuilder::FindOrAdd(
+    const uint8_t *vtable, flatbuffers::voffset_t size,
+    flatbuffers::uoffset_t offset) {
+  // keep the load factor at most 1/2
+  if (2 * (num_vtables_ + 1) > index_.size()) {
+    std::vector<Slot> slots(std::max<size_t>(64, 2 * index_.size()), Slot());
+    const auto mask = slots.size() - 1;
+    for (const auto &slot : index_) {
+      if (!slot.offset) continue;
+      auto i = slot.hash & mask;
+      while (slots[i].offset) i = (i + 1) & mask;
+      slots[i] = slot;
+    }
+    index_.swap(slots);
+  }
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (flatbuffers::voffset_t i = 0; i < size; i++) {
+    hash = (hash ^ vtable[i]) * 16777619u;
+  }
+  const auto mask = index_.size() - 1;
+  auto i = hash & mask;
+  for (; index_[i].offset; i = (i + 1) & mask) {
+    if (index_[i].hash != hash) continue;
+    const auto other = buf_.data_at(index_[i].offset);
+    if (flatbuffers::ReadScalar<flatbuffers::voffset_t>(other) == size &&
+        !std::memcmp(other, vtable, size)) {
+      return index_[i].offset;
+    }
+  }
+  index_[i] = { hash, offset };
+  num_vtables_++;
+  return 0;
+}
+
+// Same layout as `FlatBufferBuilder::EndTable`, the vtable is looked up in
+// the hash index instead of the list of all vtables.
+flatbuffers::uoffset_t VtableCacheBuilder::EndTable(
+    flatbuffers::uoffset_t start) {
+#if !FBJSON_VTABLE_HASH
+  return FlatBufferBuilder::EndTable(start);
+#else
+  if (mode_ != VtableDedup::kHash) return FlatBufferBuilder::EndTable(start);
+  FLATBUFFERS_ASSERT(nested);
+  // Write the vtable offset, which is the start of any Table.
+  // We fill its value later.
+  const auto vtableoffsetloc = PushElement<flatbuffers::soffset_t>(0);
+  // Write a vtable, which consists entirely of voffset_t elements.
+  max_voffset_ = std::max(
+      static_cast<flatbuffers::voffset_t>(max_voffset_ +
+                                          sizeof(flatbuffers::voffset_t)),
+      flatbuffers::FieldIndexToOffset(0));
+  buf_.fill_big(max_voffset_);
+  const auto table_object_size = vtableoffsetloc - start;
+  // Vtable use 16bit offsets.
+  FLATBUFFERS_ASSERT(table_object_size < 0x10000);
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(
+      buf_.data() + sizeof(flatbuffers::voffset_t),
+      static_cast<flatbuffers::voffset_t>(table_object_size));
+  flatbuffers::WriteScalar<flatbuffers::voffset_t>(buf_.data(), max_voffset_);
+  // Write the offsets into the table
+  for (auto it = buf_.scratch_end() - num_field_loc * sizeof(FieldLoc);
+       it < buf_.scratch_end(); it += sizeof(FieldLoc)) {
+    const auto field_location = reinterpret_cast<FieldLoc *>(it);
+    const auto pos =
+        static_cast<flatbuffers::voffset_t>(vtableoffsetloc -
+                                            field_location->off);
+    flatbuffers::WriteScalar<flatbuffers::voffset_t>(
+        buf_.data() + field_location->id, pos);
+  }
+  ClearOffsets();
+  const auto vt_size =
+      flatbuffers::ReadScalar<flatbuffers::voffset_t>(buf_.data());
+  auto vt_use = FindOrAdd(buf_.data(), vt_size, GetSize());
+  if (vt_use) {
+    // identical vtable found, drop the new one
+    buf_.pop(GetSize() - vtableoffsetloc);
+  } else {
+    vt_use = GetSize();
+    // also visible to the linear search if the mode changes
+    buf_.scratch_push_small(vt_use);
+  }
+  // Fill the vtable offset we created above.
+  flatbuffers::WriteScalar(buf_.data_at(vtableoffsetloc),
+                           static_cast<flatbuffers::soffset_t>(vt_use) -
+                               static_cast<flatbuffers::soffset_t>(
+                                   vtableoffsetloc));
+  nested = false;
+  return vtableoffsetloc;
+#endif
+}
+
+}  // namespace fbjson
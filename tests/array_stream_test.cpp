@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "fbjson/array_stream.h"
+#include "gtest/gtest.h"
+
+#include "json_test_base.h"
+
+using Status = fbjson::ArrayStreamParser::Status;
+
+class ArrayStreamTest : public TestFixtureBase {
+ protected:
+  void SetUp() override {
+    TestFixtureBase::SetUp();
+    ASSERT_TRUE(parser_.Parse("root_type fbt.tStrInt;")) << parser_.error_;
+  }
+
+  std::string Finished() const {
+    return std::string(
+        reinterpret_cast<const char *>(parser_.builder_.GetBufferPointer()),
+        parser_.builder_.GetSize());
+  }
+
+  // Elements with brackets, commas, quotes and escapes inside strings.
+  static std::vector<std::string> Elements(size_t count) {
+    static const char *const strings[] = {
+      "plain", "]", "}", "[{", "\\\"}]\\\"", ",", "\\\\", "\\u005d\\u007d",
+      "{\\\"f1\\\": 1}", "\\/ \\b\\f\\n\\r\\t",
+    };
+    std::vector<std::string> elements;
+    for (size_t i = 0; i < count; i++) {
+      elements.push_back("{\"f1\": \"" + std::string(strings[i % 10]) +
+                         "\", \"f2\": " + std::to_string(i) + "}");
+    }
+    return elements;
+  }
+
+  static std::string Join(const std::vector<std::string> &elements) {
+    std::string json = "[";
+    for (size_t i = 0; i < elements.size(); i++) {
+      json += (i ? ",\n  " : "\n  ") + elements[i];
+    }
+    return json + "\n]\n";
+  }
+
+  // Buffers of separately parsed elements.
+  std::vector<std::string> Expected(const std::vector<std::string> &elements) {
+    std::vector<std::string> buffers;
+    for (const auto &e : elements) {
+      EXPECT_TRUE(parser_.Parse(e.c_str())) << parser_.error_;
+      buffers.push_back(Finished());
+    }
+    return buffers;
+  }
+
+  // Stream `json` in chunks of `chunk_size` bytes.
+  Status Stream(const std::string &json, size_t chunk_size,
+                std::vector<std::string> *buffers, std::string *error) {
+    fbjson::ArrayStreamParser stream(&parser_);
+    for (size_t pos = 0; pos < json.size();) {
+      const auto size = std::min(chunk_size, json.size() - pos);
+      size_t consumed = 0;
+      const auto status = stream.Feed(json.data() + pos, size, &consumed);
+      pos += consumed;
+      if (status == Status::kElement) {
+        buffers->push_back(Finished());
+      } else if (status != Status::kNeedMoreData) {
+        *error = stream.error();
+        return status;
+      } else {
+        EXPECT_EQ(size, consumed);
+      }
+    }
+    const auto status = stream.Finish();
+    *error = stream.error();
+    return status;
+  }
+};
+
+TEST_F(ArrayStreamTest, ElementsMatchSeparateParse) {
+  const auto elements = Elements(200);
+  const auto expected = Expected(elements);
+  const auto json = Join(elements);
+  for (size_t chunk_size : { size_t(1), size_t(3), size_t(64), json.size() }) {
+    std::vector<std::string> buffers;
+    std::string error;
+    ASSERT_EQ(Status::kDone, Stream(json, chunk_size, &buffers, &error))
+        << "chunk " << chunk_size << ": " << error;
+    ASSERT_EQ(expected.size(), buffers.size()) << "chunk " << chunk_size;
+    for (size_t i = 0; i < expected.size(); i++) {
+      ASSERT_EQ(expected[i], buffers[i]) << "chunk " << chunk_size
+                                         << ", element " << i;
+    }
+  }
+}
+
+TEST_F(ArrayStreamTest, EmptyArray) {
+  std::vector<std::string> buffers;
+  std::string error;
+  EXPECT_EQ(Status::kDone, Stream(" [ \n ] ", 2, &buffers, &error)) << error;
+  EXPECT_TRUE(buffers.empty());
+}
+
+TEST_F(ArrayStreamTest, Errors) {
+  const char *const cases[][2] = {
+    { R"({"f1": "a"})", "must be an array" },
+    { R"([1])", "element 0 must be an object" },
+    { R"([{"f1": "a"} {"f2": 1}])", "expected ','" },
+    { R"([{"f1": "a"},])", "element 1 must be an object" },
+    { R"([{"f1": "a"}, {"f1": 1}])", "array element 1:" },
+    { R"([{"f1": "a"}, {"f2": 1])", "mismatched" },
+    { R"([{"f1": "a"})", "unexpected end of input" },
+    { "", "empty input" },
+  };
+  for (const auto &c : cases) {
+    std::vector<std::string> buffers;
+    std::string error;
+    EXPECT_EQ(Status::kError, Stream(c[0], 4, &buffers, &error)) << c[0];
+    EXPECT_NE(error.find(c[1]), std::string::npos) << c[0] << ": " << error;
+  }
+}
+
+TEST_F(ArrayStreamTest, TrailingCommaIfNotStrict) {
+  parser_.opts.strict_json = false;
+  std::vector<std::string> buffers;
+  std::string error;
+  EXPECT_EQ(Status::kDone,
+            Stream(R"([{"f1": "a"},])", 4, &buffers, &error)) << error;
+  EXPECT_EQ(1u, buffers.size());
+}
+
+#ifdef FBJSON_HAS_COROUTINES
+TEST_F(ArrayStreamTest, Generator) {
+  const auto elements = Elements(100);
+  const auto expected = Expected(elements);
+  const auto json = Join(elements);
+  size_t pos = 0;
+  fbjson::ChunkReader read = [&](char *buf, size_t size) {
+    const auto n = std::min(size, json.size() - pos);
+    std::memcpy(buf, json.data() + pos, n);
+    pos += n;
+    return n;
+  };
+  std::string error;
+  size_t i = 0;
+  for (auto &buf : fbjson::ParseArrayElements(&parser_, read, &error, 7)) {
+    ASSERT_LT(i, expected.size());
+    EXPECT_EQ(expected[i++],
+              std::string(reinterpret_cast<const char *>(buf.data()),
+                          buf.size()));
+  }
+  EXPECT_TRUE(error.empty()) << error;
+  EXPECT_EQ(expected.size(), i);
+
+  // elements before an error are still yielded
+  const std::string valid = elements[0] + "," + elements[1] + ",";
+  const auto invalid = "[" + valid + "{\"f1\": 1}]";
+  pos = 0;
+  read = [&](char *buf, size_t size) {
+    const auto n = std::min(size, invalid.size() - pos);
+    std::memcpy(buf, invalid.data() + pos, n);
+    pos += n;
+    return n;
+  };
+  i = 0;
+  for (auto &buf : fbjson::ParseArrayElements(&parser_, read, &error)) {
+    (void)buf;
+    i++;
+  }
+  EXPECT_EQ(2u, i);
+  EXPECT_NE(error.find("array element 2"), std::string::npos) << error;
+}
+#endif  // FBJSON_HAS_COROUTINES
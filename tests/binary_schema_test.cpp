@@ -0,0 +1,206 @@
+#include <string>
+#include "fbjson/binary_schema.h"
+#include "fbjson/options.h"
+#include "flatbuffers/idl.h"
+#include "gtest/gtest.h"
+
+// `test.fbs` has tables only, check the other kinds of definitions.
+static const char *const kRichSchema = R"(
+namespace rich.ns;
+enum Color : byte { Red = 1, Green, Blue = 8 }
+struct Vec3 { x: float; y: float; z: float; }
+struct Padded { a: byte; b: int; c: short; v: Vec3; }
+table Leaf { name: string (key); hp: short = 150; }
+table Other { value: long = -5; }
+union Any { Leaf, Other }
+table Root {
+  pos: Padded;
+  color: Color = Blue;
+  colors: [Color];
+  leaves: [Leaf];
+  any: Any;
+  flag: bool = true;
+  ratio: double = 0.5;
+  names: [string];
+  structs: [Vec3];
+  deprecated_field: int (deprecated);
+  big: ulong;
+}
+root_type Root;
+file_identifier "RICH";
+file_extension "rich";
+)";
+
+static const char *const kRichJson = R"({
+  pos: { a: -1, b: 2147483647, c: -300, v: { x: 1.5, y: -2.25, z: 3 } },
+  color: Green,
+  colors: [ Red, "Blue", 2 ],
+  leaves: [ { name: "a", hp: 150 }, { name: "b", hp: -1 } ],
+  any_type: Other,
+  any: { value: 42 },
+  flag: false,
+  ratio: 0.125,
+  names: [ "x", "yé" ],
+  structs: [ { x: 1, y: 2, z: 3 }, { x: 4, y: 5, z: 6 } ],
+  big: 1234567890123
+})";
+
+class BinarySchemaTest : public ::testing::Test {
+ protected:
+  flatbuffers::Parser text_parser_;
+  flatbuffers::Parser binary_parser_;
+  std::string bfbs_;
+
+  void SetUp() override {
+    auto opts = fbjson::StrictJsonOptions();
+    opts.strict_json = false;
+    text_parser_.opts = opts;
+    binary_parser_.opts = opts;
+    ASSERT_TRUE(text_parser_.Parse(kRichSchema)) << text_parser_.error_;
+    text_parser_.Serialize();
+    bfbs_.assign(reinterpret_cast<const char *>(
+                     text_parser_.builder_.GetBufferPointer()),
+                 text_parser_.builder_.GetSize());
+    std::string error;
+    ASSERT_TRUE(fbjson::LoadBinarySchema(
+        reinterpret_cast<const uint8_t *>(bfbs_.data()), bfbs_.size(),
+        &binary_parser_, &error))
+        << error;
+  }
+
+  static std::string Buffer(const flatbuffers::Parser &parser) {
+    return std::string(
+        reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+        parser.builder_.GetSize());
+  }
+};
+
+TEST_F(BinarySchemaTest, SchemaProperties) {
+  ASSERT_NE(binary_parser_.root_struct_def_, nullptr);
+  EXPECT_EQ(binary_parser_.root_struct_def_->name, "Root");
+  EXPECT_EQ(binary_parser_.file_identifier_, "RICH");
+  EXPECT_EQ(binary_parser_.file_extension_, "rich");
+  auto padded = binary_parser_.structs_.Lookup("rich.ns.Padded");
+  ASSERT_NE(padded, nullptr);
+  auto text_padded = text_parser_.structs_.Lookup("rich.ns.Padded");
+  ASSERT_EQ(padded->fields.vec.size(), text_padded->fields.vec.size());
+  for (size_t i = 0; i < padded->fields.vec.size(); i++) {
+    EXPECT_EQ(padded->fields.vec[i]->name, text_padded->fields.vec[i]->name);
+    EXPECT_EQ(padded->fields.vec[i]->value.offset,
+              text_padded->fields.vec[i]->value.offset);
+    EXPECT_EQ(padded->fields.vec[i]->padding,
+              text_padded->fields.vec[i]->padding);
+  }
+  EXPECT_EQ(padded->bytesize, text_padded->bytesize);
+}
+
+TEST_F(BinarySchemaTest, SameBufferAsTextSchema) {
+  ASSERT_TRUE(text_parser_.Parse(kRichJson)) << text_parser_.error_;
+  ASSERT_TRUE(binary_parser_.Parse(kRichJson)) << binary_parser_.error_;
+  EXPECT_EQ(Buffer(text_parser_), Buffer(binary_parser_));
+
+  std::string text_1, text_2;
+  ASSERT_TRUE(flatbuffers::GenerateText(
+      text_parser_, text_parser_.builder_.GetBufferPointer(), &text_1));
+  ASSERT_TRUE(flatbuffers::GenerateText(
+      binary_parser_, binary_parser_.builder_.GetBufferPointer(), &text_2));
+  EXPECT_EQ(text_1, text_2);
+}
+
+TEST_F(BinarySchemaTest, TextDeclarationsAfterBinarySchema) {
+  ASSERT_TRUE(binary_parser_.Parse("root_type rich.ns.Leaf;"))
+      << binary_parser_.error_;
+  ASSERT_TRUE(binary_parser_.Parse(R"({ name: "leaf" })"))
+      << binary_parser_.error_;
+  ASSERT_TRUE(binary_parser_.Parse("table Extra { leaf: rich.ns.Leaf; }"
+                                   "root_type Extra;"))
+      << binary_parser_.error_;
+  EXPECT_TRUE(binary_parser_.Parse(R"({ leaf: { hp: 1 } })"))
+      << binary_parser_.error_;
+}
+
+TEST_F(BinarySchemaTest, UserAttributes) {
+  // the loaded definitions own their attribute values
+  flatbuffers::Parser text_parser(text_parser_.opts);
+  ASSERT_TRUE(text_parser.Parse(R"(
+    attribute "priority";
+    attribute "owner";
+    attribute "deprecated_since";
+    table Tagged (owner: "ops") {
+      tags: [string] (priority: "1");
+      level: int (priority: "2", deprecated_since: "3");
+    }
+    root_type Tagged;
+  )")) << text_parser.error_;
+  text_parser.Serialize();
+  flatbuffers::Parser binary_parser(text_parser_.opts);
+  std::string error;
+  ASSERT_TRUE(fbjson::LoadBinarySchema(text_parser.builder_.GetBufferPointer(),
+                                       text_parser.builder_.GetSize(),
+                                       &binary_parser, &error))
+      << error;
+  const auto tagged = binary_parser.structs_.Lookup("Tagged");
+  ASSERT_NE(tagged, nullptr);
+  const auto owner = tagged->attributes.Lookup("owner");
+  ASSERT_NE(owner, nullptr);
+  EXPECT_EQ(owner->constant, "ops");
+  const auto level = tagged->fields.Lookup("level");
+  ASSERT_NE(level, nullptr);
+  EXPECT_EQ(level->attributes.Lookup("priority")->constant, "2");
+  EXPECT_EQ(level->attributes.Lookup("deprecated_since")->constant, "3");
+
+  ASSERT_TRUE(text_parser.Parse(R"({ tags: ["a"], level: 4 })"))
+      << text_parser.error_;
+  ASSERT_TRUE(binary_parser.Parse(R"({ tags: ["a"], level: 4 })"))
+      << binary_parser.error_;
+  EXPECT_EQ(Buffer(text_parser), Buffer(binary_parser));
+}
+
+TEST_F(BinarySchemaTest, DefaultsAndNestedNames) {
+  // defaults with more than 12 digits, a nested root named relative to the
+  // namespace of the table
+  flatbuffers::Parser text_parser(text_parser_.opts);
+  text_parser.opts.binary_schema_builtins = true;
+  ASSERT_TRUE(text_parser.Parse(R"(
+    namespace nest.ns;
+    table Inner { x: int; }
+    table Outer {
+      ratio: double = 0.1234567890123456;
+      big: ulong = 18446744073709551615;
+      inner: [ubyte] (nested_flatbuffer: "Inner");
+    }
+    root_type Outer;
+  )")) << text_parser.error_;
+  text_parser.Serialize();
+  flatbuffers::Parser binary_parser(text_parser_.opts);
+  std::string error;
+  ASSERT_TRUE(fbjson::LoadBinarySchema(text_parser.builder_.GetBufferPointer(),
+                                       text_parser.builder_.GetSize(),
+                                       &binary_parser, &error))
+      << error;
+  const auto outer = binary_parser.structs_.Lookup("nest.ns.Outer");
+  ASSERT_NE(outer, nullptr);
+  EXPECT_EQ(outer->fields.Lookup("inner")->nested_flatbuffer,
+            binary_parser.structs_.Lookup("nest.ns.Inner"));
+
+  // fields equal to their default aren't written
+  const auto json = R"({ ratio: 0.1234567890123456, big: 18446744073709551615,
+                         inner: { x: 1 } })";
+  ASSERT_TRUE(text_parser.Parse(json)) << text_parser.error_;
+  ASSERT_TRUE(binary_parser.Parse(json)) << binary_parser.error_;
+  EXPECT_EQ(Buffer(text_parser), Buffer(binary_parser));
+}
+
+TEST_F(BinarySchemaTest, Errors) {
+  std::string error;
+  flatbuffers::Parser parser;
+  EXPECT_FALSE(fbjson::LoadBinarySchema(
+      reinterpret_cast<const uint8_t *>(kRichJson), 16, &parser, &error));
+  EXPECT_FALSE(error.empty());
+  // type definitions can't be merged
+  error.clear();
+  EXPECT_FALSE(fbjson::LoadBinarySchema(
+      reinterpret_cast<const uint8_t *>(bfbs_.data()), bfbs_.size(),
+      &binary_parser_, &error));
+  EXPECT_FALSE(error.empty());
+}
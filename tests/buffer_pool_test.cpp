@@ -0,0 +1,120 @@
+#include <cstring>
+#include <string>
+#include <vector>
+#include "fbjson/buffer_pool.h"
+#include "fbjson/options.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+
+TEST(BufferPoolTest, ReleasedBuffersAreReused) {
+  fbjson::BufferPool pool;
+  const uint8_t *first = nullptr;
+  for (int i = 0; i < 3; i++) {
+    flatbuffers::FlatBufferBuilder builder(1024, &pool);
+    builder.Finish(builder.CreateString("document"));
+    const auto buf = builder.Release();
+    if (!first) first = buf.data();
+    // the buffer returns to the pool when `buf` is destroyed
+    EXPECT_EQ(first, buf.data());
+  }
+  const auto stats = pool.stats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 2u);
+}
+
+TEST(BufferPoolTest, SizeClasses) {
+  fbjson::BufferPoolOptions opts;
+  opts.min_size = 1024;
+  opts.max_size = 4096;
+  fbjson::BufferPool pool(opts);
+  const auto small = pool.allocate(100);
+  pool.deallocate(small, 100);
+  // same class
+  EXPECT_EQ(small, pool.allocate(1024));
+  // another class
+  const auto medium = pool.allocate(1025);
+  EXPECT_NE(small, medium);
+  pool.deallocate(medium, 1025);
+  pool.deallocate(small, 1024);
+  // not pooled
+  const auto large = pool.allocate(4097);
+  pool.deallocate(large, 4097);
+  EXPECT_EQ(pool.stats().cached_bytes, 1024u + 2048u);
+}
+
+TEST(BufferPoolTest, CacheIsBounded) {
+  fbjson::BufferPoolOptions opts;
+  opts.max_cached_bytes = 4096;
+  fbjson::BufferPool pool(opts);
+  std::vector<uint8_t *> buffers;
+  for (int i = 0; i < 8; i++) buffers.push_back(pool.allocate(1024));
+  for (auto p : buffers) pool.deallocate(p, 1024);
+  EXPECT_EQ(pool.stats().cached_bytes, 4096u);
+}
+
+TEST(BufferPoolTest, HugePageSlabs) {
+  fbjson::BufferPoolOptions opts;
+  opts.huge_pages = true;
+  fbjson::BufferPool pool(opts);
+  const auto a = pool.allocate(4096);
+  const auto b = pool.allocate(4096);
+  EXPECT_NE(a, b);
+  // one slab serves both
+  EXPECT_EQ(pool.stats().mapped_bytes, size_t(2) << 20);
+  const auto big = pool.allocate(size_t(3) << 20);
+  std::memset(big, 1, size_t(3) << 20);
+  pool.deallocate(a, 4096);
+  pool.deallocate(b, 4096);
+  pool.deallocate(big, size_t(3) << 20);
+  const auto mapped = pool.stats().mapped_bytes;
+
+  // freed buffers are reused without mapping more memory
+  const auto hits = pool.stats().hits;
+  const auto c = pool.allocate(4096);
+  EXPECT_TRUE(c == a || c == b);
+  EXPECT_EQ(pool.allocate(size_t(3) << 20), big);
+  EXPECT_EQ(pool.stats().hits, hits + 2);
+  EXPECT_EQ(pool.stats().mapped_bytes, mapped);
+  pool.deallocate(c, 4096);
+  pool.deallocate(big, size_t(3) << 20);
+}
+
+TEST(BufferPoolTest, HugePageCacheIsBounded) {
+  fbjson::BufferPoolOptions opts;
+  opts.huge_pages = true;
+  opts.max_cached_bytes = size_t(6) << 20;
+  fbjson::BufferPool pool(opts);
+  uint8_t *big[2];
+  for (auto &p : big) p = pool.allocate(size_t(3) << 20);
+  EXPECT_EQ(pool.stats().mapped_bytes, size_t(8) << 20);
+  for (auto p : big) pool.deallocate(p, size_t(3) << 20);
+  // the second 4 MiB buffer doesn't fit the cache and is unmapped
+  const auto stats = pool.stats();
+  EXPECT_EQ(stats.cached_bytes, size_t(4) << 20);
+  EXPECT_EQ(stats.mapped_bytes, size_t(4) << 20);
+}
+
+TEST(BufferPoolTest, ParserOutputIsUnchanged) {
+  fbjson::BufferPool pool;
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  std::string schema;
+  ASSERT_TRUE(flatbuffers::LoadFile(FLATBUFFERS_FBS_DIR "test.fbs", false,
+                                    &schema));
+  ASSERT_TRUE(parser.Parse(schema.c_str())) << parser.error_;
+  ASSERT_TRUE(parser.SetRootType("fbt.tStrIntInt"));
+  const auto json = R"({"f1": "test", "f2": 1, "f3": 2})";
+  ASSERT_TRUE(parser.Parse(json)) << parser.error_;
+  const std::string expected(
+      reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+      parser.builder_.GetSize());
+  parser.builder_ = flatbuffers::FlatBufferBuilder(1024, &pool);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(parser.Parse(json)) << parser.error_;
+    const auto buf = parser.builder_.Release();
+    EXPECT_EQ(expected, std::string(reinterpret_cast<const char *>(buf.data()),
+                                    buf.size()));
+  }
+  EXPECT_GT(pool.stats().hits, 0u);
+  parser.builder_ = flatbuffers::FlatBufferBuilder();
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "fbjson/document_framer.h"
+#include "gtest/gtest.h"
+
+#include "json_test_base.h"
+
+using Status = fbjson::DocumentFramer::Status;
+
+// Feed `json` in two chunks split at `split`, then finish the input.
+// Returns true if a FlatBuffer was built and the rest of input is blank.
+static bool ParseChunked(fbjson::DocumentFramer &framer,
+                         const std::string &json, size_t split,
+                         size_t chunk_size = 0) {
+  framer.Reset();
+  std::string rest;
+  auto status = Status::kNeedMoreData;
+  auto feed = [&](const char *data, size_t size) {
+    if (status != Status::kNeedMoreData) {
+      rest.append(data, size);
+      return;
+    }
+    size_t consumed = 0;
+    status = framer.Feed(data, size, &consumed);
+    rest.append(data + consumed, size - consumed);
+  };
+  if (chunk_size) {
+    for (size_t pos = 0; pos < json.size(); pos += chunk_size) {
+      feed(json.data() + pos, std::min(chunk_size, json.size() - pos));
+    }
+  } else {
+    feed(json.data(), split);
+    feed(json.data() + split, json.size() - split);
+  }
+  if (status == Status::kNeedMoreData) status = framer.Finish();
+  return status == Status::kDone &&
+         fbjson::JsonScanner::IsBlank(rest.data(), rest.size());
+}
+
+// Split points: every offset for small documents.
+static std::vector<size_t> SplitPoints(size_t size) {
+  std::vector<size_t> points;
+  const size_t step = std::max<size_t>(1, size / 256);
+  for (size_t i = 0; i <= size; i += step) points.push_back(i);
+  if (points.back() != size) points.push_back(size);
+  return points;
+}
+
+class DocumentFramerTest : public TestFixtureBase {
+ protected:
+  // Compare chunked parse of `json` with the parse of the whole text.
+  void CompareWithParse(const std::string &json) {
+    // the parser stops at zero byte, do the same for the chunked input
+    const std::string text(json.c_str());
+    const auto expected =
+        parser_.Parse(text.c_str()) && parser_.builder_.GetSize() != 0;
+    const std::string expected_buf(
+        reinterpret_cast<const char *>(parser_.builder_.GetBufferPointer()),
+        expected ? parser_.builder_.GetSize() : 0);
+
+    fbjson::DocumentFramer framer(&parser_);
+    for (auto split : SplitPoints(text.size())) {
+      const auto done = ParseChunked(framer, text, split);
+      ASSERT_EQ(expected, done)
+          << "split at " << split << ": " << framer.error();
+      if (done) {
+        const std::string buf(
+            reinterpret_cast<const char *>(
+                parser_.builder_.GetBufferPointer()),
+            parser_.builder_.GetSize());
+        ASSERT_EQ(expected_buf, buf) << "split at " << split;
+      }
+    }
+    ASSERT_EQ(expected, ParseChunked(framer, text, 0, 1))
+        << "byte by byte: " << framer.error();
+  }
+};
+
+class ParamDocumentFramerTest
+    : public DocumentFramerTest,
+      public ::testing::WithParamInterface<TestParam> {};
+
+TEST_P(ParamDocumentFramerTest, SplitAtEveryOffset) {
+  const auto root = std::get<1>(GetParam());
+  const auto json = std::get<2>(GetParam());
+  ASSERT_TRUE(parser_.Parse(root)) << parser_.error_;
+  std::string text = json;
+  if (*json == '/') {
+    const auto full_fname =
+        flatbuffers::ConCatPathFileName(JSON_SAMPLES_DIR, json);
+    ASSERT_TRUE(flatbuffers::LoadFile(full_fname.c_str(), false, &text));
+  }
+  CompareWithParse(text);
+}
+
+static std::vector<TestParam> framer_dataset() {
+  auto dataset = json_org_dataset(true);
+  const auto seriot = seriot_dataset(true);
+  dataset.insert(dataset.end(), seriot.begin(), seriot.end());
+  return dataset;
+}
+
+INSTANTIATE_TEST_CASE_P(datasets, ParamDocumentFramerTest,
+                        ::testing::ValuesIn(framer_dataset()));
+
+// Every file of the datasets, with a root type that accepts any object.
+TEST_F(DocumentFramerTest, AllDatasetFiles) {
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tEmpty;")) << parser_.error_;
+  namespace fs = std::filesystem;
+  size_t files = 0;
+  for (const char *dir : { "json.org", "nst.JSONTestSuite" }) {
+    for (const auto &entry :
+         fs::directory_iterator(fs::path(JSON_SAMPLES_DIR) / dir)) {
+      if (entry.path().extension() != ".json") continue;
+      std::string json;
+      ASSERT_TRUE(
+          flatbuffers::LoadFile(entry.path().string().c_str(), false, &json));
+      SCOPED_TRACE(entry.path().string());
+      CompareWithParse(json);
+      if (HasFatalFailure()) return;
+      files++;
+    }
+  }
+  EXPECT_GT(files, 300u);
+}
+
+TEST_F(DocumentFramerTest, NeedMoreDataIsNotAnError) {
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tStr;")) << parser_.error_;
+  const std::string json = R"(["Unclosed array")";
+  fbjson::DocumentFramer framer(&parser_);
+  for (size_t split = 0; split <= json.size(); split++) {
+    framer.Reset();
+    EXPECT_EQ(Status::kNeedMoreData, framer.Feed(json.data(), split));
+    EXPECT_EQ(Status::kNeedMoreData,
+              framer.Feed(json.data() + split, json.size() - split));
+    EXPECT_TRUE(framer.error().empty());
+    EXPECT_EQ(Status::kError, framer.Finish());
+    EXPECT_FALSE(framer.error().empty());
+  }
+  // more data completes the same document
+  framer.Reset();
+  EXPECT_EQ(Status::kNeedMoreData, framer.Feed(json.data(), json.size()));
+  EXPECT_EQ(Status::kDone, framer.Feed("]", 1)) << framer.error();
+}
+
+TEST_F(DocumentFramerTest, SyntaxErrorBeforeEndOfInput) {
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tStr;")) << parser_.error_;
+  fbjson::DocumentFramer framer(&parser_);
+  const std::string json = R"(["mismatch"})";
+  size_t consumed = 0;
+  EXPECT_EQ(Status::kError,
+            framer.Feed(json.data(), json.size(), &consumed));
+  EXPECT_EQ(json.size() - 1, consumed);
+  EXPECT_FALSE(framer.error().empty());
+  // ignore input until reset
+  EXPECT_EQ(Status::kError, framer.Feed("[]", 2, &consumed));
+  EXPECT_EQ(0u, consumed);
+
+  framer.Reset();
+  EXPECT_EQ(Status::kError, framer.Feed("\"text\"", 6));
+}
+
+TEST_F(DocumentFramerTest, MessageStream) {
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tInt;")) << parser_.error_;
+  const std::string stream = R"({"f1": 1} [2] {"f1": /* } */ 3})";
+  fbjson::DocumentFramer framer(&parser_);
+  std::vector<int> values;
+  for (size_t pos = 0; pos < stream.size();) {
+    size_t consumed = 0;
+    const auto size = std::min<size_t>(5, stream.size() - pos);
+    const auto status = framer.Feed(stream.data() + pos, size, &consumed);
+    pos += consumed;
+    if (status == Status::kDone) {
+      auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+          parser_.builder_.GetBufferPointer());
+      values.push_back(root->GetField<int32_t>(4, 0));
+      framer.Reset();
+    }
+    ASSERT_NE(Status::kError, status) << framer.error();
+  }
+  EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), values);
+}
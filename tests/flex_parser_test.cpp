@@ -0,0 +1,202 @@
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "fbjson/flex_parser.h"
+#include "fbjson/meta_parser.h"
+#include "fbjson/options.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Files of a dataset directory whose names start with `prefix`.
+std::vector<std::string> DatasetFiles(const char *dir, const char *prefix) {
+  std::vector<std::string> files;
+  for (const auto &entry :
+       fs::directory_iterator(fs::path(JSON_SAMPLES_DIR) / dir)) {
+    const auto name = entry.path().filename().string();
+    if (name.compare(0, std::strlen(prefix), prefix) == 0) {
+      files.push_back(entry.path().string());
+    }
+  }
+  return files;
+}
+
+std::string Load(const std::string &path) {
+  std::string json;
+  EXPECT_TRUE(flatbuffers::LoadFile(path.c_str(), false, &json)) << path;
+  return json;
+}
+
+std::string ToJson(const std::vector<uint8_t> &buffer) {
+  std::string json;
+  EXPECT_TRUE(fbjson::FlexToJson(flexbuffers::GetRoot(buffer), &json));
+  return json;
+}
+
+// `table Tagged { id : long; name : string; extra : [ubyte] (flexbuffer); }`
+using fbjson::meta::Kind;
+constexpr fbjson::meta::Field kTaggedFields[] = {
+  { 926444256u, "id", 4, Kind::kLong, Kind::kNone, -1, 0, 0, false, false,
+    false },
+  { 2369371622u, "name", 6, Kind::kString, Kind::kNone, -1, 0, 0, false,
+    false, false },
+  { 2828017129u, "extra", 8, Kind::kVector, Kind::kUByte, -1, 0, 0, false,
+    false, true },
+};
+constexpr uint16_t kTaggedByHash[] = { 0, 1, 2 };
+constexpr fbjson::meta::Table kTaggedTables[] = {
+  { "Tagged", kTaggedFields, 3, kTaggedByHash },
+};
+constexpr fbjson::meta::Schema kTaggedSchema = { kTaggedTables, 1, 0 };
+
+const char *const kTaggedFbs =
+    "table Tagged { id : long; name : string; extra : [ubyte] (flexbuffer); }"
+    "root_type Tagged;";
+
+// The `extra` field of a `Tagged` buffer as JSON, empty if it isn't set.
+std::string Extra(const uint8_t *buffer) {
+  const auto table = flatbuffers::GetRoot<flatbuffers::Table>(buffer);
+  const auto extra =
+      table->GetPointer<const flatbuffers::Vector<uint8_t> *>(8);
+  if (!extra) return std::string();
+  std::string json;
+  EXPECT_TRUE(fbjson::FlexToJson(
+      flexbuffers::GetRoot(extra->Data(), extra->size()), &json));
+  return json;
+}
+
+}  // namespace
+
+TEST(FlexParserTest, RoundTripsAcceptedDocuments) {
+  auto files = DatasetFiles("nst.JSONTestSuite", "y_");
+  const auto pass = DatasetFiles("json.org", "pass");
+  files.insert(files.end(), pass.begin(), pass.end());
+  ASSERT_GT(files.size(), 90u);
+  fbjson::FlexParser parser;
+  for (const auto &file : files) {
+    ASSERT_TRUE(parser.Parse(Load(file).c_str())) << file << parser.error_;
+    const auto buffer = parser.builder_.GetBuffer();
+    const auto json = ToJson(buffer);
+    ASSERT_TRUE(parser.Parse(json.c_str())) << file << parser.error_;
+    EXPECT_EQ(buffer, parser.builder_.GetBuffer()) << file << ": " << json;
+    EXPECT_EQ(json, ToJson(parser.builder_.GetBuffer())) << file;
+  }
+}
+
+TEST(FlexParserTest, RejectsInvalidDocuments) {
+  auto files = DatasetFiles("nst.JSONTestSuite", "n_");
+  const auto fail = DatasetFiles("json.org", "fail");
+  files.insert(files.end(), fail.begin(), fail.end());
+  fbjson::FlexParser parser;
+  for (const auto &file : files) {
+    const auto name = fs::path(file).filename().string();
+    // A zero byte ends the input; RFC 8259 allows scalar roots (fail1) and
+    // the depth limit is 64 (fail18).
+    if (name == "n_multidigit_number_then_00.json" || name == "fail1.json" ||
+        name == "fail18.json") {
+      continue;
+    }
+    EXPECT_FALSE(parser.Parse(Load(file).c_str())) << file;
+    EXPECT_FALSE(parser.error_.empty()) << file;
+  }
+}
+
+TEST(FlexParserTest, Values) {
+  fbjson::FlexParser parser;
+  ASSERT_TRUE(parser.Parse(R"({"i": -5, "u": 18446744073709551615,
+      "d": 0.5, "e": 1e2, "s": "xé𝄞", "b": true, "n": null,
+      "v": [1, "a", []], "dup": 1, "dup": {"x": 2}, "k\u0000ey": 3})"))
+      << parser.error_;
+  const auto root = flexbuffers::GetRoot(parser.builder_.GetBuffer()).AsMap();
+  EXPECT_EQ(10u, root.size());
+  EXPECT_EQ(-5, root["i"].AsInt64());
+  EXPECT_TRUE(root["u"].IsUInt());
+  EXPECT_EQ(18446744073709551615u, root["u"].AsUInt64());
+  EXPECT_TRUE(root["d"].IsFloat());
+  EXPECT_EQ(0.5, root["d"].AsDouble());
+  EXPECT_TRUE(root["e"].IsFloat());
+  EXPECT_EQ("x\xc3\xa9\xf0\x9d\x84\x9e", root["s"].AsString().str());
+  EXPECT_TRUE(root["b"].AsBool());
+  EXPECT_TRUE(root["n"].IsNull());
+  EXPECT_EQ(3u, root["v"].AsVector().size());
+  // the first value of a duplicate key is kept
+  EXPECT_EQ(1, root["dup"].AsInt64());
+  EXPECT_EQ(3, root["k"].AsInt64());
+
+  std::string json;
+  ASSERT_TRUE(fbjson::FlexToJson(root["v"], &json));
+  EXPECT_EQ(R"([1,"a",[]])", json);
+  json.clear();
+  ASSERT_TRUE(fbjson::FlexToJson(root["e"], &json));
+  EXPECT_EQ("100.0", json);
+}
+
+TEST(FlexParserTest, ParseValueStopsAfterTheValue) {
+  fbjson::FlexParser parser;
+  const char *const json = R"({"a": [1, 2]}, "rest")";
+  const auto map = parser.builder_.StartMap();
+  const auto end = parser.ParseValue(json, "key");
+  ASSERT_NE(nullptr, end) << parser.error_;
+  EXPECT_STREQ(R"(, "rest")", end);
+  parser.builder_.EndMap(map);
+  parser.builder_.Finish();
+  EXPECT_EQ(R"({"key":{"a":[1,2]}})", ToJson(parser.builder_.GetBuffer()));
+  parser.builder_.Clear();
+  EXPECT_EQ(nullptr, parser.ParseValue("[1,]"));
+  EXPECT_FALSE(parser.error_.empty());
+}
+
+TEST(FlexParserTest, HybridKeepsUnknownFields) {
+  flatbuffers::Parser reference(fbjson::StrictJsonOptions());
+  ASSERT_TRUE(reference.Parse(kTaggedFbs)) << reference.error_;
+  fbjson::MetaParserOptions opts;
+  opts.keep_unknown_fields = true;
+  fbjson::MetaParser parser(kTaggedSchema, opts);
+
+  ASSERT_TRUE(parser.Parse(R"({"id": 7, "color": "red", "name": "x",
+      "tags": [1, 2.5, {"k": null}]})"))
+      << parser.error_;
+  const auto buffer = parser.builder_.GetBufferPointer();
+  const auto table = flatbuffers::GetRoot<flatbuffers::Table>(buffer);
+  EXPECT_EQ(7, table->GetField<int64_t>(4, 0));
+  EXPECT_EQ("x", table->GetPointer<const flatbuffers::String *>(6)->str());
+  const auto extra = Extra(buffer);
+  EXPECT_EQ(R"({"color":"red","tags":[1,2.5,{"k":null}]})", extra);
+
+  // the kept fields read back through the explicit field, like flatc does
+  const auto explicit_json =
+      R"({"id": 7, "name": "x", "extra": )" + extra + "}";
+  ASSERT_TRUE(reference.Parse(explicit_json.c_str())) << reference.error_;
+  EXPECT_EQ(extra, Extra(reference.builder_.GetBufferPointer()));
+  ASSERT_TRUE(parser.Parse(explicit_json.c_str())) << parser.error_;
+  EXPECT_EQ(extra, Extra(parser.builder_.GetBufferPointer()));
+
+  // no unknown fields: the field isn't set
+  ASSERT_TRUE(parser.Parse(R"({"id": 1})")) << parser.error_;
+  EXPECT_EQ("", Extra(parser.builder_.GetBufferPointer()));
+
+  const char *const errors[] = {
+    R"({"id": 1, "a": 1, "extra": {}})",
+    R"({"extra": 1, "a": 1})",
+    R"({"a": 1, "a": 2})",
+    R"({"a": [1,]})",
+    R"({"a": tru})",
+  };
+  for (const auto json : errors) {
+    EXPECT_FALSE(parser.Parse(json)) << json;
+    EXPECT_FALSE(parser.error_.empty()) << json;
+  }
+}
+
+TEST(FlexParserTest, UnknownFieldsSkippedByDefault) {
+  fbjson::MetaParser parser(kTaggedSchema);
+  ASSERT_TRUE(parser.Parse(R"({"id": 7, "color": "red"})")) << parser.error_;
+  EXPECT_EQ("", Extra(parser.builder_.GetBufferPointer()));
+  ASSERT_TRUE(parser.Parse(R"({"id": 7, "extra": [true]})")) << parser.error_;
+  EXPECT_EQ("[true]", Extra(parser.builder_.GetBufferPointer()));
+}
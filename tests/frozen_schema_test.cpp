@@ -0,0 +1,178 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "fbjson/frozen_schema.h"
+#include "fbjson/meta_parser.h"
+#include "fbjson/options.h"
+#include "flatbuffers/idl.h"
+#include "gtest/gtest.h"
+#include "test_meta_generated.h"
+
+#include "json_test_base.h"
+
+static const char *const kDocumentedSchema = R"(
+namespace doc.ns;
+attribute "owner";
+/// A color.
+enum Color : byte { Red, Green }
+/// A point, with a long doc comment which doesn't fit in a short string.
+struct Point { x: float; y: float; }
+/// A table.
+/// Second line of the doc comment of the table.
+table Item (owner: "someone with a long name") {
+  /// The name of the item, with a long doc comment as well.
+  name: string (owner: "someone else");
+  color: Color = Green;
+  at: Point;
+  count: long = 0x7f;
+  ratio: double = 0.25;
+  items: [Item];
+}
+root_type Item;
+)";
+
+class FrozenSchemaTest : public TestFixtureBase {};
+
+TEST_F(FrozenSchemaTest, MeasureTestSchema) {
+  const auto memory = fbjson::MeasureSchema(parser_);
+  EXPECT_GE(memory.structs,
+            parser_.structs_.vec.size() * sizeof(flatbuffers::StructDef));
+  EXPECT_GT(memory.fields, 0u);
+  EXPECT_GT(memory.symbols, 0u);
+  // `test.fbs` has no doc comments and no enums
+  EXPECT_EQ(memory.docs, 0u);
+  EXPECT_EQ(memory.enums, 0u);
+  EXPECT_EQ(memory.total(), memory.structs + memory.fields + memory.symbols +
+                                memory.strings + memory.attributes);
+}
+
+TEST_F(FrozenSchemaTest, MeasureDocsAndAttributes) {
+  flatbuffers::Parser documented(fbjson::StrictJsonOptions());
+  ASSERT_TRUE(documented.Parse(kDocumentedSchema)) << documented.error_;
+  const auto with_docs = fbjson::MeasureSchema(documented);
+  EXPECT_GT(with_docs.docs, 0u);
+  EXPECT_GT(with_docs.attributes, 0u);
+  EXPECT_GT(with_docs.enums, 0u);
+
+  // the same schema without doc comments
+  std::string schema;
+  for (const char *line = kDocumentedSchema; *line;) {
+    const auto end = std::strchr(line, '\n');
+    if (std::strncmp(line, "///", 3) && std::strncmp(line, "  ///", 5)) {
+      schema.append(line, end + 1);
+    }
+    line = end + 1;
+  }
+  flatbuffers::Parser plain(fbjson::StrictJsonOptions());
+  ASSERT_TRUE(plain.Parse(schema.c_str())) << plain.error_;
+  const auto without_docs = fbjson::MeasureSchema(plain);
+  EXPECT_EQ(without_docs.docs, 0u);
+  EXPECT_EQ(with_docs.total() - with_docs.docs, without_docs.total());
+}
+
+TEST_F(FrozenSchemaTest, SameTablesAsGenerated) {
+  const fbjson::FrozenSchema frozen(parser_);
+  const auto &schema = frozen.schema();
+  const auto &expected = fbt::meta::kSchema;
+  EXPECT_EQ(schema.root, expected.root);
+  ASSERT_EQ(schema.num_tables, expected.num_tables);
+  for (size_t t = 0; t < schema.num_tables; t++) {
+    const auto &table = schema.tables[t];
+    const auto &expected_table = expected.tables[t];
+    EXPECT_STREQ(table.name, expected_table.name);
+    EXPECT_EQ(frozen.FindTable(table.name), static_cast<int>(t));
+    ASSERT_EQ(table.num_fields, expected_table.num_fields) << table.name;
+    for (uint16_t i = 0; i < table.num_fields; i++) {
+      const auto &f = table.fields[i];
+      const auto &e = expected_table.fields[i];
+      EXPECT_EQ(f.name_hash, e.name_hash);
+      EXPECT_STREQ(f.name, e.name);
+      EXPECT_EQ(f.offset, e.offset);
+      EXPECT_EQ(f.kind, e.kind);
+      EXPECT_EQ(f.element, e.element);
+      EXPECT_EQ(f.table, e.table);
+      EXPECT_EQ(f.default_integer, e.default_integer);
+      EXPECT_EQ(f.default_real, e.default_real);
+      EXPECT_EQ(f.required, e.required);
+      EXPECT_EQ(f.deprecated, e.deprecated);
+      EXPECT_EQ(f.flexbuffer, e.flexbuffer);
+      EXPECT_EQ(table.by_hash[i], expected_table.by_hash[i]);
+      EXPECT_EQ(table.Lookup(f.name, std::strlen(f.name)), &f);
+      EXPECT_EQ(frozen.FindField(static_cast<int>(t), f.name), i);
+    }
+    EXPECT_EQ(frozen.FindField(static_cast<int>(t), "unknown"), -1);
+  }
+  EXPECT_EQ(frozen.FindTable("fbt.unknown"), -1);
+  EXPECT_LT(frozen.MemoryUsage(), fbjson::MeasureSchema(parser_).total());
+}
+
+TEST_F(FrozenSchemaTest, UlongDefaultKeepsBits) {
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  ASSERT_TRUE(parser.Parse("table U { big: ulong = 0x8000000000000001; "
+                           "dec: ulong = 18446744073709551615; }"))
+      << parser.error_;
+  const fbjson::FrozenSchema frozen(parser);
+  const auto &table = frozen.schema().tables[0];
+  EXPECT_EQ(table.Lookup("big", 3)->default_integer,
+            static_cast<int64_t>(0x8000000000000001ull));
+  EXPECT_EQ(table.Lookup("dec", 3)->default_integer, -1);
+}
+
+TEST_F(FrozenSchemaTest, TooManyTables) {
+  // one table more than `meta::Field::table` can reference
+  std::string schema;
+  for (int i = 0; i <= INT16_MAX; i++) {
+    schema += "table T" + std::to_string(i) + " { next: T" +
+              std::to_string(i ? i - 1 : 0) + "; }\n";
+  }
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  ASSERT_TRUE(parser.Parse(schema.c_str())) << parser.error_;
+  const fbjson::FrozenSchema frozen(parser);
+  EXPECT_FALSE(frozen.ok());
+  EXPECT_NE(frozen.error().find("too many tables"), std::string::npos)
+      << frozen.error();
+  EXPECT_EQ(frozen.schema().num_tables, 0u);
+  EXPECT_EQ(frozen.schema().root, -1);
+  EXPECT_EQ(frozen.FindTable("T0"), -1);
+
+  // one table less fits
+  flatbuffers::Parser smaller(fbjson::StrictJsonOptions());
+  ASSERT_TRUE(smaller.Parse(schema.substr(0, schema.rfind("table")).c_str()))
+      << smaller.error_;
+  const fbjson::FrozenSchema fits(smaller);
+  EXPECT_TRUE(fits.ok()) << fits.error();
+  EXPECT_EQ(fits.schema().num_tables, static_cast<size_t>(INT16_MAX));
+}
+
+TEST_F(FrozenSchemaTest, ParsesAfterParserIsGone) {
+  std::unique_ptr<flatbuffers::Parser> parser(
+      new flatbuffers::Parser(fbjson::StrictJsonOptions()));
+  ASSERT_TRUE(parser->Parse(kDocumentedSchema)) << parser->error_;
+  const fbjson::FrozenSchema frozen(*parser);
+  // the struct is dropped, so is its field in the table
+  ASSERT_EQ(frozen.schema().num_tables, 1u);
+  EXPECT_EQ(frozen.schema().root, 0);
+  const auto at = frozen.schema().tables[0].Lookup("at", 2);
+  ASSERT_NE(at, nullptr);
+  EXPECT_EQ(at->kind, fbjson::meta::Kind::kUnsupported);
+  EXPECT_EQ(frozen.schema().tables[0].Lookup("count", 5)->default_integer,
+            0x7f);
+
+  const auto json =
+      R"({"name": "a", "count": 3, "ratio": 0.5, "items": [{"name": "b"}]})";
+  ASSERT_TRUE(parser->Parse(json)) << parser->error_;
+  const std::string expected(
+      reinterpret_cast<const char *>(parser->builder_.GetBufferPointer()),
+      parser->builder_.GetSize());
+  parser.reset();
+  EXPECT_EQ(frozen.FindTable("doc.ns.Item"), 0);
+  EXPECT_EQ(frozen.FindTable("doc.ns.Point"), -1);
+  EXPECT_EQ(frozen.FindField(0, "count"), 3);
+  fbjson::MetaParser meta_parser(frozen.schema());
+  ASSERT_TRUE(meta_parser.Parse(json)) << meta_parser.error_;
+  EXPECT_EQ(expected,
+            std::string(reinterpret_cast<const char *>(
+                            meta_parser.builder_.GetBufferPointer()),
+                        meta_parser.builder_.GetSize()));
+}
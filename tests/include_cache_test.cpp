@@ -0,0 +1,214 @@
+#include <filesystem>
+#include <string>
+#include "fbjson/include_cache.h"
+#include "fbjson/options.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+
+namespace fs = std::filesystem;
+
+// `root.fbs` includes `mid.fbs`, which includes `base.fbs`, and `base.fbs`
+// again directly.
+static const char *const kBaseSchema = R"(
+namespace inc.base;
+attribute "priority";
+enum Color : byte { Red, Green }
+struct Vec { x: float; y: float; }
+table Base { name: string; color: Color; }
+)";
+
+static const char *const kMidSchema = R"(
+include "base.fbs";
+namespace inc.mid;
+table Mid {
+  base: inc.base.Base;
+  pos: inc.base.Vec;
+  tags: [string] (priority: "1");
+}
+)";
+
+static const char *const kRootSchema = R"(// root
+include "mid.fbs";
+/* shared */ include "base.fbs";
+namespace inc;
+table Root { mid: inc.mid.Mid; color: inc.base.Color = Green; }
+root_type Root;
+)";
+
+static const char *const kJson = R"({
+  "mid": { "base": { "name": "a", "color": "Green" }, "pos": { "x": 1, "y": 2 },
+           "tags": [ "t" ] },
+  "color": "Red"
+})";
+
+// Builtin attributes change the buffer, `Parser::Serialize` drops them
+// unless `binary_schema_builtins` is set.
+static const char *const kBuiltinsSchema = R"(
+namespace inc.builtins;
+table Inner { x: int; }
+table Flags (original_order) {
+  b: byte;
+  l: long;
+  id: uint (hash: "fnv1a_32");
+  inner: [ubyte] (nested_flatbuffer: "Inner");
+  flex: [ubyte] (flexbuffer);
+  ratio: double = 0.1234567890123456;
+}
+)";
+
+class IncludeCacheTest : public ::testing::Test {
+ protected:
+  std::string dir_;
+  std::string root_;
+
+  void SetUp() override {
+    dir_ = (fs::temp_directory_path() / "fbjson_include_cache_test").string();
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+    Write("base.fbs", kBaseSchema);
+    Write("mid.fbs", kMidSchema);
+    root_ = Write("root.fbs", kRootSchema);
+  }
+
+  void TearDown() override { fs::remove_all(dir_); }
+
+  std::string Write(const std::string &name, const std::string &schema) {
+    const auto path = flatbuffers::ConCatPathFileName(dir_, name);
+    EXPECT_TRUE(flatbuffers::SaveFile(path.c_str(), schema, false));
+    return path;
+  }
+
+  // Parse `schema` as `root.fbs`, then `json`, and return the buffer.
+  std::string Convert(fbjson::IncludeCache *cache, const char *schema,
+                      const char *json,
+                      const flatbuffers::IDLOptions &opts =
+                          fbjson::StrictJsonOptions()) {
+    const char *include_paths[] = { dir_.c_str(), nullptr };
+    flatbuffers::Parser parser(opts);
+    const auto ok =
+        cache ? cache->Parse(&parser, schema, include_paths, root_.c_str())
+              : parser.Parse(schema, include_paths, root_.c_str());
+    EXPECT_TRUE(ok) << parser.error_;
+    if (!ok) return std::string();
+    EXPECT_TRUE(parser.Parse(json)) << parser.error_;
+    return std::string(
+        reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+        parser.builder_.GetSize());
+  }
+};
+
+TEST_F(IncludeCacheTest, SameBufferAsParser) {
+  fbjson::IncludeCache cache;
+  const auto expected = Convert(nullptr, kRootSchema, kJson);
+  ASSERT_FALSE(expected.empty());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(expected, Convert(&cache, kRootSchema, kJson));
+  }
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.stats().misses, 1u);
+  EXPECT_EQ(cache.stats().hits, 2u);
+  EXPECT_EQ(cache.stats().invalidations, 0u);
+
+  // another schema with the same includes shares the entry
+  const auto other = "table Other { mid: inc.mid.Mid; } root_type Other;";
+  const auto other_json = R"({ "mid": { "tags": [] } })";
+  const auto same_includes =
+      std::string("include \"mid.fbs\"; include \"base.fbs\";\n") + other;
+  EXPECT_EQ(Convert(nullptr, same_includes.c_str(), other_json),
+            Convert(&cache, same_includes.c_str(), other_json));
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.stats().hits, 3u);
+  // but not one which includes them in another order
+  const auto reordered =
+      std::string("include \"base.fbs\"; include \"mid.fbs\";\n") + other;
+  EXPECT_EQ(Convert(nullptr, reordered.c_str(), other_json),
+            Convert(&cache, reordered.c_str(), other_json));
+  EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST_F(IncludeCacheTest, BuiltinAttributes) {
+  Write("builtins.fbs", kBuiltinsSchema);
+  const auto schema =
+      "include \"builtins.fbs\";\nroot_type inc.builtins.Flags;";
+  const auto json = R"({ "b": 1, "l": 2, "id": "name", "inner": { "x": 3 },
+                         "flex": { "a": [ 1, "b" ] },
+                         "ratio": 0.1234567890123456 })";
+  fbjson::IncludeCache cache;
+  const auto expected = Convert(nullptr, schema, json);
+  ASSERT_FALSE(expected.empty());
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(expected, Convert(&cache, schema, json));
+  }
+  EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST_F(IncludeCacheTest, KeyedByOptions) {
+  fbjson::IncludeCache cache;
+  auto opts = fbjson::StrictJsonOptions();
+  ASSERT_FALSE(Convert(&cache, kRootSchema, kJson, opts).empty());
+  opts.allow_non_utf8 = !opts.allow_non_utf8;
+  EXPECT_EQ(Convert(nullptr, kRootSchema, kJson, opts),
+            Convert(&cache, kRootSchema, kJson, opts));
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(cache.stats().hits, 0u);
+}
+
+TEST_F(IncludeCacheTest, ChangedIncludeIsParsedAgain) {
+  for (const auto validation :
+       { fbjson::IncludeCache::Validation::kModificationTime,
+         fbjson::IncludeCache::Validation::kContentHash }) {
+    Write("base.fbs", kBaseSchema);
+    fbjson::IncludeCache cache(validation);
+    const auto json = R"({ "mid": { "base": { "nick": "b" } } })";
+    ASSERT_FALSE(Convert(&cache, kRootSchema, kJson).empty());
+    // same size, only the content hash is sure to see the change
+    std::string renamed = kBaseSchema;
+    renamed.replace(renamed.find("name"), 4, "nick");
+    Write("base.fbs", renamed);
+    if (validation == fbjson::IncludeCache::Validation::kContentHash) {
+      EXPECT_EQ(Convert(nullptr, kRootSchema, json),
+                Convert(&cache, kRootSchema, json));
+      EXPECT_EQ(cache.stats().invalidations, 1u);
+    }
+    // a new field
+    renamed.replace(renamed.find("color: Color;"), 13,
+                    "color: Color; id: int;");
+    Write("base.fbs", renamed);
+    const auto id_json = R"({ "mid": { "base": { "id": 7 } } })";
+    EXPECT_EQ(Convert(nullptr, kRootSchema, id_json),
+              Convert(&cache, kRootSchema, id_json));
+    EXPECT_GE(cache.stats().invalidations, 1u);
+    EXPECT_EQ(cache.size(), 1u);
+  }
+}
+
+TEST_F(IncludeCacheTest, ErrorsAsWithoutCache) {
+  const char *include_paths[] = { dir_.c_str(), nullptr };
+  for (const auto schema :
+       { "include \"missing.fbs\";\ntable T {}",
+         "include \"mid.fbs\";\ntable T { x: inc.mid.Unknown; }",
+         "include \"mid.fbs\";\nnamespace inc.mid;\ntable Mid {}" }) {
+    fbjson::IncludeCache cache;
+    flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+    flatbuffers::Parser cached(fbjson::StrictJsonOptions());
+    EXPECT_FALSE(parser.Parse(schema, include_paths, root_.c_str()));
+    EXPECT_FALSE(cache.Parse(&cached, schema, include_paths, root_.c_str()));
+    EXPECT_EQ(parser.error_, cached.error_);
+  }
+  // broken includes aren't cached
+  Write("bad.fbs", "table Bad { x: int }");
+  fbjson::IncludeCache cache;
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  EXPECT_FALSE(cache.Parse(&parser, "include \"bad.fbs\";", include_paths));
+  EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(IncludeCacheTest, SchemaWithoutIncludes) {
+  fbjson::IncludeCache cache;
+  flatbuffers::Parser parser(fbjson::StrictJsonOptions());
+  ASSERT_TRUE(cache.Parse(&parser, kBaseSchema)) << parser.error_;
+  EXPECT_NE(parser.structs_.Lookup("inc.base.Base"), nullptr);
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.stats().misses, 0u);
+}
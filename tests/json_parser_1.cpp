@@ -9,103 +9,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include "json_test_base.h"
 #include "test_generated.h"
 
-// Use global define `FLATBUFFERS_FBS_DIR` for reference to fbs files insted of
-// copy to binary dir.
-
-// Parametric test.
-// 0: test result
-// 1: parser add-in (root_type fbt.name;)
-// 2: json file name (starts '/') or embedded json
-// 3: optional parser error message which tested by substring checking
-// Examples:
-// {1, "root_type fbt.Empty;", "/test.json", nullptr}
-// {0, "root_type fbt.Empty;", "{", "", nullptr}
-
-enum class TResult {
-  FAIL = 0,
-  DONE = 1,
-  // implementation defined
-  ANY = 2
-};
-// helpers
-constexpr static inline bool operator==(const TResult a, const bool b) {
-  return (a == TResult::ANY) ? true : a == (b ? TResult::DONE : TResult::FAIL);
-}
-constexpr static inline bool operator==(const bool a, const TResult b) {
-  return b == a;
-}
-static inline ::std::ostream &operator<<(::std::ostream &os, const TResult &e) {
-  switch (e) {
-    case TResult::FAIL: return os << "FAIL";
-    case TResult::DONE: return os << "DONE";
-    case TResult::ANY: return os << "ANY";
-    default: return os << e;
-  }
-}
-
-struct ParserTraits {
-  flatbuffers::IDLOptions opts;
-  ParserTraits() {
-    // request strict json by default
-    opts.skip_unexpected_fields_in_json = true;
-    opts.strict_json = true;
-  }
-  ParserTraits(ParserTraits &&) = default;
-  ParserTraits(const ParserTraits &) = default;
-};
-
-static inline auto ParserTraitsNonStrict() {
-  ParserTraits traits;
-  traits.opts.strict_json = false;
-  return traits;
-}
-
-static inline ::std::ostream &operator<<(::std::ostream &os,
-                                         const ParserTraits &traits) {
-  return os << "IDLOptions {"
-            << "not implemented"
-            << "}";
-}
-using TestParam = std::tuple<TResult, const char *, const char *, const char *>;
-using TestConfig = std::tuple<TestParam, ParserTraits>;
-
-// base fixture cass
-class TestFixtureBase : public ::testing::Test {
- protected:
-  flatbuffers::Parser parser_;
-
-  const char **const fbs_include_dir() const {
-    static const char *fbs_include_directories_[] = { FLATBUFFERS_FBS_DIR,
-                                                      nullptr };
-    return fbs_include_directories_;
-  }
-
-  TestFixtureBase() {
-    ParserTraits traits;
-    parser_.opts = traits.opts;
-  }
-
-  void SetUp() override {
-    std::string schemafile;
-    auto full_fname =
-        flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.fbs");
-
-    ASSERT_TRUE(flatbuffers::LoadFile(full_fname.c_str(), false, &schemafile));
-    ASSERT_TRUE(parser_.Parse(schemafile.c_str(), fbs_include_dir()))
-        << parser_.error_;
-  }
-
-  // Print current content of parser's builder to a string.
-  // Then parse this string and print again.
-  // After that compare both string.
-  void ParserPrintDecodePrintTest();
-
- public:
-  virtual ~TestFixtureBase() = default;
-};
-
 class TestJsonParser : public TestFixtureBase {
  public:
   virtual ~TestJsonParser() = default;
@@ -120,6 +26,7 @@ class ParamTestJsonParser : public TestFixtureBase,
   std::string json_file_;
 
   void SetUp() override {
+    binary_schema_ = std::get<1>(GetParam()).binary_schema;
     TestFixtureBase::SetUp();
 
     parser_.opts = std::get<1>(GetParam()).opts;
@@ -213,10 +120,6 @@ TEST_P(ParamTestJsonParser, SimpleJsonCheck) {
 // pre-generate testset
 // Test dataset from file [https://www.json.org/JSON_checker/test.zip]
 // Use C++11 raw strings for embedded json: R"(some unescaped string)"
-static std::vector<TestParam> json_org_dataset(bool strict);
-
-std::vector<TestParam> seriot_dataset(bool strict);
-
 static const auto json_org_dataset_strict = json_org_dataset(true);
 static const auto json_org_dataset_nonstrict = json_org_dataset(false);
 
@@ -238,6 +141,17 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(::testing::ValuesIn(seriot_dataset_strict),
                        ::testing::Values(ParserTraits())));
 
+// Type definitions loaded from the binary schema.
+INSTANTIATE_TEST_CASE_P(
+    json_org_binary_schema, ParamTestJsonParser,
+    ::testing::Combine(::testing::ValuesIn(json_org_dataset_strict),
+                       ::testing::Values(ParserTraitsBinarySchema())));
+
+INSTANTIATE_TEST_CASE_P(
+    seriot_binary_schema, ParamTestJsonParser,
+    ::testing::Combine(::testing::ValuesIn(seriot_dataset_strict),
+                       ::testing::Values(ParserTraitsBinarySchema())));
+
 // INSTANTIATE_TEST_CASE_P(
 //  seriot_non_strict, ParamTestJsonParser,
 //  ::testing::Combine(::testing::ValuesIn(seriot_dataset_nonstrict),
@@ -0,0 +1,135 @@
+#ifndef FLATBUFFERS_TESTS_JSON_TEST_BASE_H_
+#define FLATBUFFERS_TESTS_JSON_TEST_BASE_H_
+
+#include <cstring>
+#include <ostream>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "fbjson/binary_schema.h"
+#include "fbjson/options.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+
+// Use global define `FLATBUFFERS_FBS_DIR` for reference to fbs files insted of
+// copy to binary dir.
+
+// Parametric test.
+// 0: test result
+// 1: parser add-in (root_type fbt.name;)
+// 2: json file name (starts '/') or embedded json
+// 3: optional parser error message which tested by substring checking
+// Examples:
+// {1, "root_type fbt.Empty;", "/test.json", nullptr}
+// {0, "root_type fbt.Empty;", "{", "", nullptr}
+
+enum class TResult {
+  FAIL = 0,
+  DONE = 1,
+  // implementation defined
+  ANY = 2
+};
+// helpers
+constexpr static inline bool operator==(const TResult a, const bool b) {
+  return (a == TResult::ANY) ? true : a == (b ? TResult::DONE : TResult::FAIL);
+}
+constexpr static inline bool operator==(const bool a, const TResult b) {
+  return b == a;
+}
+static inline ::std::ostream &operator<<(::std::ostream &os, const TResult &e) {
+  switch (e) {
+    case TResult::FAIL: return os << "FAIL";
+    case TResult::DONE: return os << "DONE";
+    case TResult::ANY: return os << "ANY";
+    default: return os << e;
+  }
+}
+
+struct ParserTraits {
+  flatbuffers::IDLOptions opts;
+  // load type definitions from `test.bfbs` instead of `test.fbs`
+  bool binary_schema = false;
+  // request strict json by default
+  ParserTraits() : opts(fbjson::StrictJsonOptions()) {}
+  ParserTraits(ParserTraits &&) = default;
+  ParserTraits(const ParserTraits &) = default;
+};
+
+static inline auto ParserTraitsNonStrict() {
+  ParserTraits traits;
+  traits.opts.strict_json = false;
+  return traits;
+}
+
+static inline auto ParserTraitsBinarySchema() {
+  ParserTraits traits;
+  traits.binary_schema = true;
+  return traits;
+}
+
+static inline ::std::ostream &operator<<(::std::ostream &os,
+                                         const ParserTraits &traits) {
+  return os << "IDLOptions {"
+            << "not implemented"
+            << "}";
+}
+using TestParam = std::tuple<TResult, const char *, const char *, const char *>;
+using TestConfig = std::tuple<TestParam, ParserTraits>;
+
+// base fixture cass
+class TestFixtureBase : public ::testing::Test {
+ protected:
+  flatbuffers::Parser parser_;
+  bool binary_schema_ = false;
+
+  const char **const fbs_include_dir() const {
+    static const char *fbs_include_directories_[] = { FLATBUFFERS_FBS_DIR,
+                                                      nullptr };
+    return fbs_include_directories_;
+  }
+
+  TestFixtureBase() {
+    ParserTraits traits;
+    parser_.opts = traits.opts;
+  }
+
+  void SetUp() override {
+    if (binary_schema_) return LoadBinarySchema();
+    std::string schemafile;
+    auto full_fname =
+        flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.fbs");
+
+    ASSERT_TRUE(flatbuffers::LoadFile(full_fname.c_str(), false, &schemafile));
+    ASSERT_TRUE(parser_.Parse(schemafile.c_str(), fbs_include_dir()))
+        << parser_.error_;
+  }
+
+  void LoadBinarySchema() {
+    std::string bfbs;
+    auto full_fname =
+        flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.bfbs");
+
+    ASSERT_TRUE(flatbuffers::LoadFile(full_fname.c_str(), true, &bfbs));
+    std::string error;
+    ASSERT_TRUE(fbjson::LoadBinarySchema(
+        reinterpret_cast<const uint8_t *>(bfbs.data()), bfbs.size(), &parser_,
+        &error))
+        << error;
+  }
+
+  // Print current content of parser's builder to a string.
+  // Then parse this string and print again.
+  // After that compare both string.
+  void ParserPrintDecodePrintTest();
+
+ public:
+  virtual ~TestFixtureBase() = default;
+};
+
+// Test datasets (see json_parser_1.cpp).
+std::vector<TestParam> json_org_dataset(bool strict);
+std::vector<TestParam> seriot_dataset(bool strict);
+
+#endif  // FLATBUFFERS_TESTS_JSON_TEST_BASE_H_
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "fbjson/meta_parser.h"
+#include "fbjson/options.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+#include "test_meta_generated.h"
+
+#include "json_test_base.h"
+
+using fbt::meta::TableIndex;
+
+class MetaParserTest : public ::testing::Test {
+ protected:
+  flatbuffers::Parser parser_{ fbjson::StrictJsonOptions() };
+  fbjson::MetaParser meta_parser_{ fbt::meta::kSchema };
+
+  void SetUp() override {
+    std::string schema;
+    ASSERT_TRUE(flatbuffers::LoadFile(FLATBUFFERS_FBS_DIR "test.fbs", false,
+                                      &schema));
+    ASSERT_TRUE(parser_.Parse(schema.c_str())) << parser_.error_;
+  }
+
+  std::string Reference(const char *root, const char *json) {
+    EXPECT_TRUE(parser_.SetRootType(root));
+    if (!parser_.Parse(json)) return "error";
+    return std::string(
+        reinterpret_cast<const char *>(parser_.builder_.GetBufferPointer()),
+        parser_.builder_.GetSize());
+  }
+
+  std::string Meta(TableIndex root, const char *json) {
+    if (!meta_parser_.Parse(json, static_cast<int>(root))) return "error";
+    return std::string(reinterpret_cast<const char *>(
+                           meta_parser_.builder_.GetBufferPointer()),
+                       meta_parser_.builder_.GetSize());
+  }
+};
+
+TEST_F(MetaParserTest, Tables) {
+  EXPECT_EQ(fbt::meta::kSchema.num_tables, parser_.structs_.vec.size());
+  for (size_t i = 0; i < fbt::meta::kSchema.num_tables; i++) {
+    const auto &table = fbt::meta::kSchema.tables[i];
+    ASSERT_NE(parser_.LookupStruct(table.name), nullptr) << table.name;
+    for (uint16_t j = 0; j < table.num_fields; j++) {
+      const auto &field = table.fields[j];
+      EXPECT_EQ(table.Lookup(field.name, std::strlen(field.name)), &field);
+    }
+    EXPECT_EQ(table.Lookup("unknown", 7), nullptr);
+  }
+}
+
+TEST_F(MetaParserTest, SameBytesAsParser) {
+  const struct {
+    const char *name;
+    TableIndex index;
+    const char *json;
+  } cases[] = {
+    { "fbt.tEmpty", TableIndex::tEmpty, "{}" },
+    { "fbt.ttEmpty", TableIndex::ttEmpty, R"({"f1": {}})" },
+    { "fbt.tStr", TableIndex::tStr, R"({"f1": "a\"b\\cé𝄞"})" },
+    { "fbt.tStrIntInt", TableIndex::tStrIntInt,
+      R"({"f1": "test", "f2": 1, "f3": -2147483648})" },
+    { "fbt.tStr", TableIndex::tStr, R"({"f1": "\u00e9\ud834\udd1e\n"})" },
+    { "fbt.tStrIntInt", TableIndex::tStrIntInt, R"(["test", 1, 2])" },
+    { "fbt.tIntInt", TableIndex::tIntInt, "[0999, 001987]" },
+    { "fbt.tIntVInt", TableIndex::tIntVInt,
+      R"({"f2": [1, 2, 3, -4, 2147483647], "f1": 7})" },
+    { "fbt.tIntVInt", TableIndex::tIntVInt, R"({"f1": 0, "f2": []})" },
+    { "fbt.tBool", TableIndex::tBool, R"({"f1": true})" },
+    { "fbt.tBool", TableIndex::tBool, R"({"f1": false})" },
+    { "fbt.tFloat", TableIndex::tFloat, R"({"f1": -1.5e-3})" },
+    { "fbt.tGrammarTest", TableIndex::tGrammarTest,
+      R"({"f1": 18, "f3": 1, "f8": -1.0})" },
+    { "fbt.tStrBool", TableIndex::tStrBool,
+      R"({"unknown": [{"a": [1, "]"]}], "f2": true, "f1": null})" },
+    { "fbt.tIntInt", TableIndex::tIntInt, " \r\n\t{ \"f1\" : 1 } \n" },
+  };
+  for (const auto &c : cases) {
+    EXPECT_EQ(Meta(c.index, c.json), Reference(c.name, c.json)) << c.json;
+  }
+}
+
+TEST_F(MetaParserTest, DefaultRootAndFileIdentifier) {
+  // test.fbs has no root type
+  EXPECT_FALSE(meta_parser_.Parse("{}"));
+  EXPECT_TRUE(meta_parser_.Parse(R"({"f1": 1})",
+                                 static_cast<int>(TableIndex::tInt), "TEST"));
+  EXPECT_TRUE(flatbuffers::BufferHasIdentifier(
+      meta_parser_.builder_.GetBufferPointer(), "TEST"));
+}
+
+TEST_F(MetaParserTest, Errors) {
+  const struct {
+    TableIndex index;
+    const char *json;
+  } cases[] = {
+    { TableIndex::tInt, "" },
+    { TableIndex::tInt, R"({"f1": 1)" },
+    { TableIndex::tInt, R"({"f1": 1,})" },
+    { TableIndex::tInt, R"({"f1": 1} x)" },
+    { TableIndex::tInt, R"({"f1": 1, "f1": 2})" },
+    { TableIndex::tInt, R"({"f1": 2147483648})" },
+    { TableIndex::tInt, R"({"f1": 1.5})" },
+    { TableIndex::tInt, R"({"f1": "1"})" },
+    { TableIndex::tInt, R"({f1: 1})" },
+    { TableIndex::tInt, R"([1, 2])" },
+    { TableIndex::tStr, "{\"f1\": \"tab\there\"}" },
+    { TableIndex::tStr, R"({"f1": "\x"})" },
+    { TableIndex::tStr, R"({"f1": "\ud834"})" },
+    { TableIndex::tStr, R"({"f1": "\u 12a"})" },
+    { TableIndex::tStr, R"({"f1": "\u+abc"})" },
+    { TableIndex::tStr, R"({"f1": "\u0x1"})" },
+    { TableIndex::tStr, R"({"f1": "a", "unknown": alert()})" },
+    { TableIndex::tIntVInt, R"({"f2": [1, 2,]})" },
+    { TableIndex::tFloat, R"({"f1": true})" },
+  };
+  for (const auto &c : cases) {
+    EXPECT_FALSE(meta_parser_.Parse(c.json, static_cast<int>(c.index)))
+        << c.json;
+    EXPECT_FALSE(meta_parser_.error_.empty());
+  }
+  std::string deep;
+  for (int i = 0; i < 100; i++) deep += R"({"f1": )";
+  deep += "{}";
+  for (int i = 0; i < 100; i++) deep += "}";
+  EXPECT_FALSE(
+      meta_parser_.Parse(deep.c_str(), static_cast<int>(TableIndex::ttEmpty)));
+}
+
+TEST_F(MetaParserTest, SharedStrings) {
+  const auto json = R"({"f1": "repeated", "f2": "repeated", "f3": "other"})";
+  const auto plain = Meta(TableIndex::tStrStrStr, json);
+  fbjson::MetaParserOptions opts;
+  opts.share_strings = true;
+  meta_parser_.opts = opts;
+  const auto shared = Meta(TableIndex::tStrStrStr, json);
+  EXPECT_LT(shared.size(), plain.size());
+  EXPECT_GT(meta_parser_.SharedStringsMemory(), 0u);
+  // same content when read back
+  ASSERT_TRUE(parser_.SetRootType("fbt.tStrStrStr"));
+  std::string plain_text, shared_text;
+  ASSERT_TRUE(flatbuffers::GenerateText(parser_, plain.data(), &plain_text));
+  ASSERT_TRUE(flatbuffers::GenerateText(parser_, shared.data(), &shared_text));
+  EXPECT_EQ(plain_text, shared_text);
+  // the table is reset between documents
+  EXPECT_EQ(Meta(TableIndex::tStrStrStr, json), shared);
+}
+
+TEST_F(MetaParserTest, ProjectionDropsOtherFields) {
+  const struct {
+    TableIndex index;
+    std::vector<std::string> fields;
+    const char *json;
+    const char *projected;
+  } cases[] = {
+    { TableIndex::tStrIntInt,
+      { "fbt.tStrIntInt.f1", "fbt.tStrIntInt.f3" },
+      R"({"f1": "a", "f2": 1, "f3": 2})",
+      R"({"f1": "a", "f3": 2})" },
+    { TableIndex::tStrIntInt,
+      { "fbt.tStrIntInt.f2" },
+      R"(["skip \"quoted\" \u00e9", 1, 2])",
+      R"({"f2": 1})" },
+    { TableIndex::tIntVInt,
+      { "fbt.tIntVInt.f1" },
+      R"({"f2": [1, 2, 3], "f1": 7})",
+      R"({"f1": 7})" },
+    // tables without listed fields are built in full
+    { TableIndex::ttEmpty,
+      { "fbt.tStr.f1" },
+      R"({"f1": {}})",
+      R"({"f1": {}})" },
+  };
+  for (const auto &c : cases) {
+    ASSERT_TRUE(meta_parser_.SetProjection({}));
+    const auto expected = Meta(c.index, c.projected);
+    ASSERT_TRUE(meta_parser_.SetProjection(c.fields)) << meta_parser_.error_;
+    EXPECT_EQ(Meta(c.index, c.json), expected) << c.json;
+  }
+  // skipped fields aren't decoded
+  ASSERT_TRUE(meta_parser_.SetProjection({ "fbt.tStrInt.f2" }));
+  EXPECT_EQ(Meta(TableIndex::tStrInt, R"({"f1": "\x", "f2": 1})"),
+            Meta(TableIndex::tStrInt, R"({"f2": 1})"));
+  EXPECT_EQ(Meta(TableIndex::tStrInt, R"({"f1": "unterminated, "f2": 1})"),
+            "error");
+}
+
+TEST_F(MetaParserTest, ProjectionUnknownField) {
+  EXPECT_FALSE(meta_parser_.SetProjection({ "fbt.tStrIntInt.f4" }));
+  EXPECT_FALSE(meta_parser_.SetProjection({ "fbt.tUnknown.f1" }));
+  EXPECT_FALSE(meta_parser_.SetProjection({ "f1" }));
+  EXPECT_FALSE(meta_parser_.error_.empty());
+}
+
+// Phase breakdown of every dataset case when the library is built with
+// FBJSON_PARSE_STATS: printed as one table after the last case, and
+// recorded as the test property "stats" (see --gtest_output=xml).
+class ParamMetaParserStatsTest
+    : public MetaParserTest,
+      public ::testing::WithParamInterface<TestParam> {
+ protected:
+  struct Row {
+    std::string name;
+    bool done;
+    fbjson::ParseStats stats;
+  };
+  static std::vector<Row> rows_;
+
+  static void PrintRow(const char *name, const char *result,
+                       const fbjson::ParseStats &stats) {
+    const auto cycles = stats.TotalCycles();
+    std::printf("%-40.40s %-4s %12llu", name, result,
+                static_cast<unsigned long long>(cycles));
+    for (int phase = 0; phase < fbjson::ParseStats::kNumPhases; phase++) {
+      std::printf(" %11.1f%%",
+                  cycles ? 100.0 * stats.cycles[phase] / cycles : 0.0);
+    }
+    std::printf("\n");
+  }
+
+ public:
+  // registered by gtest outside of the fixture
+  static void TearDownTestCase() {
+    if (rows_.empty()) return;
+    std::printf("%-40s %-4s %12s", "case", "", "cycles");
+    for (int phase = 0; phase < fbjson::ParseStats::kNumPhases; phase++) {
+      std::printf(" %12s", fbjson::ParseStats::PhaseName(phase));
+    }
+    std::printf("\n");
+    fbjson::ParseStats total;
+    for (const auto &row : rows_) {
+      PrintRow(row.name.c_str(), row.done ? "DONE" : "FAIL", row.stats);
+      for (int phase = 0; phase < fbjson::ParseStats::kNumPhases; phase++) {
+        total.cycles[phase] += row.stats.cycles[phase];
+        total.events[phase] += row.stats.events[phase];
+      }
+    }
+    PrintRow("total", "", total);
+    rows_.clear();
+  }
+};
+
+std::vector<ParamMetaParserStatsTest::Row> ParamMetaParserStatsTest::rows_;
+
+TEST_P(ParamMetaParserStatsTest, PhaseBreakdown) {
+  // Only "root_type fbt.X;" cases: others declare their own schema, which
+  // the generated tables don't have.
+  const std::string decl = std::get<1>(GetParam());
+  const std::string prefix = "root_type ";
+  if (!std::get<2>(GetParam()) || decl.compare(0, prefix.size(), prefix) ||
+      decl.find(';') != decl.size() - 1) {
+    return;
+  }
+  const auto root_name =
+      decl.substr(prefix.size(), decl.size() - prefix.size() - 1);
+  int root = -1;
+  for (size_t i = 0; i < fbt::meta::kSchema.num_tables; i++) {
+    if (root_name == fbt::meta::kSchema.tables[i].name) {
+      root = static_cast<int>(i);
+    }
+  }
+  ASSERT_GE(root, 0) << root_name;
+  std::string json = std::get<2>(GetParam());
+  if (json[0] == '/') {
+    const auto full_fname =
+        flatbuffers::ConCatPathFileName(JSON_SAMPLES_DIR, json);
+    ASSERT_TRUE(flatbuffers::LoadFile(full_fname.c_str(), false, &json));
+  }
+  meta_parser_.stats_.Reset();
+  const auto done = meta_parser_.Parse(json.c_str(), root);
+#ifdef FBJSON_PARSE_STATS
+  if (done) {
+    EXPECT_GT(meta_parser_.stats_.events[fbjson::ParseStats::kVtable], 0u);
+  }
+  RecordProperty("stats", std::string(done ? "DONE " : "FAIL ") +
+                             meta_parser_.stats_.ToString());
+  auto name = std::string(std::get<2>(GetParam()));
+  std::replace(name.begin(), name.end(), '\n', ' ');
+  rows_.push_back({ name, done, meta_parser_.stats_ });
+#else
+  (void)done;
+  // the instrumentation compiles to nothing
+  EXPECT_EQ(meta_parser_.stats_.TotalCycles(), 0u);
+#endif
+}
+
+static std::vector<TestParam> stats_dataset() {
+  auto dataset = json_org_dataset(true);
+  const auto seriot = seriot_dataset(true);
+  dataset.insert(dataset.end(), seriot.begin(), seriot.end());
+  return dataset;
+}
+
+INSTANTIATE_TEST_CASE_P(datasets, ParamMetaParserStatsTest,
+                        ::testing::ValuesIn(stats_dataset()));
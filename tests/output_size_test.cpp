@@ -0,0 +1,84 @@
+#include <string>
+#include "fbjson/options.h"
+#include "fbjson/output_size.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+
+class OutputSizeTest : public ::testing::Test {
+ protected:
+  // outlives the builder of `parser_`
+  fbjson::CountingAllocator allocator_;
+  flatbuffers::Parser parser_{ fbjson::StrictJsonOptions() };
+
+  void SetUp() override {
+    std::string schema;
+    ASSERT_TRUE(flatbuffers::LoadFile(FLATBUFFERS_FBS_DIR "test.fbs", false,
+                                      &schema));
+    ASSERT_TRUE(parser_.Parse(schema.c_str())) << parser_.error_;
+    ASSERT_TRUE(parser_.SetRootType("fbt.tIntVInt"));
+  }
+
+  static std::string IntVector(size_t count) {
+    std::string json = R"({"f1": 1, "f2": [)";
+    for (size_t i = 0; i < count; i++) {
+      json += (i ? ", " : "") + std::to_string(i);
+    }
+    return json + "]}";
+  }
+
+  std::string Output() const {
+    return std::string(
+        reinterpret_cast<const char *>(parser_.builder_.GetBufferPointer()),
+        parser_.builder_.GetSize());
+  }
+};
+
+TEST_F(OutputSizeTest, DefaultBuilderGrows) {
+  const auto json = IntVector(100000);
+  parser_.builder_ = flatbuffers::FlatBufferBuilder(1024, &allocator_);
+  ASSERT_TRUE(parser_.Parse(json.c_str())) << parser_.error_;
+  EXPECT_GT(allocator_.grows(), 0u);
+  EXPECT_GT(allocator_.bytes_copied(), 0u);
+}
+
+TEST_F(OutputSizeTest, LearnedEstimateReservesOnce) {
+  const auto json = IntVector(100000);
+  fbjson::OutputSizeEstimator estimator;
+  ASSERT_TRUE(estimator.Parse(&parser_, json.c_str(), json.size(),
+                              &allocator_))
+      << parser_.error_;
+  const auto expected = Output();
+  allocator_.ResetCounters();
+  // the second document of the same root type fits the warm buffer
+  ASSERT_TRUE(estimator.Parse(&parser_, json.c_str(), json.size(),
+                              &allocator_));
+  EXPECT_EQ(allocator_.grows(), 0u);
+  EXPECT_EQ(allocator_.bytes_copied(), 0u);
+  EXPECT_EQ(allocator_.allocations(), 0u);
+  EXPECT_EQ(Output(), expected);
+  EXPECT_GE(estimator.Estimate(*parser_.root_struct_def_, json.size()),
+            expected.size());
+}
+
+TEST_F(OutputSizeTest, ReleasedBufferIsReplaced) {
+  const auto json = IntVector(1000);
+  fbjson::OutputSizeEstimator estimator;
+  ASSERT_TRUE(estimator.Parse(&parser_, json.c_str(), json.size(),
+                              &allocator_))
+      << parser_.error_;
+  const auto expected = Output();
+  const auto released = parser_.builder_.Release();
+  allocator_.ResetCounters();
+  ASSERT_TRUE(estimator.Parse(&parser_, json.c_str(), json.size(),
+                              &allocator_));
+  EXPECT_EQ(allocator_.allocations(), 1u);
+  EXPECT_EQ(allocator_.grows(), 0u);
+  EXPECT_EQ(Output(), expected);
+}
+
+TEST_F(OutputSizeTest, SchemaEstimate) {
+  fbjson::OutputSizeEstimator estimator;
+  const auto &root = *parser_.root_struct_def_;
+  EXPECT_GE(estimator.Estimate(root, 0), 64u);
+  EXPECT_LT(estimator.Estimate(root, 1000), estimator.Estimate(root, 2000));
+}
@@ -0,0 +1,190 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "fbjson/parallel_array.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+#include "json_test_base.h"
+
+#include "test_generated.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string Trim(const std::string &s) {
+  const auto begin = s.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) return std::string();
+  return s.substr(begin, s.find_last_not_of(" \t\r\n") + 1 - begin);
+}
+
+// String literals of `y_string_*` files (`["..."]` or a root string).
+std::vector<std::string> NstStrings() {
+  std::vector<std::string> strings;
+  const auto dir = fs::path(JSON_SAMPLES_DIR) / "nst.JSONTestSuite";
+  for (const auto &entry : fs::directory_iterator(dir)) {
+    const auto name = entry.path().filename().string();
+    if (name.compare(0, 9, "y_string_") != 0) continue;
+    std::string json;
+    if (!flatbuffers::LoadFile(entry.path().string().c_str(), false, &json)) {
+      continue;
+    }
+    json = Trim(json);
+    if (json.front() == '[') json = Trim(json.substr(1, json.size() - 2));
+    strings.push_back(json);
+  }
+  return strings;
+}
+
+}  // namespace
+
+class ParallelArrayTest : public TestFixtureBase {
+ protected:
+  fbjson::Schema schema_;
+
+  void SetUp() override {
+    TestFixtureBase::SetUp();
+    ASSERT_TRUE(parser_.Parse("root_type fbt.tStrInt;")) << parser_.error_;
+    schema_.path = flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR,
+                                                   "parallel_array.fbs");
+    schema_.text =
+        "include \"test.fbs\";\n"
+        "namespace fbt;\n"
+        "table tStrIntVector { f1 : [tStrInt]; }\n";
+    schema_.root_type = "fbt.tStrInt";
+    schema_.include_dirs.push_back(FLATBUFFERS_FBS_DIR);
+    schema_.opts = parser_.opts;
+  }
+
+  // Elements with the strings of the nst suite, which the sequential parser
+  // accepts, and their buffers.
+  void Elements(size_t count, std::vector<std::string> *elements,
+                std::vector<std::string> *buffers) {
+    const auto strings = NstStrings();
+    ASSERT_GT(strings.size(), 30u);
+    for (size_t i = 0; elements->size() < count; i++) {
+      const auto json = "{\"f1\": " + strings[i % strings.size()] +
+                        ", \"f2\": " + std::to_string(i) + "}";
+      if (!parser_.Parse(json.c_str())) continue;
+      elements->push_back(json);
+      buffers->emplace_back(
+          reinterpret_cast<const char *>(parser_.builder_.GetBufferPointer()),
+          parser_.builder_.GetSize());
+    }
+  }
+
+  static std::string Join(const std::vector<std::string> &elements) {
+    std::string json = " [";
+    for (size_t i = 0; i < elements.size(); i++) {
+      json += (i ? " ,\n" : "\n") + elements[i];
+    }
+    return json + "\n] ";
+  }
+};
+
+TEST_F(ParallelArrayTest, SplitFindsElements) {
+  std::vector<std::string> elements, buffers;
+  Elements(100, &elements, &buffers);
+  const auto json = Join(elements);
+  std::vector<fbjson::ArrayElement> found;
+  std::string error;
+  ASSERT_TRUE(fbjson::SplitArray(json.data(), json.size(), &found, &error))
+      << error;
+  ASSERT_EQ(elements.size(), found.size());
+  for (size_t i = 0; i < found.size(); i++) {
+    EXPECT_EQ(elements[i], json.substr(found[i].offset, found[i].size));
+  }
+}
+
+TEST_F(ParallelArrayTest, SplitErrors) {
+  const char *const cases[][2] = {
+    { "{}", "must be an array" },
+    { "[1,,2]", "empty array element" },
+    { "[1,]", "empty array element" },
+    { "[,]", "empty array element" },
+    { "[{\"a\": \"]\\\"}]", "unterminated string" },
+    { "[{]", "mismatched" },
+    { "[1] 2", "after the array" },
+    { "[1 /* c */]", "comments" },
+    { "[[1]", "unclosed" },
+  };
+  for (const auto &c : cases) {
+    std::vector<fbjson::ArrayElement> found;
+    std::string error;
+    const std::string json = c[0];
+    EXPECT_FALSE(fbjson::SplitArray(json.data(), json.size(), &found, &error))
+        << json;
+    EXPECT_NE(error.find(c[1]), std::string::npos) << json << ": " << error;
+  }
+  std::vector<fbjson::ArrayElement> found;
+  std::string error;
+  EXPECT_TRUE(fbjson::SplitArray(" [ ] ", 5, &found, &error)) << error;
+  EXPECT_TRUE(found.empty());
+  const std::string strings = R"(["\\", "\\\"]", '\'', "a,b"])";
+  ASSERT_TRUE(fbjson::SplitArray(strings.data(), strings.size(), &found,
+                                 &error))
+      << error;
+  EXPECT_EQ(4u, found.size());
+}
+
+TEST_F(ParallelArrayTest, SameAsSequentialParse) {
+  std::vector<std::string> elements, expected;
+  Elements(1000, &elements, &expected);
+  const auto json = Join(elements);
+  for (size_t threads : { 1, 2, 3, 8 }) {
+    fbjson::ParallelArrayParser parallel(schema_, threads);
+    std::vector<flatbuffers::DetachedBuffer> buffers;
+    ASSERT_TRUE(parallel.Parse(json.data(), json.size(), &buffers))
+        << parallel.error();
+    ASSERT_EQ(expected.size(), buffers.size());
+    for (size_t i = 0; i < buffers.size(); i++) {
+      ASSERT_EQ(expected[i],
+                std::string(reinterpret_cast<const char *>(buffers[i].data()),
+                            buffers[i].size()))
+          << threads << " threads, element " << i;
+    }
+  }
+}
+
+TEST_F(ParallelArrayTest, FirstErrorIsReported) {
+  std::vector<std::string> elements, expected;
+  Elements(500, &elements, &expected);
+  elements[123] = R"({"f1": 1})";
+  elements[321] = R"({"f2": "x"})";
+  const auto json = Join(elements);
+  fbjson::ParallelArrayParser parallel(schema_, 4);
+  std::vector<flatbuffers::DetachedBuffer> buffers;
+  for (int run = 0; run < 10; run++) {
+    EXPECT_FALSE(parallel.Parse(json.data(), json.size(), &buffers));
+    EXPECT_EQ(0u, parallel.error().find("array element 123:"))
+        << parallel.error();
+    EXPECT_TRUE(buffers.empty());
+  }
+}
+
+TEST_F(ParallelArrayTest, Joined) {
+  std::vector<std::string> elements, expected;
+  Elements(300, &elements, &expected);
+  const auto json = Join(elements);
+  fbjson::ParallelArrayParser parallel(schema_, 4);
+  flatbuffers::DetachedBuffer buffer;
+  ASSERT_TRUE(parallel.ParseJoined(json.data(), json.size(),
+                                   "fbt.tStrIntVector", "f1", &buffer))
+      << parallel.error();
+  const auto root = flatbuffers::GetRoot<flatbuffers::Table>(buffer.data());
+  const auto tables = root->GetPointer<
+      const flatbuffers::Vector<flatbuffers::Offset<fbt::tStrInt>> *>(4);
+  ASSERT_NE(nullptr, tables);
+  ASSERT_EQ(expected.size(), tables->size());
+  for (flatbuffers::uoffset_t i = 0; i < tables->size(); i++) {
+    const auto e = flatbuffers::GetRoot<fbt::tStrInt>(expected[i].data());
+    ASSERT_EQ(e->f2(), tables->Get(i)->f2());
+    ASSERT_EQ(e->f1()->str(), tables->Get(i)->f1()->str());
+  }
+
+  EXPECT_FALSE(parallel.ParseJoined(json.data(), json.size(), "fbt.tStrInt",
+                                    "f1", &buffer));
+  EXPECT_NE(std::string::npos, parallel.error().find("must be a vector"));
+  EXPECT_FALSE(parallel.ParseJoined(json.data(), json.size(), "fbt.tNone",
+                                    "f1", &buffer));
+}
@@ -0,0 +1,154 @@
+#include <memory>
+#include <string>
+#include "fbjson/parser_view.h"
+#include "fbjson/symbol_index.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+
+#include "json_test_base.h"
+
+class ParserViewTest : public TestFixtureBase {
+ protected:
+  // `test.fbs` parsed with `opts`, as the fixture does for each variant.
+  std::unique_ptr<flatbuffers::Parser> FullParser(
+      const flatbuffers::IDLOptions &opts) {
+    std::unique_ptr<flatbuffers::Parser> parser(
+        new flatbuffers::Parser(opts));
+    std::string schema;
+    const auto fname =
+        flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.fbs");
+    EXPECT_TRUE(flatbuffers::LoadFile(fname.c_str(), false, &schema));
+    EXPECT_TRUE(parser->Parse(schema.c_str(), fbs_include_dir()))
+        << parser->error_;
+    return parser;
+  }
+
+  // Every case gives the same result, error and buffer through a view of
+  // `parser_` as through a parser of its own.
+  void ExpectSameAsFullParser(const std::vector<TestParam> &dataset,
+                              const ParserTraits &traits) {
+    auto reference = FullParser(traits.opts);
+    const std::string prefix = "root_type fbt.";
+    for (const auto &param : dataset) {
+      const std::string decl = std::get<1>(param);
+      const auto json = std::get<2>(param);
+      // Only "root_type fbt.X;" cases: others declare their own schema,
+      // which the base parser doesn't have.
+      if (!json || decl.compare(0, prefix.size(), prefix) ||
+          decl.find(';') != decl.size() - 1) {
+        continue;
+      }
+      std::string text = json;
+      if (*json == '/') {
+        const auto fname =
+            flatbuffers::ConCatPathFileName(JSON_SAMPLES_DIR, json);
+        ASSERT_TRUE(flatbuffers::LoadFile(fname.c_str(), false, &text));
+      }
+      ASSERT_TRUE(reference->Parse(decl.c_str())) << reference->error_;
+      const auto root = decl.substr(10, decl.size() - 11);
+      fbjson::ParserView view(parser_, traits.opts);
+      ASSERT_TRUE(view.SetRootType(root.c_str())) << root;
+
+      const auto expected = reference->Parse(text.c_str());
+      const auto start = text.find_first_not_of(" \t\r\n");
+      if (start == std::string::npos ||
+          (text[start] != '{' && text[start] != '[')) {
+        // not a JSON document, declarations are rejected by views
+        EXPECT_FALSE(view.Parse(text.c_str())) << json;
+        continue;
+      }
+      ASSERT_EQ(expected, view.Parse(text.c_str())) << json;
+      ASSERT_EQ(expected, std::get<0>(param)) << json;
+      EXPECT_EQ(reference->error_, view.parser().error_) << json;
+      if (!expected) continue;
+      EXPECT_EQ(Buffer(*reference), Buffer(view.parser())) << json;
+    }
+  }
+
+  static std::string Buffer(const flatbuffers::Parser &parser) {
+    return std::string(
+        reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+        parser.builder_.GetSize());
+  }
+};
+
+TEST_F(ParserViewTest, JsonOrgStrict) {
+  ExpectSameAsFullParser(json_org_dataset(true), ParserTraits());
+}
+
+TEST_F(ParserViewTest, JsonOrgNonStrict) {
+  ExpectSameAsFullParser(json_org_dataset(false), ParserTraitsNonStrict());
+}
+
+TEST_F(ParserViewTest, SeriotStrict) {
+  ExpectSameAsFullParser(seriot_dataset(true), ParserTraits());
+}
+
+TEST_F(ParserViewTest, OwnOptions) {
+  auto strict = ParserTraits().opts;
+  strict.skip_unexpected_fields_in_json = false;
+  fbjson::ParserView strict_view(parser_, strict);
+  fbjson::ParserView lenient_view(parser_, ParserTraitsNonStrict().opts);
+  for (auto view : { &strict_view, &lenient_view }) {
+    ASSERT_TRUE(view->SetRootType("fbt.tStrInt"));
+  }
+  EXPECT_FALSE(strict_view.Parse(R"({ f1: "a", f2: 1 })"));
+  EXPECT_TRUE(lenient_view.Parse(R"({ f1: "a", f2: 1 })"))
+      << lenient_view.parser().error_;
+  EXPECT_FALSE(strict_view.Parse(R"({ "f1": "a", "unknown": 1 })"));
+  EXPECT_TRUE(lenient_view.Parse(R"({ "f1": "a", "unknown": 1 })"))
+      << lenient_view.parser().error_;
+  EXPECT_TRUE(strict_view.Parse(R"({ "f1": "a", "f2": 1 })"))
+      << strict_view.parser().error_;
+
+  // the base is unchanged
+  EXPECT_TRUE(parser_.opts.strict_json);
+  EXPECT_EQ(parser_.root_struct_def_, nullptr);
+  EXPECT_FALSE(strict_view.SetRootType("fbt.tUnknown"));
+  EXPECT_FALSE(strict_view.SetRootType("tStrInt"));
+}
+
+TEST_F(ParserViewTest, SharedIndex) {
+  const fbjson::SymbolIndex index(parser_);
+  fbjson::ParserView view(parser_, ParserTraits().opts, &index);
+  fbjson::ParserView plain(parser_, ParserTraits().opts);
+  for (const auto &entry : parser_.structs_.dict) {
+    ASSERT_TRUE(view.SetRootType(entry.first.c_str())) << entry.first;
+    ASSERT_TRUE(plain.SetRootType(entry.first.c_str())) << entry.first;
+    EXPECT_EQ(view.parser().root_struct_def_, plain.parser().root_struct_def_);
+  }
+  EXPECT_FALSE(view.SetRootType("fbt.tUnknown"));
+  EXPECT_FALSE(view.SetRootType("tStrInt"));
+  ASSERT_TRUE(view.SetRootType("fbt.tStrInt"));
+  EXPECT_TRUE(view.Parse(R"({ "f1": "a", "f2": 1 })"))
+      << view.parser().error_;
+}
+
+TEST_F(ParserViewTest, OutlivedByBase) {
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tIntInt;")) << parser_.error_;
+  for (int i = 0; i < 3; i++) {
+    fbjson::ParserView view(parser_, ParserTraitsNonStrict().opts);
+    ASSERT_TRUE(view.Parse("{ f1: 1, f2: 2 }")) << view.parser().error_;
+    std::string text;
+    ASSERT_TRUE(flatbuffers::GenerateText(
+        view.parser(), view.parser().builder_.GetBufferPointer(), &text));
+    EXPECT_NE(text.find("f2: 2"), std::string::npos) << text;
+  }
+  // the definitions are still there
+  EXPECT_EQ(parser_.structs_.vec.size(), parser_.structs_.dict.size());
+  ASSERT_TRUE(parser_.Parse(R"({ "f1": 3 })")) << parser_.error_;
+}
+
+TEST_F(ParserViewTest, RejectsDeclarations) {
+  fbjson::ParserView view(parser_, ParserTraits().opts);
+  ASSERT_TRUE(view.SetRootType("fbt.tStrInt"));
+  for (const auto text :
+       { "enum E : byte { A }", "table T {}", "root_type fbt.tIntInt;",
+         "", "  1" }) {
+    EXPECT_FALSE(view.Parse(text)) << text;
+  }
+  EXPECT_EQ(view.parser().enums_.vec.size(), parser_.enums_.vec.size());
+  EXPECT_TRUE(view.parser().structs_.vec.empty());
+  EXPECT_TRUE(view.Parse(R"( { "f1": "a" })")) << view.parser().error_;
+}
@@ -0,0 +1,171 @@
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fbjson/bounded_queue.h"
+#include "fbjson/pipeline.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+#include "json_test_base.h"
+
+#include "test_generated.h"
+
+namespace fs = std::filesystem;
+
+TEST(BoundedQueueTest, FullAndEmpty) {
+  fbjson::BoundedQueue<int> queue(3);
+  EXPECT_EQ(queue.capacity(), 4u);
+  int value = 0;
+  EXPECT_FALSE(queue.TryPop(&value));
+  for (int i = 0; i < 4; i++) EXPECT_TRUE(queue.TryPush(int(i)));
+  EXPECT_FALSE(queue.TryPush(4));
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(queue.TryPop(&value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.TryPop(&value));
+}
+
+TEST(BoundedQueueTest, ManyProducersAndConsumers) {
+  const size_t kThreads = 4, kItems = 100000;
+  fbjson::BoundedQueue<size_t> queue(16);
+  std::atomic<size_t> popped(0), sum(0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; t++) {
+    threads.emplace_back([&] {
+      for (size_t i = 1; i <= kItems; i++) {
+        while (!queue.TryPush(size_t(i))) std::this_thread::yield();
+      }
+    });
+    threads.emplace_back([&] {
+      size_t value = 0;
+      while (popped.load() < kThreads * kItems) {
+        if (queue.TryPop(&value)) {
+          sum += value;
+          popped++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+  EXPECT_EQ(sum.load(), kThreads * kItems * (kItems + 1) / 2);
+}
+
+class PipelineTest : public ::testing::Test {
+ protected:
+  fbjson::Schema schema_;
+  std::string dir_;
+  std::vector<std::string> files_;
+
+  void SetUp() override {
+    schema_.path =
+        flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.fbs");
+    schema_.root_type = "fbt.tStrInt";
+    schema_.include_dirs.push_back(FLATBUFFERS_FBS_DIR);
+    // the same options as the dataset tests
+    schema_.opts = ParserTraits().opts;
+    ASSERT_TRUE(flatbuffers::LoadFile(schema_.path.c_str(), false,
+                                      &schema_.text));
+    dir_ = (fs::temp_directory_path() / "fbjson_pipeline_test").string();
+    fs::remove_all(dir_);
+    fs::create_directories(dir_);
+    for (int i = 0; i < 50; i++) {
+      const auto json = "{\"f1\": \"doc" + std::to_string(i) +
+                        "\", \"f2\": " + std::to_string(i) + "}";
+      Add("doc" + std::to_string(i) + ".json", json);
+    }
+  }
+
+  void TearDown() override { fs::remove_all(dir_); }
+
+  void Add(const std::string &name, const std::string &json) {
+    files_.push_back(flatbuffers::ConCatPathFileName(dir_, name));
+    ASSERT_TRUE(flatbuffers::SaveFile(files_.back().c_str(), json, false));
+  }
+};
+
+TEST_F(PipelineTest, ConvertsAllFiles) {
+  fbjson::PipelineOptions options;
+  options.read_threads = 2;
+  options.parse_threads = 3;
+  options.verify_threads = 2;
+  options.write_threads = 2;
+  options.queue_capacity = 2;
+  options.output_dir = dir_ + "/out";
+  fbjson::ConversionPipeline pipeline(schema_, options);
+  fbjson::PipelineStats stats;
+  ASSERT_TRUE(pipeline.Run(files_, &stats)) << pipeline.errors().front();
+  EXPECT_EQ(stats.files, files_.size());
+  EXPECT_EQ(stats.failed, 0u);
+  EXPECT_GT(stats.output_bytes, 0u);
+  for (int s = 0; s < fbjson::PipelineStats::kNumStages; s++) {
+    EXPECT_EQ(stats.stages[s].items, files_.size());
+  }
+  EXPECT_EQ(stats.stages[fbjson::PipelineStats::kParse].threads, 3u);
+
+  std::string buf;
+  ASSERT_TRUE(flatbuffers::LoadFile((options.output_dir + "/doc7.bin").c_str(),
+                                    true, &buf));
+  const auto root = flatbuffers::GetRoot<fbt::tStrInt>(buf.data());
+  ASSERT_NE(root->f1(), nullptr);
+  EXPECT_STREQ(root->f1()->c_str(), "doc7");
+  EXPECT_EQ(root->f2(), 7);
+}
+
+TEST_F(PipelineTest, ReportsFailedFiles) {
+  Add("bad.json", "{\"f1\": \"bad\",}");
+  files_.push_back(dir_ + "/missing.json");
+  fbjson::PipelineOptions options;
+  options.parse_threads = 2;
+  options.verify = false;
+  fbjson::ConversionPipeline pipeline(schema_, options);
+  fbjson::PipelineStats stats;
+  EXPECT_FALSE(pipeline.Run(files_, &stats));
+  EXPECT_EQ(stats.files, files_.size() - 2);
+  EXPECT_EQ(stats.failed, 2u);
+  ASSERT_EQ(pipeline.errors().size(), 2u);
+  EXPECT_NE(pipeline.errors()[0].find("bad.json"), std::string::npos);
+  EXPECT_NE(pipeline.errors()[1].find("missing.json"), std::string::npos);
+  EXPECT_EQ(stats.stages[fbjson::PipelineStats::kVerify].threads, 0u);
+  // nothing written without an output directory
+  EXPECT_FALSE(fs::exists(dir_ + "/doc0.bin"));
+}
+
+TEST_F(PipelineTest, FilesWithoutDocument) {
+  Add("blank.json", " \n");
+  Add("decl.json", "root_type fbt.tStrInt;");
+  fbjson::PipelineOptions options;
+  options.output_dir = dir_ + "/out";
+  fbjson::ConversionPipeline pipeline(schema_, options);
+  fbjson::PipelineStats stats;
+  EXPECT_FALSE(pipeline.Run(files_, &stats));
+  EXPECT_EQ(stats.files, files_.size() - 2);
+  ASSERT_EQ(pipeline.errors().size(), 2u);
+  EXPECT_NE(pipeline.errors()[0].find("blank.json"), std::string::npos);
+  EXPECT_NE(pipeline.errors()[1].find("decl.json"), std::string::npos);
+  EXPECT_FALSE(fs::exists(options.output_dir + "/blank.bin"));
+  EXPECT_FALSE(fs::exists(options.output_dir + "/decl.bin"));
+}
+
+TEST_F(PipelineTest, SameFileTwice) {
+  files_.push_back(files_.front());
+  fbjson::PipelineOptions options;
+  options.verify = false;
+  fbjson::ConversionPipeline pipeline(schema_, options);
+  fbjson::PipelineStats stats;
+  EXPECT_TRUE(pipeline.Run(files_, &stats)) << pipeline.errors().front();
+  EXPECT_EQ(stats.files, files_.size());
+  EXPECT_EQ(stats.failed, 0u);
+}
+
+TEST_F(PipelineTest, SchemaError) {
+  schema_.root_type = "fbt.tUnknown";
+  fbjson::ConversionPipeline pipeline(schema_, fbjson::PipelineOptions());
+  fbjson::PipelineStats stats;
+  EXPECT_FALSE(pipeline.Run(files_, &stats));
+  EXPECT_EQ(pipeline.errors().size(), 1u);
+  EXPECT_EQ(stats.files, 0u);
+}
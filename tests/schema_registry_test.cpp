@@ -0,0 +1,122 @@
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "fbjson/options.h"
+#include "fbjson/schema_registry.h"
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+
+#include "test_generated.h"
+
+// Use global define `FLATBUFFERS_FBS_DIR` for reference to fbs files.
+
+class SchemaRegistryTest : public ::testing::Test {
+ protected:
+  fbjson::SchemaRegistry registry_;
+
+  void SetUp() override {
+    registry_.SetOptions(fbjson::StrictJsonOptions());
+    registry_.AddIncludeDirectory(FLATBUFFERS_FBS_DIR);
+    const auto schema =
+        flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.fbs");
+    ASSERT_TRUE(registry_.Register("TSTR", schema.c_str(), "fbt.tStrInt"))
+        << registry_.GetLastError();
+    ASSERT_TRUE(registry_.Register("TINT", schema.c_str(), "fbt.tIntInt"))
+        << registry_.GetLastError();
+  }
+};
+
+TEST_F(SchemaRegistryTest, RegisterErrors) {
+  const auto schema =
+      flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.fbs");
+  EXPECT_FALSE(registry_.Register("TOOLONG", schema.c_str(), "fbt.tInt"));
+  EXPECT_FALSE(registry_.Register("NONE", "no_such_file.fbs", "fbt.tInt"));
+  EXPECT_FALSE(registry_.Register("ROOT", schema.c_str(), "fbt.tUnknown"));
+  // root type isn't declared by `test.fbs`
+  EXPECT_FALSE(registry_.Register("NORT", schema.c_str()));
+  EXPECT_EQ(registry_.size(), 2u);
+  EXPECT_EQ(registry_.Find("NONE"), nullptr);
+  ASSERT_NE(registry_.Find("TSTR"), nullptr);
+  EXPECT_EQ(registry_.Find("TSTR")->root_type, "fbt.tStrInt");
+}
+
+TEST_F(SchemaRegistryTest, RoundTrip) {
+  fbjson::SchemaRegistry::ParseContext ctx(registry_);
+  auto buf = ctx.TextToFlatBuffer(R"({"f1": "abc", "f2": 7})", "TSTR");
+  ASSERT_NE(buf.size(), 0u) << ctx.GetLastError();
+  ASSERT_TRUE(flatbuffers::BufferHasIdentifier(buf.data(), "TSTR"));
+  flatbuffers::Verifier verifier(buf.data(), buf.size());
+  ASSERT_TRUE(verifier.VerifyBuffer<fbt::tStrInt>("TSTR"));
+  auto t = flatbuffers::GetRoot<fbt::tStrInt>(buf.data());
+  EXPECT_STREQ(t->f1()->c_str(), "abc");
+  EXPECT_EQ(t->f2(), 7);
+
+  std::string text;
+  ASSERT_TRUE(ctx.FlatBufferToText(buf.data(), buf.size(), &text))
+      << ctx.GetLastError();
+  auto buf2 = ctx.TextToFlatBuffer(text.c_str(), "TSTR");
+  ASSERT_EQ(buf.size(), buf2.size());
+  EXPECT_EQ(0, std::memcmp(buf.data(), buf2.data(), buf.size()));
+}
+
+TEST_F(SchemaRegistryTest, ContextsShareTheSchemaParser) {
+  const auto schema = registry_.Find("TSTR");
+  ASSERT_NE(schema, nullptr);
+  ASSERT_NE(schema->base, nullptr);
+  fbjson::SchemaRegistry::ParseContext ctx_1(registry_);
+  fbjson::SchemaRegistry::ParseContext ctx_2(registry_);
+  const auto parser_1 = ctx_1.Parse(R"({"f1": "a"})", "TSTR");
+  const auto parser_2 = ctx_2.Parse(R"({"f1": "b"})", "TSTR");
+  ASSERT_NE(parser_1, nullptr) << ctx_1.GetLastError();
+  ASSERT_NE(parser_2, nullptr) << ctx_2.GetLastError();
+  EXPECT_NE(parser_1, parser_2);
+  // no definitions of their own, the schema isn't parsed again
+  for (const auto parser : { parser_1, parser_2 }) {
+    EXPECT_TRUE(parser->structs_.vec.empty());
+    EXPECT_EQ(parser->root_struct_def_, schema->base->root_struct_def_);
+  }
+}
+
+TEST_F(SchemaRegistryTest, ContextErrors) {
+  fbjson::SchemaRegistry::ParseContext ctx(registry_);
+  EXPECT_EQ(ctx.Parse(R"({"f1": 1})", "NONE"), nullptr);
+  EXPECT_NE(ctx.GetLastError().find("unknown file identifier"),
+            std::string::npos);
+  EXPECT_EQ(ctx.Parse(R"(["Unclosed array")", "TSTR"), nullptr);
+  EXPECT_FALSE(ctx.GetLastError().empty());
+  // the cached parser is still usable after the error
+  EXPECT_NE(ctx.Parse(R"(["closed", 1])", "TSTR"), nullptr)
+      << ctx.GetLastError();
+}
+
+TEST_F(SchemaRegistryTest, ConcurrentContexts) {
+  const auto schema =
+      flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.fbs");
+  std::vector<std::thread> threads;
+  std::vector<int> failures(4, 0);
+  for (size_t t = 0; t < failures.size(); t++) {
+    threads.emplace_back([&, t] {
+      fbjson::SchemaRegistry::ParseContext ctx(registry_);
+      for (int i = 0; i < 200; i++) {
+        const auto json = "[" + std::to_string(i) + ", " +
+                          std::to_string(static_cast<int>(t)) + "]";
+        auto parser = ctx.Parse(json.c_str(), "TINT");
+        if (!parser) {
+          failures[t]++;
+          continue;
+        }
+        auto root = flatbuffers::GetRoot<fbt::tIntInt>(
+            parser->builder_.GetBufferPointer());
+        if (root->f1() != i || root->f2() != static_cast<int>(t)) {
+          failures[t]++;
+        }
+      }
+    });
+  }
+  // Readers must not be disturbed by a concurrent registration.
+  ASSERT_TRUE(registry_.Register("TBOL", schema.c_str(), "fbt.tBool"));
+  for (auto &t : threads) t.join();
+  for (auto f : failures) EXPECT_EQ(f, 0);
+  EXPECT_NE(registry_.Find("TBOL"), nullptr);
+}
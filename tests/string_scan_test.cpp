@@ -0,0 +1,157 @@
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include "fbjson/flex_parser.h"
+#include "fbjson/meta_parser.h"
+#include "fbjson/options.h"
+#include "fbjson/string_scan.h"
+#include "fbjson/text_generator.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+#include "test_meta_generated.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool IsPlain(unsigned char c) {
+  return c >= 0x20 && c < 0x7f && c != '"' && c != '\\';
+}
+
+// String cases of the datasets: `y_string_*` (valid), `n_string_*` and
+// json.org fail15-fail28 (invalid).
+std::vector<std::string> StringCases(bool valid) {
+  std::vector<std::string> files;
+  for (const auto &entry : fs::directory_iterator(
+           fs::path(JSON_SAMPLES_DIR) / "nst.JSONTestSuite")) {
+    const auto name = entry.path().filename().string();
+    if (name.compare(0, 9, valid ? "y_string_" : "n_string_") == 0) {
+      files.push_back(entry.path().string());
+    }
+  }
+  for (int i = 15; !valid && i <= 28; i++) {
+    files.push_back((fs::path(JSON_SAMPLES_DIR) / "json.org" /
+                     ("fail" + std::to_string(i) + ".json"))
+                        .string());
+  }
+  return files;
+}
+
+std::string Load(const std::string &path) {
+  std::string json;
+  EXPECT_TRUE(flatbuffers::LoadFile(path.c_str(), false, &json)) << path;
+  return json;
+}
+
+}  // namespace
+
+// Every byte value at every position and alignment of the first blocks.
+TEST(StringScanTest, PlainRunsMatchByteLoop) {
+  alignas(64) char buf[128];
+  for (size_t offset = 0; offset < 32; offset++) {
+    for (size_t pos = 0; pos < 48; pos++) {
+      for (int byte = 0; byte < 256; byte++) {
+        std::memset(buf, 'a', sizeof(buf) - 1);
+        buf[sizeof(buf) - 1] = 0;
+        buf[offset + pos] = static_cast<char>(byte);
+        const auto s = buf + offset;
+        const auto expected = IsPlain(static_cast<unsigned char>(byte))
+                                  ? sizeof(buf) - 1 - offset
+                                  : pos;
+        ASSERT_EQ(s + expected, fbjson::SkipPlain(s)) << offset << " " << byte;
+        for (const auto size : { pos, pos + 1, size_t(64) }) {
+          ASSERT_EQ(std::min(expected, size), fbjson::PlainPrefix(s, size))
+              << offset << " " << pos << " " << byte;
+        }
+      }
+    }
+  }
+}
+
+TEST(StringScanTest, AppendEscapedMatchesEscapeString) {
+  std::vector<std::string> cases;
+  for (int byte = 0; byte < 256; byte++) {
+    cases.push_back("plain text, then " + std::string(1, char(byte)) +
+                    std::string(20, 'x'));
+  }
+  std::mt19937 rng(42);
+  // quotes, escapes, controls, DEL and 2-4 byte UTF-8
+  const char mixed[] =
+      "ab \"\\\n\t\x01\x7f\xc3\xa9\xe2\x82\xac\xf0\x9d\x84\x9e";
+  for (int i = 0; i < 2000; i++) {
+    std::string s(rng() % 100, ' ');
+    for (auto &c : s) {
+      c = rng() % 4 ? mixed[rng() % (sizeof(mixed) - 1)]
+                    : static_cast<char>(rng());
+    }
+    cases.push_back(s);
+  }
+  for (const auto &s : cases) {
+    for (const auto allow_non_utf8 : { false, true }) {
+      for (const auto natural_utf8 : { false, true }) {
+        std::string expected = "prefix", text = "prefix";
+        const auto ok = flatbuffers::EscapeString(
+            s.data(), s.size(), &expected, allow_non_utf8, natural_utf8);
+        ASSERT_EQ(ok, fbjson::AppendEscaped(s.data(), s.size(), &text,
+                                            allow_non_utf8, natural_utf8))
+            << s;
+        if (ok) ASSERT_EQ(expected, text);
+      }
+    }
+  }
+}
+
+// Valid strings read back the same as with `flatbuffers::Parser` and print
+// the same as `flatbuffers::GenerateText`; invalid ones are rejected.
+TEST(StringScanTest, DatasetStrings) {
+  flatbuffers::Parser reference(fbjson::StrictJsonOptions());
+  std::string schema;
+  ASSERT_TRUE(flatbuffers::LoadFile(FLATBUFFERS_FBS_DIR "test.fbs", false,
+                                    &schema));
+  ASSERT_TRUE(reference.Parse(schema.c_str())) << reference.error_;
+  ASSERT_TRUE(reference.SetRootType("fbt.tStr"));
+  fbjson::MetaParser meta_parser(fbt::meta::kSchema);
+  const auto root = static_cast<int>(fbt::meta::TableIndex::tStr);
+  fbjson::FlexParser flex_parser;
+  fbjson::TextOptions text_options;
+  text_options.float_precision = 6;
+
+  const auto valid = StringCases(true);
+  ASSERT_GT(valid.size(), 40u);
+  for (const auto &file : valid) {
+    const auto json = Load(file);
+    EXPECT_TRUE(flex_parser.Parse(json.c_str())) << file << flex_parser.error_;
+    // a string root isn't a table
+    if (json[json.find_first_not_of(" \t\r\n")] != '[') continue;
+    ASSERT_TRUE(meta_parser.Parse(json.c_str(), root))
+        << file << meta_parser.error_;
+    if (!reference.Parse(json.c_str())) continue;
+    const auto buffer = reference.builder_.GetBufferPointer();
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(buffer),
+                          reference.builder_.GetSize()),
+              std::string(reinterpret_cast<const char *>(
+                              meta_parser.builder_.GetBufferPointer()),
+                          meta_parser.builder_.GetSize()))
+        << file;
+    for (const auto natural_utf8 : { false, true }) {
+      reference.opts.natural_utf8 = natural_utf8;
+      std::string expected, text;
+      EXPECT_EQ(flatbuffers::GenerateText(reference, buffer, &expected),
+                fbjson::GenerateText(reference, buffer, text_options, &text))
+          << file;
+      EXPECT_EQ(expected, text) << file;
+    }
+    reference.opts.natural_utf8 = false;
+  }
+
+  for (const auto &file : StringCases(false)) {
+    const auto json = Load(file);
+    EXPECT_FALSE(meta_parser.Parse(json.c_str(), root)) << file;
+    // the depth limit is 64
+    if (fs::path(file).filename() == "fail18.json") continue;
+    EXPECT_FALSE(flex_parser.Parse(json.c_str())) << file;
+  }
+}
@@ -0,0 +1,100 @@
+#include <memory>
+#include <string>
+#include "fbjson/options.h"
+#include "fbjson/symbol_index.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+#include "json_test_base.h"
+
+class SymbolIndexTest : public TestFixtureBase {
+ protected:
+  // Every symbol of the parser is found at the same definition.
+  void ExpectSameSymbols(const fbjson::SymbolIndex &index) {
+    ASSERT_EQ(parser_.structs_.vec.size(), index.num_structs());
+    for (const auto &entry : parser_.structs_.dict) {
+      const auto &name = entry.first;
+      const auto i = index.FindStruct(name.c_str(), name.size());
+      ASSERT_GE(i, 0) << name;
+      EXPECT_EQ(entry.second, &index.struct_def(i)) << name;
+      EXPECT_EQ(entry.second, index.LookupStruct(name.c_str(), name.size()));
+      for (const auto &field : entry.second->fields.dict) {
+        EXPECT_EQ(field.second, index.LookupField(i, field.first.c_str(),
+                                                  field.first.size()))
+            << name << "." << field.first;
+      }
+      const auto &fields = entry.second->fields.vec;
+      for (size_t f = 0; f < fields.size(); f++) {
+        EXPECT_EQ(static_cast<int>(f),
+                  index.FindField(i, fields[f]->name.c_str(),
+                                  fields[f]->name.size()))
+            << name << "." << fields[f]->name;
+      }
+      EXPECT_EQ(nullptr, index.LookupField(i, "unknown", 7));
+      EXPECT_EQ(-1, index.FindField(i, "unknown", 7));
+    }
+    for (const auto &entry : parser_.enums_.dict) {
+      EXPECT_EQ(entry.second, index.LookupEnum(entry.first.c_str(),
+                                               entry.first.size()))
+          << entry.first;
+    }
+  }
+};
+
+TEST_F(SymbolIndexTest, TestSchema) {
+  const fbjson::SymbolIndex index(parser_);
+  ExpectSameSymbols(index);
+  EXPECT_EQ(nullptr, index.LookupStruct("fbt.unknown", 11));
+  // names are fully qualified
+  EXPECT_EQ(nullptr, index.LookupStruct("tEmpty", 6));
+  EXPECT_NE(nullptr, index.LookupStruct("fbt.tEmpty", 10));
+  EXPECT_EQ(nullptr, index.LookupEnum("fbt.tEmpty", 10));
+  EXPECT_GT(index.MemoryUsage(), 0u);
+}
+
+TEST_F(SymbolIndexTest, LargeSchema) {
+  // same table and field names in two namespaces, enums in between
+  std::string schema;
+  for (const auto ns : { "big.a", "big.b" }) {
+    schema += "namespace " + std::string(ns) + ";\n";
+    for (int t = 0; t < 1500; t++) {
+      const auto n = flatbuffers::NumToString(t);
+      if (t % 10 == 0) schema += "enum E" + n + " : byte { x, y }\n";
+      schema += "table T" + n + " { f0 : int; name : string; next : T" +
+                flatbuffers::NumToString(t + 1) + "; }\n";
+    }
+    schema += "table T1500 {}\n";
+  }
+  ASSERT_TRUE(parser_.Parse(schema.c_str())) << parser_.error_;
+  const fbjson::SymbolIndex index(parser_);
+  ExpectSameSymbols(index);
+  const auto a = index.FindStruct("big.a.T7", 8);
+  const auto b = index.FindStruct("big.b.T7", 8);
+  ASSERT_GE(a, 0);
+  ASSERT_GE(b, 0);
+  EXPECT_NE(a, b);
+  EXPECT_NE(index.LookupField(a, "next", 4), index.LookupField(b, "next", 4));
+  EXPECT_EQ(-1, index.FindStruct("big.c.T7", 8));
+}
+
+TEST_F(SymbolIndexTest, TablesOnly) {
+  std::unique_ptr<flatbuffers::Parser> parser(
+      new flatbuffers::Parser(fbjson::StrictJsonOptions()));
+  ASSERT_TRUE(parser->Parse("namespace s; table A { x: int; p: P; }\n"
+                            "struct P { x: int; y: int; }\n"
+                            "enum E : byte { x }\n"
+                            "table B { e: E; a: A; }"))
+      << parser->error_;
+  const fbjson::SymbolIndex index(*parser,
+                                  fbjson::SymbolIndex::Scope::kTables);
+  EXPECT_EQ(2u, index.num_structs());
+  EXPECT_EQ(parser->LookupStruct("s.B"), index.LookupStruct("s.B", 3));
+  // names are copied: found after the parser is gone
+  parser.reset();
+  EXPECT_EQ(0, index.FindStruct("s.A", 3));
+  EXPECT_EQ(1, index.FindStruct("s.B", 3));
+  EXPECT_EQ(-1, index.FindStruct("s.P", 3));
+  EXPECT_EQ(nullptr, index.LookupEnum("s.E", 3));
+  EXPECT_EQ(1, index.FindField(0, "p", 1));
+  EXPECT_EQ(1, index.FindField(1, "a", 1));
+  EXPECT_EQ(-1, index.FindField(1, "x", 1));
+}
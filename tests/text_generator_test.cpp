@@ -0,0 +1,246 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "fbjson/text_generator.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+#include "json_test_base.h"
+
+#include "test_generated.h"
+
+class TextGeneratorTest : public TestFixtureBase {
+ protected:
+  // `ParserPrintDecodePrintTest` with `fbjson::GenerateText`: print the
+  // builder's buffer, parse the text and print again.
+  void PrintDecodePrint(const fbjson::TextOptions &options,
+                        std::string *text) {
+    text->clear();
+    ASSERT_TRUE(fbjson::GenerateText(
+        parser_, parser_.builder_.GetBufferPointer(), options, text));
+    ASSERT_TRUE(parser_.Parse(text->c_str())) << parser_.error_ << *text;
+    std::string text_2;
+    ASSERT_TRUE(fbjson::GenerateText(
+        parser_, parser_.builder_.GetBufferPointer(), options, &text_2));
+    ASSERT_EQ(*text, text_2);
+  }
+
+  // Calls `f` with the buffer of every dataset case the parser accepts,
+  // returns the number of calls.
+  template<typename F> size_t ForEachDatasetBuffer(F f) {
+    auto dataset = json_org_dataset(true);
+    const auto seriot = seriot_dataset(true);
+    dataset.insert(dataset.end(), seriot.begin(), seriot.end());
+    size_t buffers = 0;
+    for (const auto &param : dataset) {
+      EXPECT_TRUE(parser_.Parse(std::get<1>(param))) << parser_.error_;
+      std::string json = std::get<2>(param);
+      if (json[0] == '/') {
+        const auto full_fname =
+            flatbuffers::ConCatPathFileName(JSON_SAMPLES_DIR, json);
+        EXPECT_TRUE(flatbuffers::LoadFile(full_fname.c_str(), false, &json));
+      }
+      if (!parser_.Parse(json.c_str()) || !parser_.builder_.GetSize()) {
+        continue;
+      }
+      f(parser_.builder_.GetBufferPointer(), std::get<2>(param));
+      buffers++;
+    }
+    return buffers;
+  }
+
+  float ParsedFloat() {
+    return flatbuffers::GetRoot<fbt::tFloat>(
+               parser_.builder_.GetBufferPointer())
+        ->f1();
+  }
+};
+
+TEST_F(TextGeneratorTest, AppendFloat) {
+  const struct {
+    double value;
+    bool single;
+    int precision;
+    const char *text;
+  } cases[] = {
+    { 0.1, true, -1, "0.1" },
+    { 0.1, false, -1, "0.1" },
+    { 1e-7, true, -1, "1e-07" },
+    { 1e22, false, -1, "1e+22" },
+    { 100, false, -1, "100.0" },
+    { -2.5, true, -1, "-2.5" },
+    { 1.5, true, 6, "1.5" },
+    { 1, false, 12, "1.0" },
+    { 1e-7, true, 6, "0.0" },
+    { 2.25, false, 0, "2.0" },
+    { 1.0 / 3, false, 4, "0.3333" },
+    { std::numeric_limits<double>::infinity(), false, -1, "inf" },
+    { -std::numeric_limits<double>::infinity(), false, 6, "-inf" },
+  };
+  for (const auto &c : cases) {
+    std::string text = "x";
+    if (c.single) {
+      fbjson::AppendFloat(static_cast<float>(c.value), c.precision, &text);
+    } else {
+      fbjson::AppendFloat(c.value, c.precision, &text);
+    }
+    EXPECT_EQ(std::string("x") + c.text, text) << c.value;
+  }
+  std::string nan;
+  fbjson::AppendFloat(std::numeric_limits<double>::quiet_NaN(), -1, &nan);
+  EXPECT_NE(std::string::npos, nan.find("nan"));
+}
+
+// With flatc's precision the text is the same as `flatbuffers::GenerateText`
+// for every dataset case (test.fbs has only `float` fields).
+TEST_F(TextGeneratorTest, SameTextAsFlatcWithItsPrecision) {
+  fbjson::TextOptions options;
+  options.float_precision = 6;
+  const auto compared = ForEachDatasetBuffer([&](const uint8_t *buffer,
+                                                 const char *name) {
+    std::string expected, text;
+    ASSERT_TRUE(flatbuffers::GenerateText(parser_, buffer, &expected));
+    ASSERT_TRUE(fbjson::GenerateText(parser_, buffer, options, &text));
+    EXPECT_EQ(expected, text) << name;
+  });
+  EXPECT_GT(compared, 50u);
+}
+
+// Chunks of a few bytes join into the same text as the string output.
+TEST_F(TextGeneratorTest, ChunkedOutputMatchesString) {
+  fbjson::TextOptions options;
+  options.chunk_size = 16;
+  ForEachDatasetBuffer([&](const uint8_t *buffer, const char *name) {
+    std::string expected, text;
+    size_t chunks = 0;
+    ASSERT_TRUE(fbjson::GenerateText(parser_, buffer, options, &expected));
+    ASSERT_TRUE(fbjson::GenerateText(
+        parser_, buffer, options, [&](const char *data, size_t size) {
+          EXPECT_NE(0u, size);
+          text.append(data, size);
+          chunks++;
+          return true;
+        }));
+    EXPECT_EQ(expected, text) << name;
+    EXPECT_GE(chunks, expected.size() / 64) << name;
+
+    // a fixed buffer of exactly the text size, and one byte less
+    std::vector<char> fixed(expected.size());
+    size_t size = 0;
+    ASSERT_TRUE(fbjson::GenerateText(
+        parser_, buffer, options,
+        fbjson::BufferChunkWriter(fixed.data(), fixed.size(), &size)));
+    EXPECT_EQ(expected, std::string(fixed.data(), size)) << name;
+    EXPECT_FALSE(fbjson::GenerateText(
+        parser_, buffer, options,
+        fbjson::BufferChunkWriter(fixed.data(), fixed.size() - 1, &size)));
+  });
+}
+
+// Compact text has no line breaks (strings escape theirs) and reads back as
+// the same buffer.
+TEST_F(TextGeneratorTest, CompactOutputReadsBack) {
+  fbjson::TextOptions compact;
+  compact.compact = true;
+  const fbjson::TextOptions pretty;
+  ForEachDatasetBuffer([&](const uint8_t *buffer, const char *name) {
+    std::string expected, text, reprinted;
+    ASSERT_TRUE(fbjson::GenerateText(parser_, buffer, pretty, &expected));
+    ASSERT_TRUE(fbjson::GenerateText(parser_, buffer, compact, &text));
+    EXPECT_LE(text.size(), expected.size()) << name;
+    EXPECT_EQ(std::string::npos, text.find('\n')) << name;
+    ASSERT_TRUE(parser_.Parse(text.c_str())) << parser_.error_ << text;
+    ASSERT_TRUE(fbjson::GenerateText(
+        parser_, parser_.builder_.GetBufferPointer(), pretty, &reprinted));
+    EXPECT_EQ(expected, reprinted) << name;
+  });
+}
+
+// Each element of a vector of unions is printed with its type from the
+// parallel `_type` vector.
+TEST_F(TextGeneratorTest, UnionVectors) {
+  flatbuffers::Parser parser(parser_.opts);
+  ASSERT_TRUE(parser.Parse(R"(
+    table A { a: int; }
+    table B { b: string; }
+    union U { A, B }
+    table Holder { items: [U]; one: U; }
+    root_type Holder;
+  )")) << parser.error_;
+  ASSERT_TRUE(parser.Parse(R"({
+    "items_type": ["A", "B", "A"],
+    "items": [{"a": 1}, {"b": "x"}, {"a": 2}],
+    "one_type": "B",
+    "one": {"b": "y"}
+  })")) << parser.error_;
+  const std::string expected(
+      reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+      parser.builder_.GetSize());
+  std::string text;
+  ASSERT_TRUE(fbjson::GenerateText(parser, parser.builder_.GetBufferPointer(),
+                                   fbjson::TextOptions(), &text));
+  EXPECT_NE(text.find(R"("b": "x")"), std::string::npos) << text;
+  ASSERT_TRUE(parser.Parse(text.c_str())) << parser.error_ << text;
+  EXPECT_EQ(expected,
+            std::string(reinterpret_cast<const char *>(
+                            parser.builder_.GetBufferPointer()),
+                        parser.builder_.GetSize()));
+}
+
+TEST_F(TextGeneratorTest, WritesToFileDescriptor) {
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tFloat;")) << parser_.error_;
+  ASSERT_TRUE(parser_.Parse(R"({"f1": 0.5})")) << parser_.error_;
+  const auto file = std::tmpfile();
+  ASSERT_NE(nullptr, file);
+  fbjson::TextOptions options;
+  options.compact = true;
+  const auto buffer = parser_.builder_.GetBufferPointer();
+  ASSERT_TRUE(fbjson::GenerateText(parser_, buffer, options,
+                                   fbjson::FdChunkWriter(fileno(file))));
+  std::rewind(file);
+  char text[64] = {};
+  EXPECT_EQ(10u, std::fread(text, 1, sizeof(text), file));
+  EXPECT_STREQ(R"({"f1":0.5})", text);
+  std::fclose(file);
+  EXPECT_FALSE(fbjson::GenerateText(parser_, buffer, options,
+                                    fbjson::FdChunkWriter(-1)));
+}
+
+// Sampled sweep of float32 bit patterns through `fbt.tFloat`: the shortest
+// text reads back as the same bits, and printing is stable.
+TEST_F(TextGeneratorTest, ShortestFloatsRoundTrip) {
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tFloat;")) << parser_.error_;
+  std::vector<uint32_t> patterns = {
+    0x00000001u,  // smallest subnormal
+    0x007fffffu,  // largest subnormal
+    0x00800000u,  // smallest normal
+    0x7f7fffffu,  // largest finite
+    0x3f800001u,  // 1 + ulp
+    0x3dcccccdu,  // 0.1f
+    0x15ae43fdu,  // shortest text 7.038531e-26 is off by one through double
+  };
+  for (uint64_t bits = 0; bits < (uint64_t(1) << 32); bits += 40503) {
+    patterns.push_back(static_cast<uint32_t>(bits));
+  }
+  fbjson::TextOptions options;
+  std::string text;
+  for (const auto bits : patterns) {
+    for (const auto sign : { 0u, 0x80000000u }) {
+      float value;
+      const auto signed_bits = bits | sign;
+      std::memcpy(&value, &signed_bits, sizeof(value));
+      // zero is the default and isn't stored, inf and nan aren't JSON
+      if (!std::isfinite(value) || value == 0) continue;
+      parser_.builder_.Clear();
+      parser_.builder_.Finish(fbt::CreatetFloat(parser_.builder_, value));
+      PrintDecodePrint(options, &text);
+      if (HasFatalFailure()) return;
+      const auto parsed = ParsedFloat();
+      ASSERT_EQ(0, std::memcmp(&value, &parsed, sizeof(value)))
+          << std::hex << signed_bits << ": " << text;
+    }
+  }
+}
@@ -0,0 +1,171 @@
+#include <string>
+#include <vector>
+#include "fbjson/verified_buffer.h"
+#include "flatbuffers/reflection.h"
+#include "flatbuffers/util.h"
+#include "gtest/gtest.h"
+#include "test_generated.h"
+
+#include "json_test_base.h"
+
+class VerifiedBufferTest : public TestFixtureBase {
+ protected:
+  // `test.bfbs` from flatc, independent of `Parser::Serialize`
+  std::string bfbs_;
+
+  void SetUp() override {
+    TestFixtureBase::SetUp();
+    const auto fname =
+        flatbuffers::ConCatPathFileName(FLATBUFFERS_FBS_DIR, "test.bfbs");
+    ASSERT_TRUE(flatbuffers::LoadFile(fname.c_str(), true, &bfbs_));
+  }
+
+  bool VerifyWithBinarySchema(const fbjson::VerifiedBuffer &buffer) {
+    const auto schema = reflection::GetSchema(bfbs_.data());
+    const auto root = buffer.root_type();
+    const auto object = schema->objects()->LookupByKey(
+        root->defined_namespace->GetFullyQualifiedName(root->name).c_str());
+    return object && flatbuffers::Verify(*schema, *object, buffer.data(),
+                                         buffer.size());
+  }
+
+  // Every buffer the parser accepts passes the verifier.
+  void CrossCheckDataset(const std::vector<TestParam> &dataset,
+                         const ParserTraits &traits) {
+    parser_.opts = traits.opts;
+    for (const auto &param : dataset) {
+      const auto json = std::get<2>(param);
+      if (!json) continue;
+      std::string text = json;
+      if (*json == '/') {
+        const auto fname =
+            flatbuffers::ConCatPathFileName(JSON_SAMPLES_DIR, json);
+        ASSERT_TRUE(flatbuffers::LoadFile(fname.c_str(), false, &text));
+      }
+      ASSERT_TRUE(parser_.Parse(std::get<1>(param))) << parser_.error_;
+      fbjson::VerifiedBuffer buffer;
+      const auto done = fbjson::ParseVerified(&parser_, text.c_str(), &buffer);
+      ASSERT_EQ(done, std::get<0>(param)) << json << ": " << parser_.error_;
+      EXPECT_EQ(done, !buffer.empty()) << json;
+      if (!done) continue;
+      EXPECT_TRUE(fbjson::CrossCheckVerified(&parser_, buffer))
+          << json << ": " << parser_.error_;
+      // cases with a schema of their own aren't in `test.bfbs`
+      const std::string decl = std::get<1>(param);
+      const std::string prefix = "root_type fbt.";
+      if (!decl.compare(0, prefix.size(), prefix)) {
+        EXPECT_TRUE(VerifyWithBinarySchema(buffer)) << json;
+      }
+    }
+  }
+};
+
+TEST_F(VerifiedBufferTest, JsonOrgStrict) {
+  CrossCheckDataset(json_org_dataset(true), ParserTraits());
+}
+
+TEST_F(VerifiedBufferTest, JsonOrgNonStrict) {
+  CrossCheckDataset(json_org_dataset(false), ParserTraitsNonStrict());
+}
+
+TEST_F(VerifiedBufferTest, SeriotStrict) {
+  CrossCheckDataset(seriot_dataset(true), ParserTraits());
+}
+
+TEST_F(VerifiedBufferTest, TypedRoot) {
+  // `BoolResearchTest` and `LeadingZerosResearchTest` without a verifier
+  fbjson::VerifiedBuffer buffer;
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tBool;")) << parser_.error_;
+  ASSERT_TRUE(fbjson::ParseVerified(&parser_, "[true]", &buffer))
+      << parser_.error_;
+  EXPECT_EQ(buffer.root_type(), parser_.LookupStruct("fbt.tBool"));
+  EXPECT_TRUE(buffer.GetRoot<fbt::tBool>()->f1());
+
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tIntInt;")) << parser_.error_;
+  ASSERT_TRUE(fbjson::ParseVerified(&parser_, "[0999, 001987]", &buffer))
+      << parser_.error_;
+  EXPECT_EQ(buffer.GetRoot<fbt::tIntInt>()->f1(), 999);
+  EXPECT_EQ(buffer.GetRoot<fbt::tIntInt>()->f2(), 1987);
+
+  const auto size = buffer.size();
+  const auto released = buffer.Release();
+  EXPECT_EQ(released.size(), size);
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST_F(VerifiedBufferTest, NoBufferWithoutDocument) {
+  fbjson::VerifiedBuffer buffer;
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tInt;")) << parser_.error_;
+  ASSERT_TRUE(fbjson::ParseVerified(&parser_, R"({"f1": 1})", &buffer));
+  // declarations only
+  EXPECT_FALSE(fbjson::ParseVerified(&parser_, "root_type fbt.tStr;", &buffer));
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_FALSE(parser_.error_.empty());
+  // syntax error
+  EXPECT_FALSE(fbjson::ParseVerified(&parser_, R"({"f1": })", &buffer));
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_FALSE(fbjson::CrossCheckVerified(&parser_, buffer));
+}
+
+TEST_F(VerifiedBufferTest, SizePrefixed) {
+  parser_.opts.size_prefixed = true;
+  ASSERT_TRUE(parser_.Parse("root_type fbt.tStrInt;")) << parser_.error_;
+  fbjson::VerifiedBuffer buffer;
+  ASSERT_TRUE(fbjson::ParseVerified(&parser_, R"({"f1": "abc", "f2": 7})",
+                                    &buffer))
+      << parser_.error_;
+  EXPECT_TRUE(buffer.size_prefixed());
+  EXPECT_EQ(flatbuffers::ReadScalar<flatbuffers::uoffset_t>(buffer.data()),
+            buffer.size() - sizeof(flatbuffers::uoffset_t));
+  EXPECT_STREQ(buffer.GetRoot<fbt::tStrInt>()->f1()->c_str(), "abc");
+  EXPECT_EQ(buffer.GetRoot<fbt::tStrInt>()->f2(), 7);
+  EXPECT_TRUE(fbjson::CrossCheckVerified(&parser_, buffer)) << parser_.error_;
+}
+
+TEST_F(VerifiedBufferTest, NestedFlatbufferArrays) {
+  flatbuffers::Parser parser(ParserTraits().opts);
+  ASSERT_TRUE(parser.Parse(R"(
+namespace nest;
+table Inner { name: string; }
+union Any { Outer }
+table Outer {
+  inner: [ubyte] (nested_flatbuffer: "nest.Inner");
+  outer: [ubyte] (nested_flatbuffer: "nest.Outer");
+  list: [Outer];
+  any: Any;
+}
+root_type Outer;
+)")) << parser.error_;
+  fbjson::VerifiedBuffer buffer;
+  // nested objects are built by the parser
+  ASSERT_TRUE(fbjson::ParseVerified(
+      &parser, R"({ "inner": { "name": "a" } })", &buffer))
+      << parser.error_;
+
+  // the bytes of a valid buffer pass as an array
+  flatbuffers::Parser inner(ParserTraits().opts);
+  ASSERT_TRUE(inner.Parse("table Inner { name: string; } root_type Inner;"));
+  ASSERT_TRUE(inner.Parse(R"({ "name": "a" })")) << inner.error_;
+  std::string bytes;
+  for (flatbuffers::uoffset_t i = 0; i < inner.builder_.GetSize(); i++) {
+    bytes += (i ? ", " : "") +
+             flatbuffers::NumToString(
+                 static_cast<int>(inner.builder_.GetBufferPointer()[i]));
+  }
+  const auto valid = R"({ "inner": [)" + bytes + "] }";
+  EXPECT_TRUE(fbjson::ParseVerified(&parser, valid.c_str(), &buffer))
+      << parser.error_;
+
+  // malformed arrays fail, at any depth
+  for (const auto json :
+       { R"({ "inner": [ 1, 2, 3 ] })",
+         R"({ "inner": [ 255, 255, 255, 127, 0, 0, 0, 0 ] })",
+         R"({ "list": [ { "inner": [ 8, 0, 0, 0 ] } ] })",
+         R"({ "any_type": "Outer", "any": { "inner": [ 4, 0, 0, 0 ] } })",
+         R"({ "outer": { "inner": [ 1 ] } })" }) {
+    EXPECT_FALSE(fbjson::ParseVerified(&parser, json, &buffer)) << json;
+    EXPECT_TRUE(buffer.empty()) << json;
+    EXPECT_NE(parser.error_.find("nested"), std::string::npos)
+        << json << ": " << parser.error_;
+  }
+}
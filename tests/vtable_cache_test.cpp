@@ -0,0 +1,70 @@
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "fbjson/vtable_cache.h"
+#include "gtest/gtest.h"
+
+using fbjson::VtableDedup;
+
+// Vector of tables with up to 256 different shapes: the fields present in
+// table `i` are the bits of `i`.
+static std::string BuildTables(VtableDedup mode, size_t count) {
+  fbjson::VtableCacheBuilder builder;
+  builder.SetVtableDedup(mode);
+  std::vector<flatbuffers::Offset<flatbuffers::Table>> tables;
+  for (size_t i = 0; i < count; i++) {
+    const auto start = builder.StartTable();
+    for (flatbuffers::voffset_t f = 0; f < 8; f++) {
+      if ((i >> f) & 1) {
+        builder.AddElement<int32_t>(flatbuffers::FieldIndexToOffset(f),
+                                    static_cast<int32_t>(i), 0);
+      }
+    }
+    tables.push_back(builder.EndTable(start));
+  }
+  const auto vector = builder.CreateVector(tables);
+  const auto start = builder.StartTable();
+  builder.AddOffset(flatbuffers::FieldIndexToOffset(0), vector);
+  builder.Finish(flatbuffers::Offset<flatbuffers::Table>(
+      builder.EndTable(start)));
+  return std::string(
+      reinterpret_cast<const char *>(builder.GetBufferPointer()),
+      builder.GetSize());
+}
+
+TEST(VtableCacheTest, SameBytesAsLinearSearch) {
+  for (size_t count : { 0, 1, 2, 255, 256, 1000 }) {
+    EXPECT_EQ(BuildTables(VtableDedup::kHash, count),
+              BuildTables(VtableDedup::kLinear, count))
+        << count;
+  }
+}
+
+TEST(VtableCacheTest, NoDedupIsLarger) {
+  EXPECT_GT(BuildTables(VtableDedup::kNone, 1000).size(),
+            BuildTables(VtableDedup::kHash, 1000).size());
+}
+
+TEST(VtableCacheTest, ClearResetsIndex) {
+  fbjson::VtableCacheBuilder builder;
+  builder.SetVtableDedup(VtableDedup::kHash);
+  std::string passes[2];
+  for (auto &bytes : passes) {
+    // a vtable left in the index would point into the cleared buffer
+    builder.Clear();
+    const auto start = builder.StartTable();
+    builder.AddElement<int32_t>(flatbuffers::FieldIndexToOffset(0), 1, 0);
+    builder.Finish(flatbuffers::Offset<flatbuffers::Table>(
+        builder.EndTable(start)));
+    bytes.assign(reinterpret_cast<const char *>(builder.GetBufferPointer()),
+                 builder.GetSize());
+  }
+  EXPECT_EQ(passes[0], passes[1]);
+  EXPECT_GT(builder.VtableIndexMemory(), 0u);
+}
+
+TEST(VtableCacheTest, NotAFlatBufferBuilder) {
+  // the base `EndTable` and `Clear` would bypass the hash index
+  EXPECT_FALSE((std::is_convertible<fbjson::VtableCacheBuilder *,
+                                    flatbuffers::FlatBufferBuilder *>::value));
+}
@@ -0,0 +1,149 @@
+// bench_compare: compare two result files of `flatbuffers_bench --json`.
+// Usage: bench_compare [--threshold=fraction] [--init] baseline.json
+//                      current.json
+// A sample regresses if its time per iteration grows by more than the
+// threshold (5% by default) widened by the noise of both runs, or if it
+// allocates more per iteration. Exits with 1 on regressions.
+// `--init` copies `current.json` to a missing baseline and passes.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench_results_generated.h"
+#include "bench_results_meta_generated.h"
+#include "fbjson/meta_parser.h"
+#include "flatbuffers/util.h"
+
+namespace {
+
+// Noise band in standard deviations of the difference.
+const double kSigmas = 3;
+
+struct Results {
+  std::string json;
+  fbjson::MetaParser parser{ bench::results::meta::kSchema };
+  const bench::results::Report *report = nullptr;
+
+  bool Load(const char *path) {
+    if (!flatbuffers::LoadFile(path, false, &json)) {
+      std::fprintf(stderr, "can't read %s\n", path);
+      return false;
+    }
+    if (!parser.Parse(json.c_str())) {
+      std::fprintf(stderr, "%s: %s\n", path, parser.error_.c_str());
+      return false;
+    }
+    flatbuffers::Verifier verifier(parser.builder_.GetBufferPointer(),
+                                   parser.builder_.GetSize());
+    if (!bench::results::VerifyReportBuffer(verifier)) {
+      std::fprintf(stderr, "%s: invalid results\n", path);
+      return false;
+    }
+    report = bench::results::GetReport(parser.builder_.GetBufferPointer());
+    return true;
+  }
+
+  std::map<std::string, const bench::results::Sample *> Samples() const {
+    std::map<std::string, const bench::results::Sample *> samples;
+    if (!report->samples()) return samples;
+    for (const auto s : *report->samples()) {
+      if (s->name()) samples[s->name()->str()] = s;
+    }
+    return samples;
+  }
+};
+
+std::string HostName(const bench::results::Report &report) {
+  const auto host = report.host();
+  if (!host) return "unknown host";
+  auto str = [](const flatbuffers::String *s) {
+    return s ? s->str() : std::string("?");
+  };
+  return str(host->cpu()) + ", " + std::to_string(host->cores()) +
+         " cores, " + str(host->compiler()) + " " + str(host->build_type()) +
+         ", flatbuffers " + str(host->flatbuffers_version());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  double threshold = 0.05;
+  auto init = false;
+  std::vector<const char *> files;
+  for (int i = 1; i < argc; i++) {
+    if (!std::strncmp(argv[i], "--threshold=", 12)) {
+      threshold = std::atof(argv[i] + 12);
+    } else if (!std::strcmp(argv[i], "--init")) {
+      init = true;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if (files.size() != 2) {
+    std::fprintf(stderr,
+                 "usage: %s [--threshold=fraction] [--init] baseline.json "
+                 "current.json\n",
+                 argv[0]);
+    return 2;
+  }
+  if (init && !flatbuffers::FileExists(files[0])) {
+    std::string current;
+    if (!flatbuffers::LoadFile(files[1], false, &current) ||
+        !flatbuffers::SaveFile(files[0], current, false)) {
+      std::fprintf(stderr, "can't create baseline %s\n", files[0]);
+      return 1;
+    }
+    std::printf("baseline %s created\n", files[0]);
+    return 0;
+  }
+  Results baseline, current;
+  if (!baseline.Load(files[0]) || !current.Load(files[1])) return 1;
+  std::printf("baseline: %s\ncurrent:  %s\n",
+              HostName(*baseline.report).c_str(),
+              HostName(*current.report).c_str());
+
+  const auto base_samples = baseline.Samples();
+  const auto current_samples = current.Samples();
+  size_t regressions = 0, improvements = 0, missing = 0;
+  for (const auto &it : base_samples) {
+    const auto found = current_samples.find(it.first);
+    if (found == current_samples.end()) {
+      std::printf("%-56s missing\n", it.first.c_str());
+      missing++;
+      continue;
+    }
+    const auto b = it.second;
+    const auto c = found->second;
+    if (b->ns_per_iteration() <= 0) continue;
+    const auto change = c->ns_per_iteration() / b->ns_per_iteration() - 1;
+    const auto noise = kSigmas * std::sqrt(b->rel_stddev() * b->rel_stddev() +
+                                           c->rel_stddev() * c->rel_stddev());
+    const auto limit = std::max(threshold, noise);
+    const auto more_allocations = c->allocations_per_iteration() >
+                                  b->allocations_per_iteration() * 1.01 + 0.5;
+    const char *verdict = "";
+    if (change > limit || more_allocations) {
+      verdict = "REGRESSION";
+      regressions++;
+    } else if (change < -limit) {
+      verdict = "improved";
+      improvements++;
+    }
+    std::printf("%-56s %12.1f -> %12.1f ns %+7.1f%% (limit %4.1f%%)",
+                it.first.c_str(), b->ns_per_iteration(),
+                c->ns_per_iteration(), change * 100, limit * 100);
+    if (more_allocations) {
+      std::printf(" allocs %.1f -> %.1f", b->allocations_per_iteration(),
+                  c->allocations_per_iteration());
+    }
+    std::printf(" %s\n", verdict);
+  }
+  std::printf("%zu samples, %zu regressions, %zu improvements, %zu missing\n",
+              base_samples.size(), regressions, improvements, missing);
+  return regressions ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+// fbs_meta: emit compile-time table metadata (`fbjson/meta.h`) for a schema.
+// Usage: fbs_meta -o output_dir [-I include_dir]... schema.fbs
+// Writes `<schema>_meta_generated.h` with one constexpr field table for every
+// table of the schema.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "fbjson/frozen_schema.h"
+#include "fbjson/meta.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+
+namespace {
+
+using fbjson::meta::Kind;
+
+const char *KindName(Kind kind) {
+  switch (kind) {
+    case Kind::kNone: return "kNone";
+    case Kind::kBool: return "kBool";
+    case Kind::kByte: return "kByte";
+    case Kind::kUByte: return "kUByte";
+    case Kind::kShort: return "kShort";
+    case Kind::kUShort: return "kUShort";
+    case Kind::kInt: return "kInt";
+    case Kind::kUInt: return "kUInt";
+    case Kind::kLong: return "kLong";
+    case Kind::kULong: return "kULong";
+    case Kind::kFloat: return "kFloat";
+    case Kind::kDouble: return "kDouble";
+    case Kind::kString: return "kString";
+    case Kind::kTable: return "kTable";
+    case Kind::kVector: return "kVector";
+    default: return "kUnsupported";
+  }
+}
+
+// Default values are kept as written in the schema (hex, leading zeros),
+// normalize them to C++ literals. `ulong` defaults above INT64_MAX keep
+// their bit pattern in the `int64_t` field, `MetaParser` casts them back.
+std::string IntegerConstant(const std::string &constant) {
+  const auto base =
+      constant.find_first_of("xX") != std::string::npos ? 16 : 10;
+  const int64_t v = constant[0] == '-'
+                        ? std::strtoll(constant.c_str(), nullptr, base)
+                        : static_cast<int64_t>(
+                              std::strtoull(constant.c_str(), nullptr, base));
+  return v == INT64_MIN ? "INT64_MIN" : flatbuffers::NumToString(v);
+}
+
+std::string RealConstant(const std::string &constant) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.17g",
+                std::strtod(constant.c_str(), nullptr));
+  return buf;
+}
+
+std::string Identifier(const std::string &full_name) {
+  std::string id = full_name;
+  std::replace(id.begin(), id.end(), '.', '_');
+  return id;
+}
+
+const std::vector<std::string> &Components(const flatbuffers::StructDef *sd) {
+  static const std::vector<std::string> kNone;
+  return sd->defined_namespace ? sd->defined_namespace->components : kNone;
+}
+
+std::string FullName(const flatbuffers::StructDef *sd) {
+  return sd->defined_namespace
+             ? sd->defined_namespace->GetFullyQualifiedName(sd->name)
+             : sd->name;
+}
+
+bool Generate(const flatbuffers::Parser &parser, const std::string &stem,
+              std::string *code, std::string *error) {
+  std::vector<const flatbuffers::StructDef *> tables;
+  for (auto sd : parser.structs_.vec) {
+    if (!sd->fixed) tables.push_back(sd);
+  }
+  if (tables.empty()) {
+    *error = "no tables";
+    return false;
+  }
+  auto table_index = [&](const flatbuffers::StructDef *sd) {
+    const auto it = std::find(tables.begin(), tables.end(), sd);
+    return it == tables.end() ? -1 : static_cast<int>(it - tables.begin());
+  };
+  // The namespace all tables share becomes the C++ namespace, identifiers
+  // keep the rest of the qualified name, so tables of the same name in
+  // different namespaces stay apart.
+  auto common = Components(tables[0]);
+  for (auto sd : tables) {
+    const auto &components = Components(sd);
+    size_t n = 0;
+    while (n < common.size() && n < components.size() &&
+           common[n] == components[n]) {
+      n++;
+    }
+    common.resize(n);
+  }
+  std::vector<std::string> ids;
+  for (auto sd : tables) {
+    const auto &components = Components(sd);
+    std::string id;
+    for (size_t i = common.size(); i < components.size(); i++) {
+      id += components[i] + "_";
+    }
+    id += sd->name;
+    if (std::find(ids.begin(), ids.end(), id) != ids.end()) {
+      *error = "tables map to the same identifier " + id;
+      return false;
+    }
+    ids.push_back(id);
+  }
+  std::string ns;
+  for (const auto &component : common) ns += component + "::";
+  ns += "meta";
+  const auto guard = "FBJSON_META_" + Identifier(stem) + "_GENERATED_H_";
+
+  auto &c = *code;
+  c += "// automatically generated by fbs_meta, do not modify\n\n";
+  c += "#ifndef " + guard + "\n#define " + guard + "\n\n";
+  c += "#include \"fbjson/meta.h\"\n\n";
+  c += "namespace " + ns + " {\n\n";
+  c += "using fbjson::meta::Kind;\n\n";
+  c += "enum class TableIndex : int {\n";
+  for (size_t i = 0; i < tables.size(); i++) {
+    c += "  " + ids[i] + " = " + flatbuffers::NumToString(i) + ",\n";
+  }
+  c += "};\n\n";
+  for (size_t t = 0; t < tables.size(); t++) {
+    const auto sd = tables[t];
+    const auto &fields = sd->fields.vec;
+    if (fields.empty()) continue;
+    const auto &id = ids[t];
+    c += "constexpr fbjson::meta::Field k" + id + "Fields[] = {\n";
+    std::vector<std::pair<uint32_t, size_t>> hashes;
+    for (size_t i = 0; i < fields.size(); i++) {
+      const auto &f = *fields[i];
+      const auto &type = f.value.type;
+      const auto kind = fbjson::ToMetaKind(type, type.base_type);
+      const auto element = type.base_type == flatbuffers::BASE_TYPE_VECTOR
+                               ? fbjson::ToMetaKind(type, type.element)
+                               : Kind::kNone;
+      const auto hash = fbjson::meta::HashName(f.name.c_str(), f.name.size());
+      hashes.emplace_back(hash, i);
+      const auto is_float = flatbuffers::IsFloat(type.base_type);
+      const auto is_int = flatbuffers::IsScalar(type.base_type) && !is_float;
+      c += "  { " + flatbuffers::NumToString(hash) + "u, \"" + f.name +
+           "\", " + flatbuffers::NumToString(f.value.offset) + ", Kind::" +
+           KindName(kind) + ", Kind::" + KindName(element) + ", " +
+           flatbuffers::NumToString(table_index(type.struct_def)) + ", " +
+           (is_int ? IntegerConstant(f.value.constant) : "0") + ", " +
+           (is_float ? RealConstant(f.value.constant) : "0") + ", " +
+           (f.required ? "true" : "false") + ", " +
+           (f.deprecated ? "true" : "false") + ", " +
+           (f.flexbuffer ? "true" : "false") + " },\n";
+    }
+    c += "};\n";
+    std::stable_sort(hashes.begin(), hashes.end());
+    c += "constexpr uint16_t k" + id + "ByHash[] = {";
+    for (size_t i = 0; i < hashes.size(); i++) {
+      c += (i ? ", " : " ") + flatbuffers::NumToString(hashes[i].second);
+    }
+    c += " };\n\n";
+  }
+  c += "constexpr fbjson::meta::Table kTables[] = {\n";
+  for (size_t t = 0; t < tables.size(); t++) {
+    const auto sd = tables[t];
+    const auto &id = ids[t];
+    const auto empty = sd->fields.vec.empty();
+    c += "  { \"" + FullName(sd) + "\", " +
+         (empty ? "nullptr" : "k" + id + "Fields") + ", " +
+         flatbuffers::NumToString(sd->fields.vec.size()) + ", " +
+         (empty ? "nullptr" : "k" + id + "ByHash") + " },\n";
+  }
+  c += "};\n\n";
+  c += "constexpr fbjson::meta::Schema kSchema = { kTables, " +
+       flatbuffers::NumToString(tables.size()) + ", " +
+       flatbuffers::NumToString(table_index(parser.root_struct_def_)) +
+       " };\n\n";
+  c += "}  // namespace " + ns + "\n\n";
+  c += "#endif  // " + guard + "\n";
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string output_dir = ".";
+  std::string schema_file;
+  std::vector<std::string> include_dirs;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "-o" && i + 1 < argc) {
+      output_dir = argv[++i];
+    } else if (arg == "-I" && i + 1 < argc) {
+      include_dirs.push_back(argv[++i]);
+    } else if (schema_file.empty() && !arg.empty() && arg[0] != '-') {
+      schema_file = arg;
+    } else {
+      schema_file.clear();
+      break;
+    }
+  }
+  if (schema_file.empty()) {
+    std::fprintf(stderr,
+                 "usage: %s -o output_dir [-I include_dir]... schema.fbs\n",
+                 argv[0]);
+    return 2;
+  }
+  std::string schema;
+  if (!flatbuffers::LoadFile(schema_file.c_str(), false, &schema)) {
+    std::fprintf(stderr, "error: can't load %s\n", schema_file.c_str());
+    return 1;
+  }
+  std::vector<const char *> include_paths;
+  // includes are resolved relative to the schema as flatc does
+  const auto schema_dir = flatbuffers::StripFileName(schema_file);
+  include_paths.push_back(schema_dir.c_str());
+  for (const auto &dir : include_dirs) include_paths.push_back(dir.c_str());
+  include_paths.push_back(nullptr);
+  flatbuffers::Parser parser;
+  if (!parser.Parse(schema.c_str(), include_paths.data(),
+                    schema_file.c_str())) {
+    std::fprintf(stderr, "%s\n", parser.error_.c_str());
+    return 1;
+  }
+  const auto stem =
+      flatbuffers::StripExtension(flatbuffers::StripPath(schema_file));
+  std::string code, error;
+  if (!Generate(parser, stem, &code, &error)) {
+    std::fprintf(stderr, "error: %s: %s\n", schema_file.c_str(),
+                 error.c_str());
+    return 1;
+  }
+  const auto out = flatbuffers::ConCatPathFileName(
+      output_dir, stem + "_meta_generated.h");
+  if (!flatbuffers::SaveFile(out.c_str(), code, false)) {
+    std::fprintf(stderr, "error: can't write %s\n", out.c_str());
+    return 1;
+  }
+  return 0;
+}
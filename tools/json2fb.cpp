@@ -0,0 +1,180 @@
+// json2fb: batch conversion of JSON files to FlatBuffers.
+// Files go through the stages of `fbjson::ConversionPipeline` (read, parse,
+// verify, write), each with its own threads. Prints throughput, utilization
+// and back-pressure of each stage.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fbjson/options.h"
+#include "fbjson/pipeline.h"
+#include "fbjson/schema_registry.h"
+#include "flatbuffers/util.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Args {
+  std::string schema;
+  std::string root_type;
+  std::vector<std::string> include_dirs;
+  std::vector<std::string> inputs;
+  fbjson::PipelineOptions pipeline;
+};
+
+void Usage(const char *name) {
+  std::fprintf(stderr,
+               "usage: %s -s schema.fbs -r root_type [-I include_dir]...\n"
+               "       [-o output_dir] [-j parse_threads] [--no-verify]\n"
+               "       [--read-threads N] [--verify-threads N] "
+               "[--write-threads N] [--queue N]\n"
+               "       (directory | glob)...\n"
+               "Convert JSON files to FlatBuffers. A glob may contain '*' and "
+               "'?' in the file name.\n",
+               name);
+}
+
+bool ParseArgs(int argc, char **argv, Args *args) {
+  auto &pipeline = args->pipeline;
+  pipeline.parse_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    auto value = [&]() -> const char * {
+      return (i + 1 < argc) ? argv[++i] : nullptr;
+    };
+    const char *v = nullptr;
+    if (arg == "-s" && (v = value())) {
+      args->schema = v;
+    } else if (arg == "-r" && (v = value())) {
+      args->root_type = v;
+    } else if (arg == "-I" && (v = value())) {
+      args->include_dirs.push_back(v);
+    } else if (arg == "-o" && (v = value())) {
+      pipeline.output_dir = v;
+    } else if (arg == "-j" && (v = value())) {
+      pipeline.parse_threads = std::max(1, std::atoi(v));
+    } else if (arg == "--read-threads" && (v = value())) {
+      pipeline.read_threads = std::max(1, std::atoi(v));
+    } else if (arg == "--verify-threads" && (v = value())) {
+      pipeline.verify_threads = std::max(1, std::atoi(v));
+    } else if (arg == "--write-threads" && (v = value())) {
+      pipeline.write_threads = std::max(1, std::atoi(v));
+    } else if (arg == "--queue" && (v = value())) {
+      pipeline.queue_capacity = std::max(1, std::atoi(v));
+    } else if (arg == "--no-verify") {
+      pipeline.verify = false;
+    } else if (!arg.empty() && arg[0] != '-') {
+      args->inputs.push_back(arg);
+    } else {
+      return false;
+    }
+  }
+  return !args->schema.empty() && !args->root_type.empty() &&
+         !args->inputs.empty();
+}
+
+bool WildcardMatch(const char *pattern, const char *name) {
+  for (; *pattern; pattern++, name++) {
+    if (*pattern == '*') {
+      for (; *name; name++) {
+        if (WildcardMatch(pattern + 1, name)) return true;
+      }
+      return WildcardMatch(pattern + 1, name);
+    }
+    if (!*name || (*pattern != '?' && *pattern != *name)) return false;
+  }
+  return !*name;
+}
+
+// Expand directories (all `*.json` files) and globs.
+bool CollectFiles(const std::vector<std::string> &inputs,
+                  std::vector<std::string> *files) {
+  for (const auto &input : inputs) {
+    std::error_code ec;
+    if (fs::is_directory(input, ec)) {
+      for (const auto &entry : fs::directory_iterator(input, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+          files->push_back(entry.path().string());
+        }
+      }
+    } else if (input.find_first_of("*?") != std::string::npos) {
+      const fs::path path(input);
+      const auto dir = path.has_parent_path() ? path.parent_path() : ".";
+      const auto pattern = path.filename().string();
+      for (const auto &entry : fs::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file() &&
+            WildcardMatch(pattern.c_str(),
+                          entry.path().filename().string().c_str())) {
+          files->push_back(entry.path().string());
+        }
+      }
+    } else {
+      files->push_back(input);
+    }
+    if (ec) {
+      std::fprintf(stderr, "error: %s: %s\n", input.c_str(),
+                   ec.message().c_str());
+      return false;
+    }
+  }
+  std::sort(files->begin(), files->end());
+  files->erase(std::unique(files->begin(), files->end()), files->end());
+  return true;
+}
+
+// Outputs are named after the input stem, so two inputs with the same stem
+// would overwrite each other in the output directory.
+bool CheckOutputNames(const std::vector<std::string> &files) {
+  std::map<std::string, const std::string *> stems;
+  bool ok = true;
+  for (const auto &file : files) {
+    const auto stem = flatbuffers::StripExtension(flatbuffers::StripPath(file));
+    const auto it = stems.emplace(stem, &file);
+    if (!it.second) {
+      std::fprintf(stderr, "error: %s and %s both write %s\n",
+                   it.first->second->c_str(), file.c_str(), stem.c_str());
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Args args;
+  if (!ParseArgs(argc, argv, &args)) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  fbjson::Schema schema;
+  schema.path = args.schema;
+  schema.root_type = args.root_type;
+  schema.include_dirs = args.include_dirs;
+  schema.opts = fbjson::StrictJsonOptions();
+  if (!flatbuffers::LoadFile(schema.path.c_str(), false, &schema.text)) {
+    std::fprintf(stderr, "error: can't load schema %s\n", schema.path.c_str());
+    return 1;
+  }
+
+  std::vector<std::string> files;
+  if (!CollectFiles(args.inputs, &files)) return 1;
+  if (!args.pipeline.output_dir.empty() && !CheckOutputNames(files)) return 1;
+
+  fbjson::ConversionPipeline pipeline(schema, args.pipeline);
+  fbjson::PipelineStats stats;
+  const auto ok = pipeline.Run(files, &stats);
+  for (const auto &error : pipeline.errors()) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+  }
+  std::printf("%s", stats.ToString().c_str());
+  return ok ? 0 : 1;
+}